@@ -5,7 +5,7 @@ from typing import Optional
 from fastapi import APIRouter, Cookie, Depends, Header, Request
 from fastapi.responses import JSONResponse
 
-from api.shared import ensure_web_or_device_access, logger
+from api.shared import ensure_web_or_device_access, logger, notify_device_event
 from core.auth import is_admin_authorized, require_admin, validate_mac_param
 from core.config_store import (
     activate_config,
@@ -50,6 +50,7 @@ async def post_config(
     )
     config_id = await save_config(mac, data)
     await set_pending_refresh(mac, True)
+    notify_device_event(mac)
 
     saved_config = await get_active_config(mac)
     if saved_config:
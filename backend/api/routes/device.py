@@ -14,11 +14,13 @@ from PIL import Image, ImageDraw, ImageFont, UnidentifiedImageError
 from api.shared import (
     DISCOVERY_WINDOW_MINUTES,
     ONLINE_WINDOW_MINUTES,
+    _device_event_waiters,
     _preview_push_queue,
     _preview_push_queue_lock,
     build_claim_url,
     ensure_web_or_device_access,
     logger,
+    notify_device_event,
     resolve_refresh_minutes_for_device_state,
 )
 from core.auth import require_admin, require_device_token, require_user, validate_mac_param
@@ -52,6 +54,10 @@ from core.stats_store import (
 router = APIRouter(tags=["device"])
 
 _ALERT_TTL_SECONDS = 60
+_EVENT_HOLD_MAX_SECONDS = 30
+# Waiters are per worker; re-read the state this often so actions queued
+# through another worker are still picked up during a hold.
+_EVENT_RECHECK_SECONDS = 5.0
 _device_alerts: dict[str, dict] = {}
 _device_alerts_lock = asyncio.Lock()
 
@@ -65,6 +71,7 @@ async def trigger_refresh(
 ):
     await ensure_web_or_device_access(request, mac, x_device_token, ink_session)
     await set_pending_refresh(mac, True)
+    notify_device_event(mac)
     logger.info("[DEVICE] Pending refresh set for %s", mac)
     return {"ok": True, "message": "Refresh queued for next wake-up"}
 
@@ -73,12 +80,20 @@ async def trigger_refresh(
 async def device_state(
     mac: str,
     request: Request,
+    response: Response,
+    v: Optional[float] = Query(default=None, ge=0.0, le=10.0, description="Battery voltage; folds a heartbeat into the poll"),
+    rssi: Optional[int] = Query(default=None, ge=-150, le=0, description="WiFi RSSI for the folded heartbeat"),
     x_device_token: Optional[str] = Header(default=None),
     ink_session: Optional[str] = Cookie(default=None),
 ):
     access = await ensure_web_or_device_access(request, mac, x_device_token, ink_session)
     if access["mode"] == "device":
         await update_device_state(mac, last_state_poll_at=datetime.now().isoformat())
+        if v is not None:
+            from core.stats_store import log_heartbeat
+
+            await log_heartbeat(mac, v, rssi)
+            response.headers["X-Heartbeat"] = "1"
     state = await get_device_state(mac)
     if not state:
         return JSONResponse({"error": "no device state found"}, status_code=404)
@@ -117,6 +132,58 @@ async def device_state(
     return state
 
 
+async def _pending_device_event(mac: str, cfg: Optional[dict]) -> Optional[str]:
+    state = await get_device_state(mac) or {}
+    if state.get("pending_refresh") or state.get("pending_mode"):
+        return "refresh"
+    always_active = bool(cfg.get("is_always_active")) if cfg else False
+    if not always_active and str(state.get("runtime_mode") or "").lower() == "interval":
+        return "interval"
+    if cfg and cfg.get("is_focus_listening") and await _take_alert(mac, consume=False):
+        return "alert"
+    return None
+
+
+@router.get("/device/{mac}/events")
+async def device_events(
+    mac: str,
+    hold: int = Query(default=25, ge=0, le=_EVENT_HOLD_MAX_SECONDS, description="Seconds to hold the request open"),
+    x_device_token: Optional[str] = Header(default=None),
+):
+    """Live-mode long-poll: answers as soon as an action is queued for the device.
+
+    Replaces the 5 s /state poll. The response is {"event": ...} with one of
+    refresh (pending refresh or mode switch), interval (leave live mode),
+    alert (focus alert waiting) or none when the hold expires.
+    """
+    mac = validate_mac_param(mac)
+    await require_device_token(mac, x_device_token)
+    cfg = await get_active_config(mac, log_load=False)
+
+    loop = asyncio.get_running_loop()
+    deadline = loop.time() + hold
+    waiter = asyncio.Event()
+    waiters = _device_event_waiters.setdefault(mac, set())
+    waiters.add(waiter)
+    try:
+        while True:
+            await update_device_state(mac, last_state_poll_at=datetime.now().isoformat())
+            event = await _pending_device_event(mac, cfg)
+            remaining = deadline - loop.time()
+            if event or remaining <= 0:
+                break
+            waiter.clear()
+            try:
+                await asyncio.wait_for(waiter.wait(), timeout=min(remaining, _EVENT_RECHECK_SECONDS))
+            except asyncio.TimeoutError:
+                pass
+    finally:
+        waiters.discard(waiter)
+        if not waiters:
+            _device_event_waiters.pop(mac, None)
+    return {"event": event or "none"}
+
+
 @router.post("/device/{mac}/runtime")
 async def set_runtime_mode(
     mac: str,
@@ -129,6 +196,7 @@ async def set_runtime_mode(
     if mode not in ("active", "interval"):
         return JSONResponse({"error": "mode must be active or interval"}, status_code=400)
     await update_device_state(mac, runtime_mode=mode)
+    notify_device_event(mac)
     return {"ok": True, "runtime_mode": mode}
 
 
@@ -142,7 +210,10 @@ async def post_device_heartbeat(
 
     mac = validate_mac_param(mac)
     await require_device_token(mac, x_device_token)
-    await log_heartbeat(mac, body.battery_voltage or 3.3, body.wifi_rssi)
+    await log_heartbeat(mac, body.battery_voltage or 3.3, body.wifi_rssi, body.wake_profile)
+    if body.power_tier is not None:
+        runtime_hours = body.runtime_hours if body.runtime_hours is not None else -1
+        await update_device_state(mac, power_tier=body.power_tier, power_runtime_hours=runtime_hours)
     return OkResponse(ok=True)
 
 
@@ -193,11 +264,32 @@ async def push_device_alert(
             "level": level or "info",
             "expires_at": now + timedelta(seconds=_ALERT_TTL_SECONDS),
         }
+    notify_device_event(mac)
 
     logger.info("[ALERT] Stored alert for %s (level=%s, ttl=%ss)", mac, level or "info", _ALERT_TTL_SECONDS)
     return {"ok": True}
 
 
+async def _take_alert(mac: str, *, consume: bool = True) -> Optional[dict]:
+    """Return the unexpired alert queued for the device; consume=False only peeks."""
+    now = datetime.now()
+    async with _device_alerts_lock:
+        existing = _device_alerts.get(mac)
+        if not existing:
+            return None
+        expires_at = existing.get("expires_at")
+        if isinstance(expires_at, datetime) and expires_at < now:
+            _device_alerts.pop(mac, None)
+            return None
+        if consume:
+            _device_alerts.pop(mac, None)
+        return {
+            "sender": existing.get("sender") or "",
+            "message": existing.get("message") or "",
+            "level": existing.get("level") or "info",
+        }
+
+
 @router.get("/device/{mac}/check_alert")
 async def check_device_alert(
     mac: str,
@@ -206,21 +298,7 @@ async def check_device_alert(
     mac = validate_mac_param(mac)
     await require_device_token(mac, x_device_token)
 
-    now = datetime.now()
-    alert_payload: Optional[dict] = None
-    async with _device_alerts_lock:
-        existing = _device_alerts.get(mac)
-        if existing:
-            expires_at = existing.get("expires_at")
-            if isinstance(expires_at, datetime) and expires_at < now:
-                _device_alerts.pop(mac, None)
-            else:
-                alert_payload = {
-                    "sender": existing.get("sender") or "",
-                    "message": existing.get("message") or "",
-                    "level": existing.get("level") or "info",
-                }
-                _device_alerts.pop(mac, None)
+    alert_payload = await _take_alert(mac)
     if not alert_payload:
         return {"has_alert": False}
     return {"has_alert": True, "alert": alert_payload}
@@ -253,6 +331,19 @@ def _wrap_text_by_pixels(draw: ImageDraw.ImageDraw, text: str, font: ImageFont.I
     return lines
 
 
+@router.head("/device/{mac}/alert-bmp")
+async def alert_bmp_available(
+    mac: str,
+    x_device_token: Optional[str] = Header(default=None, alias="X-Device-Token"),
+):
+    """Cheap focus-mode check: 200 when an alert is waiting, 204 otherwise. Does not consume it."""
+    mac = validate_mac_param(mac)
+    await require_device_token(mac, x_device_token)
+    if await _take_alert(mac, consume=False):
+        return Response(status_code=200)
+    return Response(status_code=204)
+
+
 @router.get("/device/{mac}/alert-bmp")
 async def alert_bmp(
     mac: str,
@@ -263,21 +354,7 @@ async def alert_bmp(
     mac = validate_mac_param(mac)
     await require_device_token(mac, x_device_token)
 
-    now = datetime.now()
-    alert_payload: Optional[dict] = None
-    async with _device_alerts_lock:
-        existing = _device_alerts.get(mac)
-        if existing:
-            expires_at = existing.get("expires_at")
-            if isinstance(expires_at, datetime) and expires_at < now:
-                _device_alerts.pop(mac, None)
-            else:
-                alert_payload = {
-                    "sender": existing.get("sender") or "",
-                    "message": existing.get("message") or "",
-                    "level": existing.get("level") or "info",
-                }
-                _device_alerts.pop(mac, None)
+    alert_payload = await _take_alert(mac)
 
     if not alert_payload:
         return Response(status_code=204)
@@ -357,6 +434,7 @@ async def apply_preview_to_device(
         _preview_push_queue[mac] = {"image": normalized_bytes, "mode": mode_hint}
         logger.info("[APPLY-PREVIEW] Queue now: mac=%s, mode=%s, image_size=%d bytes", mac, mode_hint, len(normalized_bytes))
     await set_pending_refresh(mac, True)
+    notify_device_event(mac)
     from core.config_store import get_device_state as _get_ds
     st = await _get_ds(mac)
     logger.info("[APPLY-PREVIEW] Device state after push: mac=%s, pending_refresh=%s, pending_mode=%s", mac, st.get("pending_refresh") if st else "N/A", st.get("pending_mode") if st else "N/A")
@@ -380,6 +458,7 @@ async def switch_mode(
     if not mode or not registry.is_supported(mode, mac):
         return JSONResponse({"error": f"unsupported mode: {mode}"}, status_code=400)
     await update_device_state(mac, pending_mode=mode, pending_refresh=1)
+    notify_device_event(mac)
     logger.info("[DEVICE] Pending mode switch to %s for %s", mode, mac)
     return {"ok": True, "message": f"Mode switch to {mode} queued"}
 
@@ -1,10 +1,11 @@
 import base64
 import io
 import json
+import struct
 import time
 from datetime import datetime
 from json import JSONDecodeError
-from typing import Annotated, Optional
+from typing import Annotated, Literal, Optional
 
 from fastapi import APIRouter, Cookie, Depends, Header, Query, Request, Response
 from fastapi.responses import StreamingResponse
@@ -15,12 +16,15 @@ from api.shared import (
     _preview_push_queue_lock,
     _render_device_unbound_image,
     build_image,
+    choose_persona_from_config,
     content_cache,
+    delivered_frame,
     ensure_web_or_device_access,
     limiter,
     log_render_stats,
     logger,
     reconnect_threshold_seconds,
+    remember_delivered_frame,
     resolve_preview_voltage,
     resolve_refresh_minutes_for_device_state,
 )
@@ -32,13 +36,24 @@ from core.config_store import (
     get_device_owner,
     get_device_state,
     get_or_create_claim_token,
+    set_cycle_schedule,
     update_device_state,
 )
 from core.context import extract_location_settings, get_date_context, get_weather
 from core.pipeline import generate_and_render
-from core.renderer import image_to_bmp_bytes, image_to_png_bytes, image_to_raw_2bpp, render_error
+from core.renderer import (
+    encode_frame_patch,
+    frame_patch_rects,
+    image_to_bmp_bytes,
+    image_to_png_bytes,
+    image_to_raw_1bpp,
+    image_to_raw_2bpp,
+    frame_hash,
+    packbits_encode,
+    render_error,
+)
 from core.schemas import RenderQuery
-from core.stats_store import get_latest_heartbeat
+from core.stats_store import get_latest_heartbeat, log_heartbeat
 
 router = APIRouter(tags=["render"])
 
@@ -60,12 +75,125 @@ def _configured_refresh_minutes(config: Optional[dict]) -> int:
     return refresh_minutes
 
 
+def _encode_device_frame(
+    img: Image.Image, *, two_bpp: bool, fmt: Optional[str]
+) -> tuple[bytes, str, dict[str, str], bytes]:
+    """Encode a frame for the device in the format it negotiated.
+
+    Default: 1-bit BMP, or raw 2bpp for color panels. With fmt=packbits the raw
+    top-down frame buffer is PackBits-compressed and tagged with
+    X-Frame-Encoding / X-Frame-Bpp; devices that do not send fmt keep BMP.
+    The returned headers carry the ETag: the frame hash of the raw buffer, the
+    same value the firmware computes over imgBuf/colorBuf. The raw buffer is
+    returned last.
+    """
+    raw, etag = _device_frame_raw(img, two_bpp=two_bpp)
+    return _encode_device_raw(img, raw, etag, two_bpp=two_bpp, fmt=fmt)
+
+
+def _device_frame_raw(img: Image.Image, *, two_bpp: bool) -> tuple[bytes, str]:
+    """Raw device frame buffer and its ETag, without encoding the body."""
+    if two_bpp:
+        raw = image_to_raw_2bpp(img)
+        row_bytes = img.size[0] // 4
+    else:
+        raw = image_to_raw_1bpp(img)
+        row_bytes = -(-img.size[0] // 8)
+    return raw, '"%08x"' % frame_hash(raw, row_bytes)[0]
+
+
+def _encode_device_raw(
+    img: Image.Image, raw: bytes, etag: str, *, two_bpp: bool, fmt: Optional[str]
+) -> tuple[bytes, str, dict[str, str], bytes]:
+    headers = {"ETag": etag}
+    if fmt == "packbits":
+        headers["X-Frame-Encoding"] = "packbits"
+        headers["X-Frame-Bpp"] = "2" if two_bpp else "1"
+        return packbits_encode(raw), "application/octet-stream", headers, raw
+    if two_bpp:
+        return raw, "application/octet-stream", headers, raw
+    return image_to_bmp_bytes(img), "image/bmp", headers, raw
+
+
+async def _apply_wake(
+    mac: str, cfg: Optional[dict], runtime: Optional[str], power: Optional[str] = None
+) -> dict[str, str]:
+    """Batched wake (wake=1): fold the boot-time side calls into /render.
+
+    Records the runtime mode the device is entering (always-active devices are
+    kept active unless their battery is low) and returns the config flags as
+    headers, replacing GET /config/{mac} and POST /device/{mac}/runtime. The
+    heartbeat is already logged with the render stats. X-Wake tells the device
+    the reply is batched.
+    """
+    focus_listening = bool(cfg.get("is_focus_listening")) if cfg else False
+    always_active = bool(cfg.get("is_always_active")) if cfg else False
+    on_battery_saver = power in ("low", "critical")
+    runtime_mode = "active" if always_active and not on_battery_saver else runtime
+    if runtime_mode:
+        await update_device_state(mac, runtime_mode=runtime_mode)
+    headers = {
+        "X-Wake": "1",
+        "X-Focus-Listening": "1" if focus_listening else "0",
+        "X-Always-Active": "1" if always_active else "0",
+    }
+    if runtime_mode:
+        headers["X-Runtime-Mode"] = runtime_mode
+    return headers
+
+
+async def _record_device_report(mac: str, params: RenderQuery) -> None:
+    """Store the refresh interval and power tier the device sent with /render."""
+    fields: dict = {}
+    if params.refresh_min is not None:
+        fields["expected_refresh_min"] = params.refresh_min
+    if params.power is not None:
+        fields["power_tier"] = params.power
+        fields["power_runtime_hours"] = params.runtime_h if params.runtime_h is not None else -1
+    if fields:
+        await update_device_state(mac, **fields)
+
+
+def _frame_patch(
+    mac: str, if_none_match: Optional[str], raw: bytes, row_bytes: int, etag: str, full_len: int
+) -> Optional[bytes]:
+    """Patch body from the frame the device reports in If-None-Match to raw.
+
+    None (send the full frame) when that frame is not among the ones recently
+    delivered to the device, or when the patch would not be smaller.
+    """
+    base_etag = (if_none_match or "").split(",")[0].strip()
+    if base_etag.startswith("W/"):
+        base_etag = base_etag[2:]
+    base = delivered_frame(mac, base_etag)
+    if base is None or len(base) != len(raw):
+        return None
+    rects = frame_patch_rects(base, raw, row_bytes)
+    if not rects:
+        return None
+    body = encode_frame_patch(int(base_etag.strip('"'), 16), int(etag.strip('"'), 16), raw, row_bytes, rects)
+    return body if len(body) < full_len else None
+
+
+def _etag_matches(if_none_match: Optional[str], etag: str) -> bool:
+    if not if_none_match:
+        return False
+    for candidate in if_none_match.split(","):
+        candidate = candidate.strip()
+        if candidate.startswith("W/"):
+            candidate = candidate[2:]
+        if candidate == "*" or candidate == etag:
+            return True
+    return False
+
+
 @router.get("/render")
 @limiter.limit("10/minute")
 async def render(
     request: Request,
     params: Annotated[RenderQuery, Depends()],
     x_device_token: Optional[str] = Header(default=None),
+    if_none_match: Optional[str] = Header(default=None),
 ):
     mac = params.mac
     cfg: Optional[dict] = None
@@ -77,6 +205,9 @@ async def render(
         cfg = await get_active_config(mac, log_load=False)
         configured_refresh_minutes = _configured_refresh_minutes(cfg)
         owner = await get_device_owner(mac)
+    wake_headers: dict[str, str] = {}
+    if mac and params.wake == 1:
+        wake_headers = await _apply_wake(mac, cfg, params.runtime, params.power)
 
     start_time = time.time()
     force_next = params.next_mode == 1
@@ -86,7 +217,10 @@ async def render(
             claim = await get_or_create_claim_token(mac, source="render")
             img = _render_device_unbound_image(params.w, params.h, claim.get("pair_code", ""))
             bmp_bytes = image_to_bmp_bytes(img)
-            headers: dict[str, str] = {}
+            if wake_headers:
+                # No render stats for unbound devices; a batched wake skips its heartbeat
+                await log_heartbeat(mac, params.v, params.rssi)
+            headers: dict[str, str] = dict(wake_headers)
             if configured_refresh_minutes is not None:
                 headers["X-Refresh-Minutes"] = str(configured_refresh_minutes)
             if await consume_pending_refresh(mac):
@@ -106,12 +240,10 @@ async def render(
                             img = pushed_img.convert("1")
                         if img.size != (params.w, params.h):
                             img = img.resize((params.w, params.h), Image.NEAREST)
-                    if params.colors >= 3 and img.mode == "P":
-                        out_bytes = image_to_raw_2bpp(img)
-                        out_media = "application/octet-stream"
-                    else:
-                        out_bytes = image_to_bmp_bytes(img)
-                        out_media = "image/bmp"
+                    two_bpp = params.colors >= 3 and img.mode == "P"
+                    out_bytes, out_media, frame_headers, raw = _encode_device_frame(
+                        img, two_bpp=two_bpp, fmt=params.fmt
+                    )
                     elapsed_ms = int((time.time() - start_time) * 1000)
                     resolved_persona = pushed_payload.get("mode") or params.persona or "PUSH_PREVIEW"
                     await log_render_stats(
@@ -122,12 +254,16 @@ async def render(
                         voltage=params.v,
                         rssi=params.rssi,
                     )
-                    if params.refresh_min is not None:
-                        await update_device_state(mac, expected_refresh_min=params.refresh_min)
+                    await _record_device_report(mac, params)
                     # Clear pending_mode after delivering the pushed preview, so the device
                     # returns to normal polling instead of re-requesting the same mode every cycle.
                     await update_device_state(mac, pending_mode=None)
-                    headers = {"X-Preview-Push": "1"}
+                    # Pushed previews are always delivered in full and never tagged,
+                    # but a patch-capable device may report one as its patch base later.
+                    if not two_bpp and params.patch == 1:
+                        remember_delivered_frame(mac, frame_headers["ETag"], raw)
+                    frame_headers.pop("ETag", None)
+                    headers = {"X-Preview-Push": "1", **frame_headers, **wake_headers}
                     if configured_refresh_minutes is not None:
                         headers["X-Refresh-Minutes"] = str(configured_refresh_minutes)
                     if await consume_pending_refresh(mac):
@@ -191,12 +327,30 @@ async def render(
             )
             img = img.resize((params.w, params.h), Image.NEAREST)
 
-        if params.colors >= 3:
-            out_bytes = image_to_raw_2bpp(img)
-            out_media = "application/octet-stream"
-        else:
-            out_bytes = image_to_bmp_bytes(img)
-            out_media = "image/bmp"
+        two_bpp = params.colors >= 3
+        raw, etag = _device_frame_raw(img, two_bpp=two_bpp)
+        if not content_fallback and _etag_matches(if_none_match, etag):
+            # Unchanged: no body to encode, no render logged, and a pending
+            # refresh is left for the device's next real frame
+            if mac:
+                await log_heartbeat(mac, params.v, params.rssi)
+                await _record_device_report(mac, params)
+                if not two_bpp and params.patch == 1:
+                    remember_delivered_frame(mac, etag, raw)
+            headers = {
+                "X-Render-Time-Ms": str(int((time.time() - start_time) * 1000)),
+                "X-Cache-Hit": "1" if cache_hit else "0",
+                "X-InkSight-Mode": resolved_persona,
+                "ETag": etag,
+                **wake_headers,
+            }
+            if configured_refresh_minutes is not None:
+                headers["X-Refresh-Minutes"] = str(configured_refresh_minutes)
+            return Response(status_code=304, headers=headers)
+
+        out_bytes, out_media, frame_headers, raw = _encode_device_raw(
+            img, raw, etag, two_bpp=two_bpp, fmt=params.fmt
+        )
         elapsed_ms = int((time.time() - start_time) * 1000)
         if mac:
             await log_render_stats(
@@ -208,19 +362,34 @@ async def render(
                 rssi=params.rssi,
                 is_fallback=content_fallback,
             )
-            if params.refresh_min is not None:
-                await update_device_state(mac, expected_refresh_min=params.refresh_min)
+            await _record_device_report(mac, params)
 
         headers: dict[str, str] = {
             "X-Render-Time-Ms": str(elapsed_ms),
             "X-Cache-Hit": "1" if cache_hit else "0",
+            "X-InkSight-Mode": resolved_persona,
+            **frame_headers,
+            **wake_headers,
         }
         if configured_refresh_minutes is not None:
             headers["X-Refresh-Minutes"] = str(configured_refresh_minutes)
         if mac and await consume_pending_refresh(mac):
             headers["X-Pending-Refresh"] = "1"
         if content_fallback:
+            # Fallback frames are never tagged, so the device keeps polling for real content.
+            headers.pop("ETag", None)
             headers["X-Content-Fallback"] = "1"
+        elif mac and not two_bpp and params.patch == 1:
+            patch = None
+            if params.fmt == "packbits":
+                patch = _frame_patch(
+                    mac, if_none_match, raw, -(-params.w // 8), headers["ETag"], len(out_bytes)
+                )
+            remember_delivered_frame(mac, headers["ETag"], raw)
+            if patch is not None:
+                headers["X-Frame-Encoding"] = "patch"
+                headers["X-Frame-Bpp"] = "1"
+                return Response(content=patch, media_type="application/octet-stream", headers=headers)
 
         return Response(content=out_bytes, media_type=out_media, headers=headers)
     except (OSError, RuntimeError, TypeError, UnidentifiedImageError, ValueError) as exc:
@@ -244,6 +413,97 @@ async def render(
         )
 
 
+_BATCH_MAX_FRAMES = 4
+_BATCH_MAGIC = b"IKB1"
+
+
+@router.get("/render/batch")
+@limiter.limit("10/minute")
+async def render_batch(
+    request: Request,
+    mac: str = Query(...),
+    count: int = Query(default=3, ge=1, le=_BATCH_MAX_FRAMES),
+    v: float = Query(default=3.3),
+    w: int = Query(default=SCREEN_WIDTH, ge=100, le=1600),
+    h: int = Query(default=SCREEN_HEIGHT, ge=100, le=1200),
+    colors: int = Query(default=2, ge=2, le=4),
+    patch: int = Query(default=0, ge=0, le=1),
+    refresh_min: Optional[int] = Query(default=None, ge=1, le=1440),
+    power: Optional[Literal["normal", "low", "critical"]] = Query(default=None),
+    x_device_token: Optional[str] = Header(default=None),
+):
+    """Upcoming frames for an interval device, rendered ahead of time.
+
+    The device fetches this right after /render and shows the frames on its own
+    timer with the radio off. Only cacheable modes are batched, one frame per
+    mode, stopping at the first mode that has to be rendered live. Each mode is
+    chosen for its frame's display time, and the refresh cycle only advances as
+    those times pass (set_cycle_schedule), not when the batch is served.
+
+    Body (little-endian): "IKB1", u8 count, 3 pad bytes, u32 server time; then
+    per frame: u32 display_at (unix seconds), u32 frame hash (the ETag value),
+    u32 length, 16-byte NUL-padded mode id, and the PackBits-encoded 1bpp frame
+    buffer (see fmt=packbits). With patch=1 the frames are kept as patch bases
+    for the device's next /render. On a low or critical battery the frames are
+    spaced by the device's stretched refresh_min, like its own wakes.
+    """
+    mac = validate_mac_param(mac)
+    await require_device_token(mac, x_device_token)
+    cfg = await get_active_config(mac, log_load=False)
+    owner = await get_device_owner(mac)
+    now = int(time.time())
+    frames: list[bytes] = []
+    # Mono only: color panels keep one frame per wake
+    if cfg and owner is not None and colors < 3:
+        from core.mode_registry import get_registry
+
+        registry = get_registry()
+        refresh_minutes = _configured_refresh_minutes(cfg)
+        if power in ("low", "critical") and refresh_min is not None:
+            refresh_minutes = max(refresh_minutes, refresh_min)
+        refresh_seconds = refresh_minutes * 60
+        seen: set[str] = set()
+        schedule: list[int] = []
+        try:
+            for i in range(count):
+                display_at = now + (i + 1) * refresh_seconds
+                persona = await choose_persona_from_config(cfg, peek_next=True, offset=i, at=display_at)
+                mode_info = registry.get_mode_info(persona)
+                if persona in seen or not mode_info or not mode_info.cacheable:
+                    break
+                img, resolved, _hit, fallback, quota_exhausted, api_key_invalid, _llm, _src = await build_image(
+                    v, mac, persona, screen_w=w, screen_h=h, colors=2,
+                )
+                if fallback or quota_exhausted or api_key_invalid or resolved != persona:
+                    break
+                seen.add(persona)
+                if img.size != (w, h):
+                    img = img.resize((w, h), Image.NEAREST)
+                raw = image_to_raw_1bpp(img.convert("1"))
+                packed = packbits_encode(raw)
+                hash_value = frame_hash(raw, -(-w // 8))[0]
+                if patch == 1:
+                    remember_delivered_frame(mac, '"%08x"' % hash_value, raw)
+                frames.append(
+                    struct.pack(
+                        "<III16s",
+                        display_at,
+                        hash_value,
+                        len(packed),
+                        persona.encode("utf-8")[:15],
+                    )
+                    + packed
+                )
+                schedule.append(display_at)
+        except (OSError, RuntimeError, TypeError, UnidentifiedImageError, ValueError):
+            logger.warning("[BATCH] Stopped after %d frames for %s", len(frames), mac, exc_info=True)
+        if cfg.get("refresh_strategy") == "cycle":
+            await set_cycle_schedule(mac, schedule)
+    logger.info("[BATCH] %d frames for %s", len(frames), mac)
+    body = struct.pack("<4sBxxxI", _BATCH_MAGIC, len(frames), now) + b"".join(frames)
+    return Response(content=body, media_type="application/octet-stream")
+
+
 @router.get("/widget/{mac}")
 async def get_widget(
     mac: str,
@@ -67,8 +67,8 @@ from core.config import (
     get_default_llm_model_for_provider,
 )
 from core.config_store import (
+    apply_cycle_schedule,
     get_active_config,
-    get_cycle_index,
     get_device_membership,
     get_device_state,
     get_quota_owner_for_mac,
@@ -218,6 +218,52 @@ _firmware_release_cache = {
 _firmware_release_cache_lock = asyncio.Lock()
 _preview_push_queue: dict[str, dict] = {}
 _preview_push_queue_lock = asyncio.Lock()
+# Live-mode long-polls (GET /device/{mac}/events) held by this worker
+_device_event_waiters: dict[str, set[asyncio.Event]] = {}
+# Raw 1bpp frames recently delivered per device, keyed by ETag: the bases
+# /render patches against (patch=1). Only patch-capable devices are tracked.
+# Per worker and best effort, bounded by device count and total bytes; a miss
+# means a full frame.
+_DELIVERED_FRAMES_PER_DEVICE = 4
+_DELIVERED_FRAMES_MAX_DEVICES = 1024
+_DELIVERED_FRAMES_MAX_BYTES = 32 * 1024 * 1024
+_delivered_frames: dict[str, dict[str, bytes]] = {}
+_delivered_frames_bytes = 0
+
+
+def _forget_device_frames(mac: str) -> None:
+    global _delivered_frames_bytes
+    frames = _delivered_frames.pop(mac, None) or {}
+    _delivered_frames_bytes -= sum(len(raw) for raw in frames.values())
+
+
+def remember_delivered_frame(mac: str, etag: str, raw: bytes) -> None:
+    global _delivered_frames_bytes
+    mac = mac.upper()
+    frames = _delivered_frames.pop(mac, None) or {}
+    old = frames.pop(etag, None)
+    if old is not None:
+        _delivered_frames_bytes -= len(old)
+    frames[etag] = raw
+    _delivered_frames_bytes += len(raw)
+    while len(frames) > _DELIVERED_FRAMES_PER_DEVICE:
+        _delivered_frames_bytes -= len(frames.pop(next(iter(frames))))
+    _delivered_frames[mac] = frames  # most recently used device last
+    while len(_delivered_frames) > _DELIVERED_FRAMES_MAX_DEVICES:
+        _forget_device_frames(next(iter(_delivered_frames)))
+    # Never evicts the device just served
+    while _delivered_frames_bytes > _DELIVERED_FRAMES_MAX_BYTES and len(_delivered_frames) > 1:
+        _forget_device_frames(next(iter(_delivered_frames)))
+
+
+def delivered_frame(mac: str, etag: str) -> Optional[bytes]:
+    return _delivered_frames.get(mac.upper(), {}).get(etag)
+
+
+def notify_device_event(mac: str) -> None:
+    """Wake the device's held /events long-poll after queuing an action for it."""
+    for waiter in _device_event_waiters.get(mac.upper(), ()):
+        waiter.set()
 
 _SMART_TIME_SLOTS = [
     (6, 9, ["RECIPE", "DAILY"]),
@@ -230,20 +276,28 @@ _SMART_TIME_SLOTS = [
 ]
 
 
-async def choose_persona_from_config(config: dict, peek_next: bool = False) -> str:
+async def choose_persona_from_config(
+    config: dict, peek_next: bool = False, *, offset: int = 0, at: Optional[float] = None
+) -> str:
+    """Mode to show at time at (default now).
+
+    offset peeks that many cycle steps ahead (prefetched frames); frames of a
+    batch already shown by now count as cycle steps (apply_cycle_schedule).
+    """
     modes = config.get("modes", DEFAULT_MODES) or DEFAULT_MODES
     strategy = config.get("refresh_strategy", "random")
+    when = datetime.fromtimestamp(at) if at is not None else datetime.now()
 
     if strategy == "cycle":
         mac = config.get("mac", "default")
-        idx = await get_cycle_index(mac)
-        persona = modes[idx % len(modes)]
+        idx = await apply_cycle_schedule(mac, time.time())
+        persona = modes[(idx + offset) % len(modes)]
         if not peek_next:
             await set_cycle_index(mac, idx + 1)
         return persona
 
     if strategy == "time_slot":
-        hour = datetime.now().hour
+        hour = when.hour
         rules = config.get("time_slot_rules", [])
         for rule in rules:
             start_h = rule.get("startHour", 0)
@@ -256,7 +310,7 @@ async def choose_persona_from_config(config: dict, peek_next: bool = False) -> s
         return random.choice(modes)
 
     if strategy == "smart":
-        hour = datetime.now().hour
+        hour = when.hour
         for start_h, end_h, candidates in _SMART_TIME_SLOTS:
             if start_h <= hour < end_h:
                 available = [mode for mode in candidates if mode in modes]
@@ -183,6 +183,9 @@ async def init_db():
                 last_reconnect_regen_at TEXT DEFAULT '',
                 alert_token TEXT DEFAULT '',
                 alert_token_created_at TEXT DEFAULT '',
+                power_tier TEXT DEFAULT '',
+                power_runtime_hours INTEGER DEFAULT -1,
+                cycle_schedule TEXT DEFAULT '',
                 updated_at TEXT NOT NULL
             )
         """)
@@ -210,6 +213,30 @@ async def init_db():
         except Exception:
             logger.warning("[MIGRATION] Failed to add alert token columns", exc_info=True)
 
+        # Migration: add power telemetry columns if missing
+        try:
+            cursor = await db.execute("PRAGMA table_info(device_state)")
+            columns = await cursor.fetchall()
+            names = [c[1] for c in columns]
+            if "power_tier" not in names:
+                await db.execute("ALTER TABLE device_state ADD COLUMN power_tier TEXT DEFAULT ''")
+            if "power_runtime_hours" not in names:
+                await db.execute("ALTER TABLE device_state ADD COLUMN power_runtime_hours INTEGER DEFAULT -1")
+            await db.commit()
+        except Exception:
+            logger.warning("[MIGRATION] Failed to add power telemetry columns", exc_info=True)
+
+        # Migration: add cycle_schedule column if missing
+        try:
+            cursor = await db.execute("PRAGMA table_info(device_state)")
+            columns = await cursor.fetchall()
+            names = [c[1] for c in columns]
+            if "cycle_schedule" not in names:
+                await db.execute("ALTER TABLE device_state ADD COLUMN cycle_schedule TEXT DEFAULT ''")
+                await db.commit()
+        except Exception:
+            logger.warning("[MIGRATION] Failed to add cycle_schedule column", exc_info=True)
+
         # User system tables
         await db.execute("""
             CREATE TABLE IF NOT EXISTS users (
@@ -1763,6 +1790,47 @@ async def set_cycle_index(mac: str, idx: int):
     await db.commit()
 
 
+async def set_cycle_schedule(mac: str, display_at: list[int]):
+    """Record when a prefetched batch shows the next cycle modes on the device.
+
+    The cycle index is not advanced when the batch is served; apply_cycle_schedule()
+    counts each frame once its display time has passed.
+    """
+    now = datetime.now().isoformat()
+    schedule = ",".join(str(int(t)) for t in display_at)
+    db = await get_main_db()
+    await db.execute(
+        """INSERT INTO device_state (mac, cycle_schedule, updated_at)
+           VALUES (?, ?, ?)
+           ON CONFLICT(mac) DO UPDATE SET cycle_schedule = ?, updated_at = ?""",
+        (mac, schedule, now, schedule, now),
+    )
+    await db.commit()
+
+
+async def apply_cycle_schedule(mac: str, now: float) -> int:
+    """Advance the cycle index past batched frames shown by now and return it."""
+    db = await get_main_db()
+    cursor = await db.execute(
+        "SELECT cycle_index, cycle_schedule FROM device_state WHERE mac = ?", (mac,)
+    )
+    row = await cursor.fetchone()
+    if not row:
+        return 0
+    idx, schedule = row[0] or 0, row[1] or ""
+    times = [int(t) for t in schedule.split(",") if t]
+    shown = sum(1 for t in times if t <= now)
+    if shown:
+        idx += shown
+        remaining = ",".join(str(t) for t in times if t > now)
+        await db.execute(
+            "UPDATE device_state SET cycle_index = ?, cycle_schedule = ?, updated_at = ? WHERE mac = ?",
+            (idx, remaining, datetime.now().isoformat(), mac),
+        )
+        await db.commit()
+    return idx
+
+
 async def update_device_state(mac: str, **kwargs):
     """Update device state fields (last_persona, last_refresh_at, pending_refresh, etc.)."""
     now = datetime.now().isoformat()
@@ -1785,6 +1853,8 @@ async def update_device_state(mac: str, **kwargs):
             "runtime_mode",
             "expected_refresh_min",
             "last_reconnect_regen_at",
+            "power_tier",
+            "power_runtime_hours",
         ):
             await db.execute(
                 f"UPDATE device_state SET {key} = ? WHERE mac = ?",
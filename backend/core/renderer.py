@@ -9,6 +9,8 @@ STOIC, ROAST, ZEN, FITNESS, POETRY 已迁移至 JSON 渲染引擎 (json_renderer
 from __future__ import annotations
 
 import io
+import struct
+import zlib
 from PIL import Image
 
 from .config import SCREEN_WIDTH, SCREEN_HEIGHT
@@ -19,7 +21,12 @@ __all__ = [
     "render_mode",
     "image_to_bmp_bytes",
     "image_to_png_bytes",
+    "image_to_raw_1bpp",
     "image_to_raw_2bpp",
+    "packbits_encode",
+    "frame_hash",
+    "frame_patch_rects",
+    "encode_frame_patch",
 ]
 
 
@@ -95,6 +102,133 @@ def image_to_raw_2bpp(img: Image.Image) -> bytes:
     return bytes(out)
 
 
+def image_to_raw_1bpp(img: Image.Image) -> bytes:
+    """Convert image to a raw 1bpp frame buffer (device imgBuf layout).
+
+    1 = white, 0 = black, MSB first, rows top to bottom, no row padding.
+    """
+    if img.mode != "1":
+        img = img.convert("1")
+    return img.tobytes()
+
+
+def packbits_encode(data: bytes) -> bytes:
+    """PackBits run-length encoding (TIFF/Apple variant).
+
+    Header byte n: 0..127 -> copy the next n+1 bytes literally;
+    129..255 -> repeat the next byte 257-n times. 128 is never emitted.
+    """
+    out = bytearray()
+    n = len(data)
+    i = 0
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 2:
+            out.append(257 - run)
+            out.append(data[i])
+            i += run
+            continue
+        start = i
+        i += 1
+        while i < n and i - start < 128:
+            if i + 2 < n and data[i] == data[i + 1] == data[i + 2]:
+                break
+            i += 1
+        out.append(i - start - 1)
+        out += data[start:i]
+    return bytes(out)
+
+
+FRAME_HASH_TILE_COLS = 8
+FRAME_HASH_TILE_ROWS = 8
+
+
+def _mix32(x: int) -> int:
+    x ^= x >> 16
+    x = (x * 0x85EBCA6B) & 0xFFFFFFFF
+    x ^= x >> 13
+    x = (x * 0xC2B2AE35) & 0xFFFFFFFF
+    x ^= x >> 16
+    return x
+
+
+def frame_hash(raw: bytes, row_bytes: int) -> tuple[int, list[int]]:
+    """Tile and frame hash of a raw frame buffer, identical to firmware frame_hash.cpp.
+
+    The buffer is split into an 8x8 grid of byte-aligned tiles. Each row segment
+    is CRC32'd with its row index as seed, mixed and summed into its tile; the
+    frame hash is CRC32 over the tile sums (little-endian uint32). Returns
+    (frame_hash, tiles) with tiles in row-major order.
+    """
+    rows = len(raw) // row_bytes
+    tile_w = -(-row_bytes // FRAME_HASH_TILE_COLS)
+    tile_h = -(-rows // FRAME_HASH_TILE_ROWS)
+    tiles = [0] * (FRAME_HASH_TILE_COLS * FRAME_HASH_TILE_ROWS)
+    for y in range(rows):
+        seed = (y * 0x9E3779B1) & 0xFFFFFFFF
+        base = (y // tile_h) * FRAME_HASH_TILE_COLS
+        row = raw[y * row_bytes:(y + 1) * row_bytes]
+        for tx, x in enumerate(range(0, row_bytes, tile_w)):
+            crc = zlib.crc32(row[x:x + tile_w], seed)
+            tiles[base + tx] = (tiles[base + tx] + _mix32(crc)) & 0xFFFFFFFF
+    return zlib.crc32(struct.pack(f"<{len(tiles)}I", *tiles)), tiles
+
+
+PATCH_MAGIC = b"IKP1"
+PATCH_MAX_RECTS = 16  # firmware PATCH_MAX_RECTS
+PATCH_ROW_GAP = 8  # unchanged rows a rectangle may bridge
+
+
+def frame_patch_rects(base: bytes, raw: bytes, row_bytes: int) -> list[tuple[int, int, int, int]] | None:
+    """Byte-aligned rectangles (x, y, w, h in pixels) covering every byte of raw
+    that differs from base.
+
+    Changed rows are grouped into bands; a band bridges up to PATCH_ROW_GAP
+    unchanged rows and spans the union of its rows' changed columns. Returns
+    None when more than PATCH_MAX_RECTS bands would be needed.
+    """
+    bands: list[list[int]] = []  # [y0, y1, b0, b1], inclusive
+    for y in range(len(raw) // row_bytes):
+        start = y * row_bytes
+        old = base[start:start + row_bytes]
+        new = raw[start:start + row_bytes]
+        if old == new:
+            continue
+        b0 = next(i for i in range(row_bytes) if old[i] != new[i])
+        b1 = next(i for i in range(row_bytes - 1, -1, -1) if old[i] != new[i])
+        if bands and y - bands[-1][1] <= PATCH_ROW_GAP + 1:
+            band = bands[-1]
+            band[1] = y
+            band[2] = min(band[2], b0)
+            band[3] = max(band[3], b1)
+        else:
+            if len(bands) == PATCH_MAX_RECTS:
+                return None
+            bands.append([y, y, b0, b1])
+    return [(b0 * 8, y0, (b1 - b0 + 1) * 8, y1 - y0 + 1) for y0, y1, b0, b1 in bands]
+
+
+def encode_frame_patch(
+    base_hash: int, result_hash: int, raw: bytes, row_bytes: int, rects: list[tuple[int, int, int, int]]
+) -> bytes:
+    """Patch body turning the frame hashed base_hash into raw (see docs/api.md).
+
+    Little-endian: "IKP1", u32 base hash, u32 result hash, u16 rect count,
+    2 pad bytes; then per rect u16 x, y, w, h (x and w multiples of 8) and
+    u32 length, followed by the rect's rows (w/8 bytes each), PackBits-encoded.
+    """
+    out = bytearray(struct.pack("<4sIIHxx", PATCH_MAGIC, base_hash, result_hash, len(rects)))
+    for x, y, w, h in rects:
+        b0 = x // 8
+        rows = b"".join(raw[(y + i) * row_bytes + b0:(y + i) * row_bytes + b0 + w // 8] for i in range(h))
+        packed = packbits_encode(rows)
+        out += struct.pack("<HHHHI", x, y, w, h, len(packed))
+        out += packed
+    return bytes(out)
+
+
 def image_to_png_bytes(img: Image.Image) -> bytes:
     """将图像转换为 PNG 字节流"""
     if img.mode == "1":
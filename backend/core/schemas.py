@@ -5,7 +5,7 @@ Pydantic 输入验证模型
 from __future__ import annotations
 
 import re
-from typing import Optional
+from typing import Literal, Optional
 from pydantic import BaseModel, ConfigDict, Field, field_validator
 
 from .config import get_supported_modes
@@ -255,6 +255,12 @@ class RenderQuery(BaseModel):
     h: int = Field(default=300, ge=100, le=1200, description="Screen height in pixels")
     next_mode: Optional[int] = Field(default=None, alias="next", description="1 = advance to next mode")
     colors: int = Field(default=2, ge=2, le=4, description="Device color capability (2=BW, 3=BWR, 4=BWRY)")
+    fmt: Optional[str] = Field(default=None, max_length=16, description="Compressed frame encoding the device accepts (packbits)")
+    patch: Optional[int] = Field(default=None, description="1 = with fmt=packbits, accept a patch against the If-None-Match frame")
+    wake: Optional[int] = Field(default=None, description="1 = batched wake request (config flags / runtime mode in response headers)")
+    runtime: Optional[Literal["active", "interval"]] = Field(default=None, description="Runtime mode the device enters after this wake")
+    power: Optional[Literal["normal", "low", "critical"]] = Field(default=None, description="Device power tier (battery policy)")
+    runtime_h: Optional[int] = Field(default=None, ge=0, le=9999, description="Estimated battery runtime in hours")
 
     @field_validator("mac")
     @classmethod
@@ -269,6 +275,9 @@ class DeviceHeartbeatRequest(BaseModel):
 
     battery_voltage: Optional[float] = Field(default=3.3, ge=0.0, le=10.0)
     wifi_rssi: Optional[int] = Field(default=None, ge=-150, le=0)
+    wake_profile: Optional[str] = Field(default=None, max_length=512)
+    power_tier: Optional[Literal["normal", "low", "critical"]] = Field(default=None)
+    runtime_hours: Optional[int] = Field(default=None, ge=-1, le=9999)
 
 
 class OkResponse(BaseModel):
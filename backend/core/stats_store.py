@@ -41,6 +41,7 @@ async def init_stats_db():
                 mac TEXT NOT NULL,
                 battery_voltage REAL,
                 wifi_rssi INTEGER,
+                wake_profile TEXT,
                 created_at TEXT NOT NULL
             )
         """)
@@ -77,6 +78,10 @@ async def init_stats_db():
             await db.execute("ALTER TABLE render_logs ADD COLUMN is_fallback INTEGER DEFAULT 0")
         except aiosqlite.OperationalError:
             pass  # column already exists
+        try:
+            await db.execute("ALTER TABLE device_heartbeats ADD COLUMN wake_profile TEXT")
+        except aiosqlite.OperationalError:
+            pass  # column already exists
         await db.commit()
 
 
@@ -98,13 +103,18 @@ async def log_render(
     await db.commit()
 
 
-async def log_heartbeat(mac: str, battery_voltage: float, wifi_rssi: int | None = None):
+async def log_heartbeat(
+    mac: str,
+    battery_voltage: float,
+    wifi_rssi: int | None = None,
+    wake_profile: str | None = None,
+):
     now = datetime.now().isoformat()
     db = await get_main_db()
     await db.execute(
-        """INSERT INTO device_heartbeats (mac, battery_voltage, wifi_rssi, created_at)
-           VALUES (?, ?, ?, ?)""",
-        (mac, battery_voltage, wifi_rssi, now),
+        """INSERT INTO device_heartbeats (mac, battery_voltage, wifi_rssi, wake_profile, created_at)
+           VALUES (?, ?, ?, ?, ?)""",
+        (mac, battery_voltage, wifi_rssi, wake_profile, now),
     )
     # Keep only the latest 1000 heartbeats per device
     await db.execute(
@@ -184,12 +194,12 @@ async def get_device_stats(mac: str) -> dict:
 
     # Battery voltage trend (last 30 entries)
     cursor = await db.execute(
-        """SELECT battery_voltage, wifi_rssi, created_at FROM device_heartbeats
+        """SELECT battery_voltage, wifi_rssi, created_at, wake_profile FROM device_heartbeats
            WHERE mac = ? ORDER BY created_at DESC LIMIT 30""",
         (mac,),
     )
     heartbeats = [
-        {"voltage": row[0], "rssi": row[1], "time": row[2]}
+        {"voltage": row[0], "rssi": row[1], "time": row[2], "wake_profile": row[3]}
         for row in await cursor.fetchall()
     ]
     heartbeats.reverse()
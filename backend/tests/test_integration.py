@@ -4,8 +4,11 @@ Uses httpx.AsyncClient with FastAPI TestClient, mocking LLM calls.
 """
 from __future__ import annotations
 
+import asyncio
 import io
 import json
+import struct
+import time
 import pytest
 from PIL import Image
 from unittest.mock import patch, AsyncMock, MagicMock
@@ -14,11 +17,11 @@ from httpx import AsyncClient
 from api.index import app
 from api import shared as shared_api
 from core.cache import content_cache
-from core.config_store import get_device_state, init_db
+from core.config_store import apply_cycle_schedule, get_cycle_index, get_device_state, init_db, set_pending_refresh
 from core.config_store import validate_alert_token
 from core.db import get_main_db
 from core.mode_registry import reset_registry
-from core.stats_store import init_stats_db
+from core.stats_store import get_render_history, init_stats_db
 from core.cache import init_cache_db
 
 
@@ -189,6 +192,363 @@ async def test_render_returns_bmp(client):
         assert resp.content[:2] == b"BM"
 
 
+def _fake_build_image_factory(img: Image.Image, *, fallback: bool = False):
+    async def _fake_build_image(*args, **kwargs):
+        return img.copy(), "STOIC", True, fallback, False, False, False, None
+
+    return _fake_build_image
+
+
+def _use_fake_render(monkeypatch, img: Image.Image, *, fallback: bool = False):
+    """Serve /render from a fixed frame for a device bound to an owner."""
+
+    async def _fake_get_device_owner(mac: str):
+        return {"mac": mac, "user_id": 1, "nickname": "", "created_at": "", "username": "owner"}
+
+    monkeypatch.setattr("api.routes.render.get_device_owner", _fake_get_device_owner)
+    monkeypatch.setattr("api.routes.render.build_image", _fake_build_image_factory(img, fallback=fallback))
+
+
+@pytest.mark.asyncio
+async def test_render_conditional_get_returns_304(client, monkeypatch):
+    mac = "AA:BB:CC:DD:EE:31"
+    headers = await provision_device_headers(client, mac)
+    _use_fake_render(monkeypatch, Image.new("1", (400, 300), 1))
+    params = {"mac": mac, "v": "3.85", "w": "400", "h": "300"}
+
+    first = await client.get("/api/render", params=params, headers=headers)
+    assert first.status_code == 200
+    assert first.headers["x-inksight-mode"] == "STOIC"
+    etag = first.headers["etag"]
+
+    renders = len(await get_render_history(mac))
+    await set_pending_refresh(mac)
+    second = await client.get(
+        "/api/render", params=params, headers={**headers, "If-None-Match": etag}
+    )
+    assert second.status_code == 304
+    assert second.content == b""
+    assert second.headers["etag"] == etag
+    # An unchanged poll is not a render and leaves the pending refresh alone
+    assert "x-pending-refresh" not in second.headers
+    assert len(await get_render_history(mac)) == renders
+    assert (await get_device_state(mac))["pending_refresh"] == 1
+
+    stale = await client.get(
+        "/api/render", params=params, headers={**headers, "If-None-Match": '"0000"'}
+    )
+    assert stale.status_code == 200
+    assert stale.content[:2] == b"BM"
+
+
+@pytest.mark.asyncio
+async def test_render_fallback_content_is_not_tagged(client, monkeypatch):
+    mac = "AA:BB:CC:DD:EE:32"
+    headers = await provision_device_headers(client, mac)
+    _use_fake_render(monkeypatch, Image.new("1", (400, 300), 1), fallback=True)
+    resp = await client.get(
+        "/api/render",
+        params={"mac": mac, "v": "3.85", "w": "400", "h": "300"},
+        headers={**headers, "If-None-Match": "*"},
+    )
+    assert resp.status_code == 200
+    assert resp.headers["x-content-fallback"] == "1"
+    assert "etag" not in resp.headers
+
+
+@pytest.mark.asyncio
+async def test_render_packbits_frame(client, monkeypatch):
+    mac = "AA:BB:CC:DD:EE:33"
+    headers = await provision_device_headers(client, mac)
+    _use_fake_render(monkeypatch, Image.new("1", (400, 300), 1))
+    resp = await client.get(
+        "/api/render",
+        params={"mac": mac, "v": "3.85", "w": "400", "h": "300", "fmt": "packbits"},
+        headers=headers,
+    )
+    assert resp.status_code == 200
+    assert resp.headers["x-frame-encoding"] == "packbits"
+    assert resp.headers["x-frame-bpp"] == "1"
+    assert resp.headers["content-type"] == "application/octet-stream"
+    assert len(resp.content) < 400 * 300 // 8 // 10
+
+
+@pytest.mark.asyncio
+async def test_render_patch_against_reported_frame(client, monkeypatch):
+    mac = "AA:BB:CC:DD:EE:3A"
+    headers = await provision_device_headers(client, mac)
+    img = Image.new("1", (400, 300), 1)
+    _use_fake_render(monkeypatch, img)
+    params = {"mac": mac, "v": "3.85", "w": "400", "h": "300", "fmt": "packbits", "patch": "1"}
+    first = await client.get("/api/render", params=params, headers=headers)
+    assert first.status_code == 200
+    assert first.headers["x-frame-encoding"] == "packbits"
+    base_etag = first.headers["etag"]
+
+    changed = img.copy()
+    for x in range(16, 40):
+        changed.putpixel((x, 5), 0)
+    _use_fake_render(monkeypatch, changed)
+    resp = await client.get("/api/render", params=params, headers={**headers, "If-None-Match": base_etag})
+    assert resp.status_code == 200
+    assert resp.headers["x-frame-encoding"] == "patch"
+    assert resp.headers["etag"] != base_etag
+    body = resp.content
+    assert body[:4] == b"IKP1"
+    assert '"%08x"' % struct.unpack_from("<I", body, 4)[0] == base_etag
+    assert '"%08x"' % struct.unpack_from("<I", body, 8)[0] == resp.headers["etag"]
+    assert struct.unpack_from("<H", body, 12)[0] == 1
+    assert struct.unpack_from("<HHHH", body, 16) == (16, 5, 24, 1)
+
+    # Unknown base: full frame
+    resp = await client.get("/api/render", params=params, headers={**headers, "If-None-Match": '"00000000"'})
+    assert resp.status_code == 200
+    assert resp.headers["x-frame-encoding"] == "packbits"
+
+
+@pytest.mark.asyncio
+async def test_render_keeps_patch_bases_only_for_patch_capable_devices(client, monkeypatch):
+    mac = "AA:BB:CC:DD:EE:3C"
+    headers = await provision_device_headers(client, mac)
+    _use_fake_render(monkeypatch, Image.new("1", (400, 300), 1))
+    params = {"mac": mac, "v": "3.85", "w": "400", "h": "300", "fmt": "packbits"}
+    resp = await client.get("/api/render", params=params, headers=headers)
+    assert resp.status_code == 200
+    assert shared_api.delivered_frame(mac, resp.headers["etag"]) is None
+
+    resp = await client.get("/api/render", params={**params, "patch": "1"}, headers=headers)
+    assert resp.status_code == 200
+    assert shared_api.delivered_frame(mac, resp.headers["etag"]) is not None
+
+
+def test_delivered_frames_are_capped_by_bytes(monkeypatch):
+    monkeypatch.setattr(shared_api, "_delivered_frames", {})
+    monkeypatch.setattr(shared_api, "_delivered_frames_bytes", 0)
+    monkeypatch.setattr(shared_api, "_DELIVERED_FRAMES_MAX_BYTES", 3000)
+    for i in range(4):
+        shared_api.remember_delivered_frame("AA:BB:CC:DD:EE:%02X" % i, '"0000000%d"' % i, bytes(1000))
+    assert shared_api.delivered_frame("AA:BB:CC:DD:EE:00", '"00000000"') is None
+    assert shared_api.delivered_frame("AA:BB:CC:DD:EE:03", '"00000003"') is not None
+    assert shared_api._delivered_frames_bytes == 3000
+
+
+@pytest.mark.asyncio
+async def test_render_wake_reports_flags_and_records_runtime(client, monkeypatch):
+    mac = "AA:BB:CC:DD:EE:34"
+    headers = await provision_device_headers(client, mac)
+    _use_fake_render(monkeypatch, Image.new("1", (400, 300), 1))
+    params = {"mac": mac, "v": "3.85", "w": "400", "h": "300", "wake": "1", "runtime": "interval"}
+
+    resp = await client.get("/api/render", params=params, headers=headers)
+    assert resp.status_code == 200
+    assert resp.headers["x-wake"] == "1"
+    assert resp.headers["x-focus-listening"] == "0"
+    assert resp.headers["x-always-active"] == "0"
+    assert resp.headers["x-runtime-mode"] == "interval"
+    state = await get_device_state(mac)
+    assert state["runtime_mode"] == "interval"
+
+    async def _always_active_config(mac: str, log_load: bool = True):
+        return {"mac": mac, "refresh_interval": 60, "is_focus_listening": True, "is_always_active": True}
+
+    monkeypatch.setattr("api.routes.render.get_active_config", _always_active_config)
+    etag = resp.headers["etag"]
+    resp = await client.get("/api/render", params=params, headers={**headers, "If-None-Match": etag})
+    assert resp.status_code == 304
+    assert resp.headers["x-focus-listening"] == "1"
+    assert resp.headers["x-runtime-mode"] == "active"
+    state = await get_device_state(mac)
+    assert state["runtime_mode"] == "active"
+
+
+@pytest.mark.asyncio
+async def test_render_records_power_tier_and_keeps_low_battery_interval(client, monkeypatch):
+    mac = "AA:BB:CC:DD:EE:3B"
+    headers = await provision_device_headers(client, mac)
+    _use_fake_render(monkeypatch, Image.new("1", (400, 300), 1))
+
+    async def _always_active_config(mac: str, log_load: bool = True):
+        return {"mac": mac, "refresh_interval": 60, "is_focus_listening": False, "is_always_active": True}
+
+    monkeypatch.setattr("api.routes.render.get_active_config", _always_active_config)
+    params = {
+        "mac": mac, "v": "3.52", "w": "400", "h": "300", "refresh_min": "120",
+        "wake": "1", "runtime": "interval", "power": "low", "runtime_h": "60",
+    }
+    resp = await client.get("/api/render", params=params, headers=headers)
+    assert resp.status_code == 200
+    assert resp.headers["x-runtime-mode"] == "interval"
+    state = await get_device_state(mac)
+    assert state["power_tier"] == "low"
+    assert state["power_runtime_hours"] == 60
+    assert state["expected_refresh_min"] == 120
+
+    resp = await client.post(
+        f"/api/device/{mac}/heartbeat",
+        json={"battery_voltage": 3.38, "wifi_rssi": -60, "power_tier": "critical", "runtime_hours": -1},
+        headers=headers,
+    )
+    assert resp.status_code == 200
+    state = await get_device_state(mac)
+    assert state["power_tier"] == "critical"
+    assert state["power_runtime_hours"] == -1
+
+
+@pytest.mark.asyncio
+async def test_render_batch_spaces_frames_by_power_stretched_interval(client, monkeypatch):
+    mac = "AA:BB:CC:DD:EE:3D"
+    headers = await provision_device_headers(client, mac)
+    _use_fake_render(monkeypatch, Image.new("1", (400, 300), 1))
+
+    async def _fake_build_image(v, mac, persona=None, **kwargs):
+        return Image.new("1", (400, 300), 1), persona, True, False, False, False, False, None
+
+    async def _cycle_config(mac: str, log_load: bool = True):
+        return {"mac": mac, "refresh_interval": 60, "refresh_strategy": "cycle", "modes": ["STOIC", "ZEN"]}
+
+    monkeypatch.setattr("api.routes.render.build_image", _fake_build_image)
+    monkeypatch.setattr("api.routes.render.get_active_config", _cycle_config)
+
+    params = {"mac": mac, "count": "2", "w": "400", "h": "300", "refresh_min": "120"}
+    for power, spacing in (("normal", 3600), ("low", 7200)):
+        resp = await client.get("/api/render/batch", params={**params, "power": power}, headers=headers)
+        assert resp.status_code == 200
+        body = resp.content
+        _magic, count, server_now = struct.unpack_from("<4sBxxxI", body, 0)
+        assert count == 2
+        offset = 12
+        for i in range(count):
+            display_at, _hash, length, _mode = struct.unpack_from("<III16s", body, offset)
+            offset += 28 + length
+            assert display_at == server_now + (i + 1) * spacing
+
+
+@pytest.mark.asyncio
+async def test_render_without_wake_has_no_wake_headers(client, monkeypatch):
+    mac = "AA:BB:CC:DD:EE:35"
+    headers = await provision_device_headers(client, mac)
+    _use_fake_render(monkeypatch, Image.new("1", (400, 300), 1))
+    resp = await client.get(
+        "/api/render",
+        params={"mac": mac, "v": "3.85", "w": "400", "h": "300"},
+        headers=headers,
+    )
+    assert resp.status_code == 200
+    assert "x-wake" not in resp.headers
+    assert "x-runtime-mode" not in resp.headers
+
+
+@pytest.mark.asyncio
+async def test_render_batch_schedules_cacheable_modes(client, monkeypatch):
+    mac = "AA:BB:CC:DD:EE:37"
+    headers = await provision_device_headers(client, mac)
+    _use_fake_render(monkeypatch, Image.new("1", (400, 300), 1))
+
+    async def _fake_build_image(v, mac, persona=None, **kwargs):
+        return Image.new("1", (400, 300), 1), persona, True, False, False, False, False, None
+
+    async def _cycle_config(mac: str, log_load: bool = True):
+        return {
+            "mac": mac,
+            "refresh_interval": 60,
+            "refresh_strategy": "cycle",
+            "modes": ["STOIC", "ZEN", "WEATHER"],
+        }
+
+    monkeypatch.setattr("api.routes.render.build_image", _fake_build_image)
+    monkeypatch.setattr("api.routes.render.get_active_config", _cycle_config)
+
+    resp = await client.get(
+        "/api/render/batch",
+        params={"mac": mac, "count": "4", "w": "400", "h": "300"},
+        headers=headers,
+    )
+    assert resp.status_code == 200
+    body = resp.content
+    magic, count, server_now = struct.unpack_from("<4sBxxxI", body, 0)
+    assert magic == b"IKB1"
+    # WEATHER is not cacheable, so the batch stops in front of it
+    assert count == 2
+    offset = 12
+    modes = []
+    for i in range(count):
+        display_at, _hash, length, mode = struct.unpack_from("<III16s", body, offset)
+        offset += 28 + length
+        assert display_at == server_now + (i + 1) * 3600
+        assert length > 0
+        modes.append(mode.rstrip(b"\0").decode())
+    assert offset == len(body)
+    assert modes == ["STOIC", "ZEN"]
+    # The cycle only advances as the device shows the frames
+    assert await get_cycle_index(mac) == 0
+    assert await apply_cycle_schedule(mac, server_now + 3600) == 1
+    assert await apply_cycle_schedule(mac, server_now + 7200) == 2
+    assert await get_cycle_index(mac) == 2
+
+
+@pytest.mark.asyncio
+async def test_state_poll_folds_heartbeat(client):
+    mac = "AA:BB:CC:DD:EE:36"
+    headers = await provision_device_headers(client, mac)
+    runtime_resp = await client.post(f"/api/device/{mac}/runtime", json={"mode": "active"}, headers=headers)
+    assert runtime_resp.status_code == 200
+
+    plain = await client.get(f"/api/device/{mac}/state", headers=headers)
+    assert plain.status_code == 200
+    assert "x-heartbeat" not in plain.headers
+
+    polled = await client.get(
+        f"/api/device/{mac}/state", params={"v": "3.9", "rssi": "-50"}, headers=headers
+    )
+    assert polled.status_code == 200
+    assert polled.headers["x-heartbeat"] == "1"
+    assert polled.json()["is_online"] is True
+
+
+@pytest.mark.asyncio
+async def test_heartbeat_stores_wake_profile(client):
+    mac = "AA:BB:CC:DD:EE:3A"
+    headers = await provision_device_headers(client, mac)
+    profile = "7:refresh:5120:840/310/420/1630/380/95/60/1480/120:118204/69620"
+
+    resp = await client.post(
+        f"/api/device/{mac}/heartbeat",
+        json={"battery_voltage": 3.9, "wifi_rssi": -50, "wake_profile": profile},
+        headers=headers,
+    )
+    assert resp.status_code == 200
+
+    stats_resp = await client.get(f"/api/stats/{mac}", headers=headers)
+    assert stats_resp.status_code == 200
+    assert stats_resp.json()["heartbeats"][-1]["wake_profile"] == profile
+
+
+@pytest.mark.asyncio
+async def test_events_long_poll_reports_queued_refresh(client):
+    mac = "AA:BB:CC:DD:EE:37"
+    headers = await provision_device_headers(client, mac)
+    runtime_resp = await client.post(f"/api/device/{mac}/runtime", json={"mode": "active"}, headers=headers)
+    assert runtime_resp.status_code == 200
+
+    idle = await client.get(f"/api/device/{mac}/events", params={"hold": "0"}, headers=headers)
+    assert idle.status_code == 200
+    assert idle.json() == {"event": "none"}
+
+    async def _queue_refresh():
+        await asyncio.sleep(0.2)
+        return await client.post(f"/api/device/{mac}/refresh", headers=headers)
+
+    started = time.monotonic()
+    held, queued = await asyncio.gather(
+        client.get(f"/api/device/{mac}/events", params={"hold": "10"}, headers=headers),
+        _queue_refresh(),
+    )
+    assert queued.status_code == 200
+    assert held.status_code == 200
+    assert held.json() == {"event": "refresh"}
+    assert time.monotonic() - started < 4
+
+
 @pytest.mark.asyncio
 async def test_render_returns_binding_prompt_when_device_has_no_owner(client, monkeypatch):
     headers = await provision_device_headers(client, "AA:BB:CC:DD:EE:99")
@@ -541,12 +901,18 @@ async def test_focus_alert_bmp_renders_and_consumes_alert(client):
     )
     assert push.status_code == 200
 
+    for _ in range(2):
+        head_resp = await client.head(f"/api/device/{mac}/alert-bmp", headers=headers)
+        assert head_resp.status_code == 200
+
     bmp_resp = await client.get(f"/api/device/{mac}/alert-bmp", params={"w": 400, "h": 300}, headers=headers)
     assert bmp_resp.status_code == 200
     assert bmp_resp.content[:2] == b"BM"
 
     bmp_resp2 = await client.get(f"/api/device/{mac}/alert-bmp", params={"w": 400, "h": 300}, headers=headers)
     assert bmp_resp2.status_code == 204
+    head_resp = await client.head(f"/api/device/{mac}/alert-bmp", headers=headers)
+    assert head_resp.status_code == 204
 
 
 # ---------------------------------------------------------------------------
@@ -5,10 +5,21 @@ STOIC, ROAST, ZEN, FITNESS, POETRY are now JSON-defined modes rendered by
 json_renderer.py. Tests for those live in test_json_renderer.py.
 This file tests only the Python builtin modes still dispatched by render_mode().
 """
+import struct
+
 import pytest
 from PIL import Image
 
-from core.renderer import image_to_bmp_bytes, image_to_png_bytes, render_mode
+from core.renderer import (
+    encode_frame_patch,
+    frame_hash,
+    frame_patch_rects,
+    image_to_bmp_bytes,
+    image_to_png_bytes,
+    image_to_raw_1bpp,
+    packbits_encode,
+    render_mode,
+)
 
 
 def _make_1bit_image() -> Image.Image:
@@ -36,6 +47,111 @@ class TestImageConversion:
         assert data[:4] == b"\x89PNG"
 
 
+def _packbits_decode(data: bytes) -> bytes:
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        header = data[i]
+        i += 1
+        if header < 128:
+            out += data[i:i + header + 1]
+            i += header + 1
+        elif header > 128:
+            out += bytes([data[i]]) * (257 - header)
+            i += 1
+    return bytes(out)
+
+
+class TestFrameEncoding:
+    def test_raw_1bpp_layout(self):
+        img = _make_1bit_image()
+        img.putpixel((0, 0), 0)
+        raw = image_to_raw_1bpp(img)
+        assert len(raw) == 400 * 300 // 8
+        assert raw[0] == 0x7F
+        assert raw[1:] == b"\xff" * (len(raw) - 1)
+
+    def test_packbits_roundtrip(self):
+        samples = [
+            b"",
+            b"\x00",
+            b"\xff" * 1000,
+            bytes(range(256)) * 3,
+            b"\xaa\xaa\x01\x02\x03\x03\x03\x04" * 50,
+        ]
+        for data in samples:
+            assert _packbits_decode(packbits_encode(data)) == data
+
+    def test_packbits_compresses_blank_frame(self):
+        raw = image_to_raw_1bpp(_make_1bit_image())
+        encoded = packbits_encode(raw)
+        assert len(encoded) * 10 < len(raw)
+        assert 128 not in encoded[::2]
+
+
+class TestFrameHash:
+    def test_matches_firmware_reference(self):
+        # Reference values from firmware/src/frame_hash.cpp on the same buffers
+        blank = b"\xff" * (50 * 300)
+        assert frame_hash(blank, 50)[0] == 0x587A27C2
+        marked = b"\x00" + blank[1:]
+        assert frame_hash(marked, 50)[0] == 0x99029897
+
+    def test_change_only_touches_its_tile(self):
+        blank = bytearray(b"\xff" * (50 * 300))
+        _, before = frame_hash(bytes(blank), 50)
+        blank[100 * 50 + 20] = 0x00  # row 100, byte 20 -> tile row 2, tile col 2
+        _, after = frame_hash(bytes(blank), 50)
+        changed = [i for i, (a, b) in enumerate(zip(before, after)) if a != b]
+        assert changed == [2 * 8 + 2]
+
+    def test_moved_line_changes_hash(self):
+        a = bytearray(b"\xff" * (50 * 300))
+        b = bytearray(a)
+        a[10 * 50 + 3] = 0x00
+        b[11 * 50 + 3] = 0x00
+        assert frame_hash(bytes(a), 50)[0] != frame_hash(bytes(b), 50)[0]
+
+
+def _apply_patch(base: bytes, body: bytes, row_bytes: int) -> bytes:
+    assert body[:4] == b"IKP1"
+    (count,) = struct.unpack_from("<H", body, 12)
+    out = bytearray(base)
+    pos = 16
+    for _ in range(count):
+        x, y, w, h, length = struct.unpack_from("<HHHHI", body, pos)
+        pos += 12
+        rows = _packbits_decode(body[pos:pos + length])
+        pos += length
+        for i in range(h):
+            start = (y + i) * row_bytes + x // 8
+            out[start:start + w // 8] = rows[i * (w // 8):(i + 1) * (w // 8)]
+    assert pos == len(body)
+    return bytes(out)
+
+
+class TestFramePatch:
+    def test_rects_cover_changes_and_roundtrip(self):
+        base = b"\xff" * (50 * 300)
+        frame = bytearray(base)
+        for y in range(10, 30):
+            frame[y * 50 + 3:y * 50 + 7] = b"\x00\x12\x34\x00"
+        frame[200 * 50 + 40] = 0x00
+        rects = frame_patch_rects(base, bytes(frame), 50)
+        assert rects == [(24, 10, 32, 20), (320, 200, 8, 1)]
+        body = encode_frame_patch(1, 2, bytes(frame), 50, rects)
+        assert struct.unpack_from("<II", body, 4) == (1, 2)
+        assert _apply_patch(base, body, 50) == bytes(frame)
+        assert len(body) < 200
+
+    def test_scattered_changes_give_up(self):
+        base = b"\xff" * (50 * 300)
+        frame = bytearray(base)
+        for y in range(0, 300, 12):
+            frame[y * 50] = 0x00
+        assert frame_patch_rects(base, bytes(frame), 50) is None
+
+
 class TestRenderMode:
     """render_mode is legacy; all modes are JSON-defined."""
 
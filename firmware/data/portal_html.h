@@ -504,7 +504,9 @@ document.getElementById('cdN').textContent='10';
 (function(){
 applyLang();
 switchWTab('manual');
+(function loadScan(){
 fetch('/scan').then(function(r){return r.json()}).then(function(d){
+if(d.scanning&&!(d.networks||[]).length){setTimeout(loadScan,1500);return;}
 document.getElementById('wScanLoading').style.display='none';
 var ul=document.getElementById('wifiList');
 ul.style.display='block';
@@ -525,6 +527,7 @@ ul.appendChild(li);
 }).catch(function(){
 document.getElementById('wScanLoading').innerHTML='扫描失败，请刷新页面重试或手动输入';
 });
+})();
 
 fetch('/info').then(function(r){return r.json()}).then(function(d){
 if(d.mac){devMac=d.mac;document.getElementById('devMAC').textContent=d.mac;}
@@ -0,0 +1,57 @@
+# Pre-build step: gzip the captive portal page from data/portal_html.h into
+# data/portal_html_gz.h, which portal.cpp serves gzip-encoded with cache headers.
+# Also runs standalone: python embed_portal.py
+import gzip
+import hashlib
+import os
+
+ROOT = os.path.dirname(os.path.abspath(globals().get("__file__", "embed_portal.py")))
+try:
+    Import("env")
+    ROOT = env.subst("$PROJECT_DIR")
+except NameError:
+    pass
+
+SOURCE = os.path.join(ROOT, "data", "portal_html.h")
+OUTPUT = os.path.join(ROOT, "data", "portal_html_gz.h")
+START, END = 'R"rawliteral(', ')rawliteral"'
+
+
+def page_html():
+    with open(SOURCE, encoding="utf-8") as f:
+        text = f.read()
+    begin = text.index(START) + len(START)
+    return text[begin:text.index(END, begin)].encode("utf-8")
+
+
+def render(html):
+    body = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(body).hexdigest()[:16]
+    lines = [
+        "// Generated by embed_portal.py from portal_html.h; do not edit.",
+        "#ifndef PORTAL_HTML_GZ_H",
+        "#define PORTAL_HTML_GZ_H",
+        "",
+        f'#define PORTAL_HTML_ETAG "\\"{etag}\\""',
+        f"const size_t PORTAL_HTML_GZ_LEN = {len(body)};  // {len(html)} bytes uncompressed",
+        "const uint8_t PORTAL_HTML_GZ[] PROGMEM = {",
+    ]
+    for i in range(0, len(body), 16):
+        lines.append("    " + ", ".join(f"0x{b:02x}" for b in body[i:i + 16]) + ",")
+    lines += ["};", "", "#endif", ""]
+    return "\n".join(lines), len(html), len(body)
+
+
+def main():
+    text, raw, packed = render(page_html())
+    old = None
+    if os.path.exists(OUTPUT):
+        with open(OUTPUT, encoding="utf-8") as f:
+            old = f.read()
+    if old != text:
+        with open(OUTPUT, "w", encoding="utf-8") as f:
+            f.write(text)
+        print(f"embed_portal: portal page {raw} -> {packed} bytes gzip")
+
+
+main()
@@ -0,0 +1,95 @@
+#include "button.h"
+#include "config.h"
+
+#if TASK_RUNTIME
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#endif
+
+static unsigned long pressStart = 0;  // 0 = not pressed
+static bool holdReported = false;
+static bool ignoreUntilRelease = false;
+static ButtonEvent latched = BTN_NONE;
+static bool sampling = false;         // the timer samples; otherwise buttonTakeEvent() does
+
+#if TASK_RUNTIME
+static portMUX_TYPE btnMux = portMUX_INITIALIZER_UNLOCKED;
+static esp_timer_handle_t sampleTimer = nullptr;
+static void btnLock() { portENTER_CRITICAL(&btnMux); }
+static void btnUnlock() { portEXIT_CRITICAL(&btnMux); }
+#else
+static void btnLock() {}
+static void btnUnlock() {}
+#endif
+
+static void buttonSample() {
+    bool isPressed = (digitalRead(PIN_CFG_BTN) == LOW);
+    unsigned long now = millis();
+
+    btnLock();
+    if (ignoreUntilRelease) {
+        if (!isPressed) ignoreUntilRelease = false;
+        pressStart = 0;
+    } else if (isPressed) {
+        if (pressStart == 0) {
+            pressStart = now;
+            holdReported = false;
+        } else if (!holdReported && now - pressStart >= (unsigned long)CFG_BTN_HOLD_MS) {
+            holdReported = true;
+            latched = BTN_HOLD;
+        }
+    } else if (pressStart != 0) {
+        unsigned long pressDuration = now - pressStart;
+        pressStart = 0;
+        if (!holdReported && pressDuration >= (unsigned long)SHORT_PRESS_MIN_MS) {
+            latched = BTN_CLICK;
+        }
+    }
+    btnUnlock();
+}
+
+#if TASK_RUNTIME
+static void sampleCallback(void *) {
+    buttonSample();
+}
+#endif
+
+void buttonBegin() {
+#if TASK_RUNTIME
+    if (sampling) return;
+    esp_timer_create_args_t args = {};
+    args.callback = sampleCallback;
+    args.name = "button";
+    if (esp_timer_create(&args, &sampleTimer) != ESP_OK ||
+        esp_timer_start_periodic(sampleTimer, (uint64_t)BTN_SAMPLE_MS * 1000ULL) != ESP_OK) {
+        Serial.println("[BTN] Sampling timer not started, polling from loop()");
+        return;
+    }
+    sampling = true;
+#endif
+}
+
+void buttonIgnoreUntilRelease() {
+    btnLock();
+    ignoreUntilRelease = true;
+    pressStart = 0;
+    latched = BTN_NONE;
+    btnUnlock();
+}
+
+ButtonEvent buttonTakeEvent() {
+    if (!sampling) buttonSample();
+    btnLock();
+    ButtonEvent ev = latched;
+    latched = BTN_NONE;
+    btnUnlock();
+    return ev;
+}
+
+bool buttonPressed() {
+    if (!sampling) buttonSample();
+    btnLock();
+    bool pressed = pressStart != 0;
+    btnUnlock();
+    return pressed;
+}
@@ -0,0 +1,31 @@
+#ifndef INKSIGHT_BUTTON_H
+#define INKSIGHT_BUTTON_H
+
+#include <Arduino.h>
+
+// ── Config button ───────────────────────────────────────────
+// Debounced click / hold detection on PIN_CFG_BTN. With TASK_RUNTIME an
+// esp_timer samples the pin every BTN_SAMPLE_MS, so presses register while
+// the loop task is blocked in a download or a panel wait; the loop takes the
+// latched event. Otherwise buttonTakeEvent() samples the pin itself.
+
+enum ButtonEvent : uint8_t {
+    BTN_NONE,
+    BTN_CLICK,  // released after SHORT_PRESS_MIN_MS..CFG_BTN_HOLD_MS
+    BTN_HOLD,   // held for CFG_BTN_HOLD_MS (reported once, while still down)
+};
+
+// Start sampling (after gpioInit)
+void buttonBegin();
+
+// Ignore the press in progress, if any (e.g. the one that opened the portal),
+// and drop a latched event
+void buttonIgnoreUntilRelease();
+
+// Take the latched event (BTN_NONE when there is none)
+ButtonEvent buttonTakeEvent();
+
+// A press is in progress
+bool buttonPressed();
+
+#endif // INKSIGHT_BUTTON_H
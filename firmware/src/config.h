@@ -23,6 +23,17 @@
 #define PIN_BAT_ADC    35
 #define PIN_CFG_BTN    0
 #define PIN_LED        2
+#elif defined(BOARD_PROFILE_NATIVE)
+// Host build (env:native_*, test/): only the board-independent modules
+#define PIN_EPD_MOSI   -1
+#define PIN_EPD_SCK    -1
+#define PIN_EPD_CS     -1
+#define PIN_EPD_DC     -1
+#define PIN_EPD_RST    -1
+#define PIN_EPD_BUSY   -1
+#define PIN_BAT_ADC    -1
+#define PIN_CFG_BTN    -1
+#define PIN_LED        -1
 #else
 #error "Unsupported board profile"
 #endif
@@ -51,28 +62,162 @@ static const int IMG_BUF_LEN = ROW_BYTES * H;
 #ifndef EPD_BPP
 #define EPD_BPP 1
 #endif
-static const int COLOR_BUF_LEN = (W * H) / 4;  // 2bpp: 4 pixels per byte
+static const int COLOR_ROW_BYTES = W / 4;
+static const int COLOR_BUF_LEN = COLOR_ROW_BYTES * H;  // 2bpp: 4 pixels per byte
 
-// Shared framebuffers (defined in main.cpp)
-extern uint8_t imgBuf[];
+// ── EPD SPI transport (directly driven SSD1683 / JD79668 panels) ──
+// Hardware SPI by default; -DEPD_SOFT_SPI=1 falls back to the bit-bang driver.
+#ifndef EPD_SOFT_SPI
+#define EPD_SOFT_SPI 0
+#endif
+#ifndef EPD_SPI_HZ
+#define EPD_SPI_HZ 10000000
+#endif
+
+// Stream BMP rows into panel RAM while the download is in flight (SSD1683 BW;
+// 5.83"/7.5" write 16-row bands through GxEPD2)
+#ifndef EPD_STREAM_DISPLAY
+#define EPD_STREAM_DISPLAY 0
+#endif
+
+// Light-sleep through EPD busy waits while WiFi is off (BUSY/button wake)
+#ifndef EPD_BUSY_LIGHT_SLEEP
+#define EPD_BUSY_LIGHT_SLEEP 1
+#endif
+
+// Rejoin the last AP by BSSID/channel with the cached IP lease (no scan, no DHCP)
+#ifndef WIFI_FAST_JOIN
+#define WIFI_FAST_JOIN 1
+#endif
+
+// Interval mode: deep sleep between refreshes instead of idling awake. The
+// WROOM button (GPIO0, an RTC GPIO) wakes the device; the C3 button (GPIO9)
+// cannot, so there a click is taken in the awake window after a reset.
+#ifndef INTERVAL_DEEP_SLEEP
+#define INTERVAL_DEEP_SLEEP 1
+#endif
+
+// Interval mode: prefetch this many upcoming frames per online wake and show
+// them on the local timer with the radio off (mono frame store only; also
+// capped by the store's slot count)
+#ifndef PREFETCH_FRAMES
+#if EPD_BPP >= 2
+#define PREFETCH_FRAMES 0
+#else
+#define PREFETCH_FRAMES 3
+#endif
+#endif
+
+// Accept region patches against the frame sent in If-None-Match (patch=1);
+// mono frames only
+#ifndef FRAME_PATCHES
+#if EPD_BPP >= 2
+#define FRAME_PATCHES 0
+#else
+#define FRAME_PATCHES 1
+#endif
+#endif
+
+// Task runtime (frame_pipeline.h, button.h): content frames go to a display
+// task through a queue while the loop task keeps the network side going, and
+// the config button is sampled on a timer. 0 displays synchronously from loop().
+#ifndef TASK_RUNTIME
+#define TASK_RUNTIME 1
+#endif
+
+// Frame buffers handed between the loop and the display task. With two, the
+// next frame downloads while the panel takes the previous one; the spare is
+// allocated at boot. colorBuf is not pooled, so 2bpp builds use one, and a
+// second 39-48 KB frame on the 5.83"/7.5" panels costs the TLS heap too much.
+#ifndef FRAME_POOL_SIZE
+#if EPD_BPP >= 2 || EPD_WIDTH * EPD_HEIGHT > 400 * 300
+#define FRAME_POOL_SIZE 1
+#else
+#define FRAME_POOL_SIZE 2
+#endif
+#endif
+
+// Wake-cycle profiler (profiler.h); 0 compiles it out
+#ifndef INKSIGHT_PROFILE
+#define INKSIGHT_PROFILE 1
+#endif
+static const int PROF_SUMMARY_MAX = 480;  // heartbeat wake_profile text
+
+// Shared framebuffers (defined in main.cpp). imgBuf is the frame the loop
+// task works on; with TASK_RUNTIME it moves between the pool buffers.
+extern uint8_t *imgBuf;
 #if EPD_BPP >= 2
 extern uint8_t colorBuf[];
 extern bool useColorBuf;
 #endif
 
 // ── Refresh strategy ─────────────────────────────────────────
-static const int FULL_REFRESH_INTERVAL = 10;  // Full refresh every N updates to clear ghosting
+// Ghosting budget in per-mille-of-screen units: a fast refresh of a fully
+// changed screen costs ~1100, a 5% partial update ~100 (more when cold).
+static const int GHOST_BUDGET         = 3000;
+static const int GHOST_FAST_BASE      = 100;  // fast refresh drives every pixel
+static const int GHOST_MAX_CYCLES     = 60;   // full refresh at least this often
+static const int PARTIAL_MAX_AREA_PCT = 35;   // changed area above this -> fast full refresh
+static const int EPD_TEMP_SAMPLE_S    = 1800; // panel temperature reading reused this long
+
+// Dirty-rectangle partial refresh between full refreshes. Off for the color
+// panels (no partial waveform) and GYE042A87 (fast refresh unsupported).
+#ifndef EPD_PARTIAL_RECTS
+#if defined(EPD_PANEL_42_DKE_RY683) || defined(EPD_PANEL_42_GDEM042F52) || defined(EPD_PANEL_42_GXEPD2_GYE042A87)
+#define EPD_PARTIAL_RECTS 0
+#else
+#define EPD_PARTIAL_RECTS 1
+#endif
+#endif
+
+// ── Power manager (power_manager.h) ─────────────────────────
+// Battery thresholds in mV, sampled with the radio off. Below LOW the refresh
+// interval is stretched, live mode, focus polling and periodic heartbeats are
+// dropped and partial refreshes get a larger ghosting budget; below CRITICAL
+// config-flag fetches and boot heartbeats are skipped too and content frames
+// carry a LOW BATTERY badge. A runtime estimate under the matching hours
+// lowers the tier as well.
+#ifndef POWER_LOW_MV
+#define POWER_LOW_MV 3550
+#endif
+#ifndef POWER_CRITICAL_MV
+#define POWER_CRITICAL_MV 3400
+#endif
+static const int POWER_EMPTY_MV       = 3300;  // runtime estimate runs down to this
+static const int POWER_NO_BATTERY_MV  = 2500;  // readings below: no battery sense, tier stays normal
+static const int POWER_HYSTERESIS_MV  = 50;    // to leave a tier the voltage must recover this much
+static const int POWER_LOW_HOURS      = 72;
+static const int POWER_CRITICAL_HOURS = 24;
+static const int POWER_LOW_STRETCH    = 2;     // refresh interval multiplier
+static const int POWER_CRITICAL_STRETCH = 4;
+static const int POWER_GHOST_BUDGET_PCT = 200; // ghosting budget below normal
+static const unsigned long POWER_SAMPLE_MS = 10UL * 60UL * 1000UL;  // resample while awake
+static const uint32_t POWER_LOG_PERIOD_S = 4UL * 3600UL;  // one history point per period
 
 // ── Config defaults ─────────────────────────────────────────
 static const char *DEFAULT_SERVER  = "";  // Must be set via captive portal
 static const int   WIFI_TIMEOUT    = 15000;   // ms
 static const int   HTTP_TIMEOUT    = 30000;   // ms
+static const int   HTTP_KEEPALIVE_IDLE_MS = 4000; // reconnect instead of reusing a socket idle this long
+static const int   HTTP_DRAIN_MAX  = 1024;    // unread response bodies up to this size are drained for reuse
+static const int   CONFIG_JSON_MAX = 2048;    // user config JSON accepted by the portal
+static const int   REQ_URL_MAX     = 384;     // request URL buffer (server URL is at most 200)
+static const int   REQ_BODY_MAX    = CONFIG_JSON_MAX + 64;  // request body buffer (config JSON + mac)
+static const int   WIFI_FAST_TIMEOUT  = 3000; // ms, direct join with cached BSSID/channel/IP
+static const int   WIFI_FAST_JOIN_MAX = 48;   // fast joins before a DHCP round renews the lease
 static const int   CFG_BTN_HOLD_MS = 2000;    // Long press duration to trigger config mode
 static const int   SHORT_PRESS_MIN_MS = 50;   // Minimum short press duration (debounce)
+static const int   BTN_SAMPLE_MS = 10;        // Config button sampling period (TASK_RUNTIME)
 static const int   LIVE_POLL_MS = 5000;       // Poll interval for pending remote actions
 static const int   LIVE_WIFI_RETRY_MS = 5000; // Retry interval when WiFi is disconnected
+static const int   PUSH_HOLD_S = 25;          // Live-mode long-poll hold time on the backend
+static const int   PUSH_READ_TIMEOUT_MS = 5000;
+static const int   PREFETCH_SLACK_S = 60;     // a queued frame may be shown this much early
+static const unsigned long PUSH_RETRY_MS = 60000UL; // Poll /state this long after the push channel fails
 static const unsigned long HEARTBEAT_INTERVAL_MS = 10UL * 60UL * 1000UL;
 static const int   MAX_RETRY_COUNT = 5;       // Max retries before deep sleep
+static const int   DEEP_SLEEP_MIN_S = 5;      // shortest timer sleep
+static const unsigned long BOOT_AWAKE_MS = 30000UL; // after a reset or button wake, stay awake this long for a click
 // Progressive retry delays in seconds: 5s, 15s, 30s, 60s, 120s
 static const int   RETRY_DELAYS[] = {5, 15, 30, 60, 120};
 
@@ -0,0 +1,199 @@
+#include "dirty_rect.h"
+
+// Bounding box in tile coordinates (inclusive)
+struct TileBox {
+    int c0, r0, c1, r1;
+};
+
+static int boxArea(const TileBox &b) {
+    return (b.c1 - b.c0 + 1) * (b.r1 - b.r0 + 1);
+}
+
+static TileBox boxUnion(const TileBox &a, const TileBox &b) {
+    TileBox u;
+    u.c0 = min(a.c0, b.c0);
+    u.r0 = min(a.r0, b.r0);
+    u.c1 = max(a.c1, b.c1);
+    u.r1 = max(a.r1, b.r1);
+    return u;
+}
+
+static bool boxOverlap(const TileBox &a, const TileBox &b) {
+    return a.c0 <= b.c1 && b.c0 <= a.c1 && a.r0 <= b.r1 && b.r0 <= a.r1;
+}
+
+// Merge box j into i and drop j (order is not preserved)
+static void mergeBoxes(TileBox *boxes, int *count, int i, int j) {
+    boxes[i] = boxUnion(boxes[i], boxes[j]);
+    boxes[j] = boxes[*count - 1];
+    (*count)--;
+}
+
+static void foldOverlaps(TileBox *boxes, int *count) {
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (int i = 0; i < *count && !merged; i++) {
+            for (int j = i + 1; j < *count; j++) {
+                if (boxOverlap(boxes[i], boxes[j])) {
+                    mergeBoxes(boxes, count, i, j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+int dirtyRectsFromTiles(const FrameHash &prev, const FrameHash &next,
+                        DirtyRect *out, int maxRects, long *area) {
+    *area = 0;
+    if (maxRects <= 0) return 0;
+
+    bool dirty[TILE_COUNT];
+    bool seen[TILE_COUNT];
+    int dirtyCount = 0;
+    for (int i = 0; i < TILE_COUNT; i++) {
+        dirty[i] = prev.tiles[i] != next.tiles[i];
+        seen[i] = false;
+        if (dirty[i]) dirtyCount++;
+    }
+    if (dirtyCount == 0) return 0;
+
+    // Connected regions (8-neighbourhood) -> bounding boxes
+    TileBox boxes[TILE_COUNT];
+    int boxCount = 0;
+    int stack[TILE_COUNT];
+    for (int start = 0; start < TILE_COUNT; start++) {
+        if (!dirty[start] || seen[start]) continue;
+        TileBox b = {start % TILE_COLS, start / TILE_COLS, start % TILE_COLS, start / TILE_COLS};
+        int sp = 0;
+        stack[sp++] = start;
+        seen[start] = true;
+        while (sp > 0) {
+            int t = stack[--sp];
+            int c = t % TILE_COLS;
+            int r = t / TILE_COLS;
+            b.c0 = min(b.c0, c);
+            b.c1 = max(b.c1, c);
+            b.r0 = min(b.r0, r);
+            b.r1 = max(b.r1, r);
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    int nc = c + dc;
+                    int nr = r + dr;
+                    if (nc < 0 || nc >= TILE_COLS || nr < 0 || nr >= TILE_ROWS) continue;
+                    int n = nr * TILE_COLS + nc;
+                    if (!dirty[n] || seen[n]) continue;
+                    seen[n] = true;
+                    stack[sp++] = n;
+                }
+            }
+        }
+        boxes[boxCount++] = b;
+    }
+
+    // Bounding boxes of separate regions may still overlap; fold those first
+    foldOverlaps(boxes, &boxCount);
+
+    // Then merge the pair that adds the fewest clean tiles until few enough remain
+    while (boxCount > maxRects) {
+        int bestI = 0, bestJ = 1;
+        int bestCost = TILE_COUNT + 1;
+        for (int i = 0; i < boxCount; i++) {
+            for (int j = i + 1; j < boxCount; j++) {
+                int cost = boxArea(boxUnion(boxes[i], boxes[j])) - boxArea(boxes[i]) - boxArea(boxes[j]);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestI = i;
+                    bestJ = j;
+                }
+            }
+        }
+        mergeBoxes(boxes, &boxCount, bestI, bestJ);
+        foldOverlaps(boxes, &boxCount);  // a grown box can swallow a neighbour
+    }
+
+    // Tile coordinates -> byte-aligned pixel rectangles
+    int tileW = tileByteWidth(next.rowBytes) * 8;
+    int tileH = tileHeight(next.rows);
+    int frameW = next.rowBytes * 8;
+    for (int i = 0; i < boxCount; i++) {
+        DirtyRect &r = out[i];
+        r.x0 = boxes[i].c0 * tileW;
+        r.y0 = boxes[i].r0 * tileH;
+        r.x1 = min(frameW, (boxes[i].c1 + 1) * tileW);
+        r.y1 = min(next.rows, (boxes[i].r1 + 1) * tileH);
+        *area += (long)(r.x1 - r.x0) * (r.y1 - r.y0);
+    }
+    return boxCount;
+}
+
+// ── Pixel rectangles (frame patches) ────────────────────────
+
+static long rectArea(const DirtyRect &r) {
+    return (long)(r.x1 - r.x0) * (r.y1 - r.y0);
+}
+
+static DirtyRect rectUnion(const DirtyRect &a, const DirtyRect &b) {
+    DirtyRect u;
+    u.x0 = min(a.x0, b.x0);
+    u.y0 = min(a.y0, b.y0);
+    u.x1 = max(a.x1, b.x1);
+    u.y1 = max(a.y1, b.y1);
+    return u;
+}
+
+static bool rectOverlap(const DirtyRect &a, const DirtyRect &b) {
+    return a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+}
+
+static void mergeRects(DirtyRect *rects, int *count, int i, int j) {
+    rects[i] = rectUnion(rects[i], rects[j]);
+    rects[j] = rects[*count - 1];
+    (*count)--;
+}
+
+static void foldRectOverlaps(DirtyRect *rects, int *count) {
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (int i = 0; i < *count && !merged; i++) {
+            for (int j = i + 1; j < *count; j++) {
+                if (rectOverlap(rects[i], rects[j])) {
+                    mergeRects(rects, count, i, j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+int dirtyRectsAdd(DirtyRect *rects, int count, int maxRects, const DirtyRect &r) {
+    rects[count++] = r;
+    foldRectOverlaps(rects, &count);
+    while (count > maxRects) {
+        int bestI = 0, bestJ = 1;
+        long bestCost = -1;
+        for (int i = 0; i < count; i++) {
+            for (int j = i + 1; j < count; j++) {
+                long cost = rectArea(rectUnion(rects[i], rects[j])) - rectArea(rects[i]) - rectArea(rects[j]);
+                if (bestCost < 0 || cost < bestCost) {
+                    bestCost = cost;
+                    bestI = i;
+                    bestJ = j;
+                }
+            }
+        }
+        mergeRects(rects, &count, bestI, bestJ);
+        foldRectOverlaps(rects, &count);
+    }
+    return count;
+}
+
+long dirtyRectsArea(const DirtyRect *rects, int count) {
+    long area = 0;
+    for (int i = 0; i < count; i++) area += rectArea(rects[i]);
+    return area;
+}
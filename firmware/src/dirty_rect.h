@@ -0,0 +1,32 @@
+#ifndef INKSIGHT_DIRTY_RECT_H
+#define INKSIGHT_DIRTY_RECT_H
+
+#include <Arduino.h>
+#include "frame_hash.h"
+
+// ── Dirty rectangles from tile hashes ───────────────────────
+// Tiles whose hashes differ between the frame on the panel and the next frame
+// are grouped into connected regions, and their bounding boxes are merged
+// until at most maxRects remain. Rectangles are in panel pixels with x0/x1
+// on byte boundaries and exclusive ends, clipped to the frame.
+
+struct DirtyRect {
+    int x0, y0, x1, y1;
+};
+
+static const int DIRTY_MAX_RECTS = 4;
+
+// Returns the rectangle count (0 = frames identical). *area receives the
+// summed rectangle area in pixels. Both hashes must share the same geometry.
+int dirtyRectsFromTiles(const FrameHash &prev, const FrameHash &next,
+                        DirtyRect *out, int maxRects, long *area);
+
+// Add r to a list of count rectangles (room for maxRects + 1), merging
+// overlaps and then the cheapest pairs until at most maxRects remain.
+// Returns the new count.
+int dirtyRectsAdd(DirtyRect *rects, int count, int maxRects, const DirtyRect &r);
+
+// Summed area of the rectangles in pixels
+long dirtyRectsArea(const DirtyRect *rects, int count);
+
+#endif // INKSIGHT_DIRTY_RECT_H
@@ -1,136 +1,17 @@
 #include "display.h"
 #include "config.h"
 #include "epd_driver.h"
-
-// ── Unified 5x7 pixel font ─────────────────────────────────
-// Each glyph is 5 columns x 7 rows, stored column-major.
-// Bit 0 = top row, bit 6 = bottom row.
-
-const uint8_t* getGlyph(char c) {
-    // Uppercase letters
-    static const uint8_t g_A[] = {0x7E,0x11,0x11,0x11,0x7E};
-    static const uint8_t g_B[] = {0x7F,0x49,0x49,0x49,0x36};
-    static const uint8_t g_C[] = {0x3E,0x41,0x41,0x41,0x22};
-    static const uint8_t g_D[] = {0x7F,0x41,0x41,0x22,0x1C};
-    static const uint8_t g_E[] = {0x7F,0x49,0x49,0x49,0x41};
-    static const uint8_t g_F[] = {0x7F,0x09,0x09,0x09,0x01};
-    static const uint8_t g_G[] = {0x3E,0x41,0x49,0x49,0x3A};
-    static const uint8_t g_H[] = {0x7F,0x08,0x08,0x08,0x7F};
-    static const uint8_t g_I[] = {0x00,0x41,0x7F,0x41,0x00};
-    static const uint8_t g_K[] = {0x7F,0x08,0x14,0x22,0x41};
-    static const uint8_t g_L[] = {0x7F,0x40,0x40,0x40,0x40};
-    static const uint8_t g_M[] = {0x7F,0x02,0x0C,0x02,0x7F};
-    static const uint8_t g_N[] = {0x7F,0x04,0x08,0x10,0x7F};
-    static const uint8_t g_O[] = {0x3E,0x41,0x41,0x41,0x3E};
-    static const uint8_t g_P[] = {0x7F,0x09,0x09,0x09,0x06};
-    static const uint8_t g_R[] = {0x7F,0x09,0x19,0x29,0x46};
-    static const uint8_t g_S[] = {0x26,0x49,0x49,0x49,0x32};
-    static const uint8_t g_T[] = {0x01,0x01,0x7F,0x01,0x01};
-    static const uint8_t g_U[] = {0x3F,0x40,0x40,0x40,0x3F};
-    static const uint8_t g_V[] = {0x1F,0x20,0x40,0x20,0x1F};
-    static const uint8_t g_W[] = {0x3F,0x40,0x38,0x40,0x3F};
-    static const uint8_t g_X[] = {0x63,0x14,0x08,0x14,0x63};
-    static const uint8_t g_Y[] = {0x07,0x08,0x70,0x08,0x07};
-    static const uint8_t g_Z[] = {0x61,0x51,0x49,0x45,0x43};
-
-    // Lowercase letters
-    static const uint8_t g_a[] = {0x20,0x54,0x54,0x54,0x78};
-    static const uint8_t g_b[] = {0x7F,0x48,0x44,0x44,0x38};
-    static const uint8_t g_c[] = {0x38,0x44,0x44,0x44,0x28};
-    static const uint8_t g_d[] = {0x38,0x44,0x44,0x28,0x7F};
-    static const uint8_t g_e[] = {0x38,0x54,0x54,0x54,0x18};
-    static const uint8_t g_f[] = {0x00,0x08,0x7E,0x09,0x02};
-    static const uint8_t g_g[] = {0x18,0xA4,0xA4,0xA4,0x7C};
-    static const uint8_t g_h[] = {0x7F,0x08,0x04,0x04,0x78};
-    static const uint8_t g_i[] = {0x00,0x44,0x7D,0x40,0x00};
-    static const uint8_t g_k[] = {0x7F,0x10,0x28,0x44,0x00};
-    static const uint8_t g_l[] = {0x00,0x41,0x7F,0x40,0x00};
-    static const uint8_t g_m[] = {0x7C,0x04,0x18,0x04,0x78};
-    static const uint8_t g_n[] = {0x7C,0x08,0x04,0x04,0x78};
-    static const uint8_t g_o[] = {0x38,0x44,0x44,0x44,0x38};
-    static const uint8_t g_p[] = {0x7C,0x14,0x14,0x14,0x08};
-    static const uint8_t g_r[] = {0x7C,0x08,0x04,0x04,0x08};
-    static const uint8_t g_s[] = {0x48,0x54,0x54,0x54,0x24};
-    static const uint8_t g_t[] = {0x04,0x3F,0x44,0x40,0x20};
-    static const uint8_t g_u[] = {0x3C,0x40,0x40,0x20,0x7C};
-    static const uint8_t g_v[] = {0x1C,0x20,0x40,0x20,0x1C};
-    static const uint8_t g_w[] = {0x3C,0x40,0x30,0x40,0x3C};
-
-    // Digits 0-9
-    static const uint8_t g_0[] = {0x3E,0x51,0x49,0x45,0x3E};
-    static const uint8_t g_1[] = {0x00,0x42,0x7F,0x40,0x00};
-    static const uint8_t g_2[] = {0x42,0x61,0x51,0x49,0x46};
-    static const uint8_t g_3[] = {0x21,0x41,0x45,0x4B,0x31};
-    static const uint8_t g_4[] = {0x18,0x14,0x12,0x7F,0x10};
-    static const uint8_t g_5[] = {0x27,0x45,0x45,0x45,0x39};
-    static const uint8_t g_6[] = {0x3C,0x4A,0x49,0x49,0x30};
-    static const uint8_t g_7[] = {0x01,0x71,0x09,0x05,0x03};
-    static const uint8_t g_8[] = {0x36,0x49,0x49,0x49,0x36};
-    static const uint8_t g_9[] = {0x06,0x49,0x49,0x29,0x1E};
-
-    // Special characters
-    static const uint8_t g_colon[] = {0x00,0x00,0x36,0x36,0x00};
-    static const uint8_t g_dash[]  = {0x08,0x08,0x08,0x08,0x08};
-    static const uint8_t g_dot[]   = {0x00,0x60,0x60,0x00,0x00};
-    static const uint8_t g_slash[] = {0x20,0x10,0x08,0x04,0x02};
-    static const uint8_t g_exclam[]= {0x00,0x00,0x5F,0x00,0x00};
-    static const uint8_t g_space[] = {0x00,0x00,0x00,0x00,0x00};
-
-    switch (c) {
-        // Uppercase
-        case 'A': return g_A; case 'B': return g_B; case 'C': return g_C;
-        case 'D': return g_D; case 'E': return g_E; case 'F': return g_F;
-        case 'G': return g_G; case 'H': return g_H; case 'I': return g_I;
-        case 'K': return g_K; case 'L': return g_L; case 'M': return g_M;
-        case 'N': return g_N; case 'O': return g_O; case 'P': return g_P;
-        case 'R': return g_R; case 'S': return g_S; case 'T': return g_T;
-        case 'U': return g_U; case 'V': return g_V; case 'W': return g_W;
-        case 'X': return g_X; case 'Y': return g_Y; case 'Z': return g_Z;
-        // Lowercase
-        case 'a': return g_a; case 'b': return g_b; case 'c': return g_c;
-        case 'd': return g_d; case 'e': return g_e; case 'f': return g_f;
-        case 'g': return g_g; case 'h': return g_h; case 'i': return g_i;
-        case 'k': return g_k; case 'l': return g_l; case 'm': return g_m;
-        case 'n': return g_n; case 'o': return g_o; case 'p': return g_p;
-        case 'r': return g_r; case 's': return g_s; case 't': return g_t;
-        case 'u': return g_u; case 'v': return g_v; case 'w': return g_w;
-        // Digits
-        case '0': return g_0; case '1': return g_1; case '2': return g_2;
-        case '3': return g_3; case '4': return g_4; case '5': return g_5;
-        case '6': return g_6; case '7': return g_7; case '8': return g_8;
-        case '9': return g_9;
-        // Special
-        case ':': return g_colon; case '-': return g_dash;
-        case '.': return g_dot;   case '/': return g_slash;
-        case '!': return g_exclam;
-        default:  return g_space;
-    }
-}
+#include "dirty_rect.h"
+#include "frame_hash.h"
+#include "ghost_budget.h"
+#include "frame_pipeline.h"
+#include "offline_cache.h"
 
 // ── Draw scaled text into imgBuf ────────────────────────────
 
 void drawText(const char *msg, int x, int y, int scale) {
-    int rowBytes = W / 8;
-    int len = strlen(msg);
-
-    for (int ci = 0; ci < len; ci++) {
-        const uint8_t *glyph = getGlyph(msg[ci]);
-        int cx = x + ci * (5 * scale + scale);
-        for (int col = 0; col < 5; col++) {
-            for (int row = 0; row < 7; row++) {
-                if (glyph[col] & (1 << row)) {
-                    for (int dy = 0; dy < scale; dy++) {
-                        for (int dx = 0; dx < scale; dx++) {
-                            int px = cx + col * scale + dx;
-                            int py = y + row * scale + dy;
-                            if (px >= 0 && px < W && py >= 0 && py < H)
-                                imgBuf[py * rowBytes + px / 8] &= ~(0x80 >> (px % 8));
-                        }
-                    }
-                }
-            }
-        }
-    }
+    displayFlush();
+    drawTextInto(imgBuf, W, H, msg, x, y, scale);
 }
 
 // ── Helper: calculate text width in pixels ──────────────────
@@ -140,19 +21,13 @@ static int textWidth(int charCount, int scale) {
 }
 
 static void fillRect(int x, int y, int w, int h) {
-    int rowBytes = W / 8;
-    for (int py = y; py < y + h; py++) {
-        if (py < 0 || py >= H) continue;
-        for (int px = x; px < x + w; px++) {
-            if (px < 0 || px >= W) continue;
-            imgBuf[py * rowBytes + px / 8] &= ~(0x80 >> (px % 8));
-        }
-    }
+    fillRectInto(imgBuf, W, H, x, y, w, h);
 }
 
 // ── Show WiFi setup screen ──────────────────────────────────
 
 void showSetupScreen(const char *apName) {
+    displayFlush();
     memset(imgBuf, 0xFF, IMG_BUF_LEN);
 
     fillRect(0, 0, W, H * 12 / 100);
@@ -188,6 +63,7 @@ void showSetupScreen(const char *apName) {
 // ── Show diagnostic screen ──────────────────────────────────
 
 void showDiagnostic(const char *line1, const char *line2, const char *line3, const char *line4) {
+    displayFlush();
     memset(imgBuf, 0xFF, IMG_BUF_LEN);
 
     int titleScale = (H < 200) ? 2 : 3;
@@ -223,6 +99,7 @@ void showDiagnostic(const char *line1, const char *line2, const char *line3, con
 // ── Show centered error message ─────────────────────────────
 
 void showError(const char *msg) {
+    displayFlush();
     memset(imgBuf, 0xFF, IMG_BUF_LEN);
 
     int scale = (H < 200) ? 1 : 2;
@@ -320,21 +197,6 @@ static void periodGlyphs(int period, const uint16_t **left, const uint16_t **rig
     }
 }
 
-static void drawGlyph16(uint8_t *buffer, int width, int height, int x, int y, const uint16_t *glyph) {
-    int rowBytes = (width + 7) / 8;
-    for (int row = 0; row < 16; row++) {
-        int py = y + row;
-        if (py < 0 || py >= height) continue;
-        uint16_t bits = glyph[row];
-        for (int col = 0; col < 16; col++) {
-            if ((bits & (1 << (15 - col))) == 0) continue;
-            int px = x + col;
-            if (px < 0 || px >= width) continue;
-            buffer[py * rowBytes + px / 8] &= ~(0x80 >> (px % 8));
-        }
-    }
-}
-
 static void drawPeriodLabel(
     uint8_t *buffer,
     int bufferWidth,
@@ -360,7 +222,56 @@ static void drawPeriodLabel(
     drawGlyph16(buffer, bufferWidth, bufferHeight, startX + glyphW + gap, startY, right);
 }
 
+// ── Panel content tracking (dirty-rectangle refresh) ────────
+// Tile hashes of what the panel shows. Any refresh outside smartDisplay()
+// (error screens, alerts, previews) bumps the driver generation and
+// invalidates them, forcing the next update to a full-screen refresh. They
+// live in RTC memory: the panel keeps its frame through deep sleep, and the
+// controller RAM is restored from the offline store before a partial refresh.
+
+static RTC_DATA_ATTR FrameHash panelHash;
+static RTC_DATA_ATTR bool panelHashValid = false;
+static RTC_DATA_ATTR uint32_t panelGeneration = 0;
+
+static void rememberPanel(const FrameHash &h) {
+    panelHash = h;
+    panelHashValid = true;
+    panelGeneration = epdRefreshGeneration();
+}
+
+static bool panelKnown() {
+    return panelHashValid && panelGeneration == epdRefreshGeneration();
+}
+
+static void restoreRow(const uint8_t *row, void *) {
+    epdRamRestoreRow(row);
+}
+
+// Put the shown frame back into controller RAM after a wake (no refresh)
+static bool panelRamReady() {
+    if (epdRamValid()) return true;
+    if (!panelKnown() || !epdRamRestoreBegin()) return false;
+    unsigned long t0 = millis();
+    bool ok = cacheReadRows(panelHash.frame, restoreRow, nullptr);
+    epdRamRestoreEnd(ok);
+    if (ok) Serial.printf("[PANEL] RAM restored from the offline store, %lums\n", millis() - t0);
+    else    Serial.println("[PANEL] shown frame not stored, no partial refresh");
+    return ok;
+}
+
+void displaySuspend() {
+#if EPD_PARTIAL_RECTS && defined(EPD_PANEL_42_SSD1683_BW)
+    displayFlush();
+    if (!panelKnown()) return;
+    // imgBuf no longer matches after an overlay was replaced (batch fetch)
+    FrameHash h;
+    frameHashCompute(&h, imgBuf, ROW_BYTES, H);
+    if (h.frame == panelHash.frame) cacheSavePanel(imgBuf, IMG_BUF_LEN, h.frame);
+#endif
+}
+
 void updateTimeDisplay() {
+    displayFlush();
     int rgnPixelW = TIME_RGN_X1 - TIME_RGN_X0;
     int rgnW = rgnPixelW / 8;
     int rgnH = TIME_RGN_Y1 - TIME_RGN_Y0;
@@ -368,12 +279,42 @@ void updateTimeDisplay() {
     uint8_t partBuf[rgnW * rgnH];
     memset(partBuf, 0xFF, sizeof(partBuf));
     drawPeriodLabel(partBuf, rgnPixelW, rgnH, 0, 0, rgnPixelW, rgnH);
+    if (!panelRamReady()) {
+        smartDisplay(imgBuf);  // no RAM to diff against: refresh the whole frame
+        return;
+    }
+    bool known = panelKnown();
     epdPartialDisplay(partBuf, TIME_RGN_X0, TIME_RGN_Y0, TIME_RGN_X1, TIME_RGN_Y1);
+    if (known) {
+        FrameHash h;
+        frameHashCompute(&h, imgBuf, ROW_BYTES, H);
+        rememberPanel(h);
+    }
+}
+
+void drawTimeLabel() {
+    displayFlush();
+    int rgnPixelW = TIME_RGN_X1 - TIME_RGN_X0;
+    int rgnH = TIME_RGN_Y1 - TIME_RGN_Y0;
+    for (int y = TIME_RGN_Y0; y < TIME_RGN_Y1; y++) {
+        memset(imgBuf + y * ROW_BYTES + TIME_RGN_X0 / 8, 0xFF, rgnPixelW / 8);
+    }
+    drawPeriodLabel(imgBuf, W, H, TIME_RGN_X0, TIME_RGN_Y0, rgnPixelW, rgnH);
+}
+
+int secondsToNextPeriod() {
+    static const int starts[] = {2, 5, 8, 12, 14, 18, 20, 23};
+    int now = curHour * 3600 + curMin * 60 + curSec;
+    for (int h : starts) {
+        if (h * 3600 > now) return h * 3600 - now;
+    }
+    return 24 * 3600 + starts[0] * 3600 - now;
 }
 
 // ── Mode preview screen (double-click transition) ───────────
 
 void showModePreview(const char *modeName) {
+    displayFlush();
     memset(imgBuf, 0xFF, IMG_BUF_LEN);
 
     int nameScale = (H < 200) ? 2 : 3;
@@ -394,28 +335,243 @@ void showModePreview(const char *modeName) {
     Serial.printf("Mode preview shown: %s\n", modeName);
 }
 
-static int refreshCount = 0;
+// ── Streamed display ────────────────────────────────────────
+// The panel is initialized lazily: while every finished tile band of the
+// incoming frame matches what the panel shows, rows are only hashed. The
+// first band that differs opens the panel stream and replays the rows received
+// so far from imgBuf, so unchanged and deduplicated frames never pay for a
+// panel init.
+
+static bool streamOpen = false;
+static bool streamPending = false;  // begun, panel not initialized yet
+static bool streamPrimed = false;
+static bool streamFast = false;
+static bool streamBottomUp = true;
+static int streamRows = 0;
+static FrameHash streamTiles;
+static uint32_t streamHash = 0;
+static unsigned long streamBeginAt = 0;
+static unsigned long streamInitMs = 0;
+static unsigned long streamRamUs = 0;
+
+static uint32_t streamHashRow(uint32_t h, const uint8_t *row) {
+    for (int i = 0; i < ROW_BYTES; i++) {
+        h = (h ^ row[i]) * 16777619u;  // FNV-1a
+    }
+    return h;
+}
+
+// Hash imgBuf in the row order it was streamed in.
+static uint32_t streamHashFrame(const uint8_t *image) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < H; i++) {
+        int y = streamBottomUp ? H - 1 - i : i;
+        h = streamHashRow(h, image + y * ROW_BYTES);
+    }
+    return h;
+}
+
+static int streamRowY(int i) {
+    return streamBottomUp ? H - 1 - i : i;
+}
+
+static bool streamBandMatchesPanel(int band) {
+    const uint32_t *next = streamTiles.tiles + band * TILE_COLS;
+    const uint32_t *shown = panelHash.tiles + band * TILE_COLS;
+    return memcmp(next, shown, TILE_COLS * sizeof(uint32_t)) == 0;
+}
+
+static void streamOpenPanel() {
+    streamPending = false;
+    streamFast = !ghostFullRefreshDue();
+    unsigned long t0 = millis();
+    if (!epdStreamBegin(streamFast, streamBottomUp)) return;
+    streamInitMs = millis() - t0;
+    streamOpen = true;
+    t0 = micros();
+    for (int i = 0; i < streamRows; i++) {
+        epdStreamRow(imgBuf + streamRowY(i) * ROW_BYTES);
+    }
+    streamRamUs += micros() - t0;
+}
+
+bool displayStreamBegin(bool bottomUp) {
+    displayFlush();
+    streamOpen = false;
+    streamPending = false;
+    streamPrimed = false;
+#if EPD_STREAM_DISPLAY
+    streamBottomUp = bottomUp;
+    streamBeginAt = millis();
+    streamInitMs = 0;
+    streamRamUs = 0;
+    streamRows = 0;
+    streamHash = 2166136261u;
+    frameHashBegin(&streamTiles, ROW_BYTES, H);
+    streamPending = true;
+    if (!panelKnown()) streamOpenPanel();
+    return streamPending || streamOpen;
+#else
+    (void)bottomUp;
+    return false;
+#endif
+}
+
+void displayStreamRow(const uint8_t *row) {
+    if (streamPending) {
+        int y = streamRowY(streamRows++);
+        streamHash = streamHashRow(streamHash, row);
+        frameHashRow(&streamTiles, y, row);
+        int th = tileHeight(H);
+        bool bandDone = streamBottomUp ? (y % th == 0) : ((y + 1) % th == 0 || y == H - 1);
+        if (bandDone && !streamBandMatchesPanel(y / th)) streamOpenPanel();
+        return;
+    }
+    if (!streamOpen) return;
+    unsigned long t0 = micros();
+    epdStreamRow(row);
+    streamRamUs += micros() - t0;
+    streamHash = streamHashRow(streamHash, row);
+}
+
+void displayStreamEnd(bool ok) {
+    if (streamPending) {
+        streamPending = false;
+        if (ok) Serial.println("[STREAM] frame matches the panel, no panel init");
+        return;
+    }
+    if (!streamOpen) return;
+    streamOpen = false;
+    if (!ok) {
+        epdStreamCancel();
+        return;
+    }
+    epdStreamEnd();
+    streamPrimed = true;
+}
+
+// Rectangles of the last frame patch (displayPatchHint)
+static struct {
+    uint32_t base, result;
+    DirtyRect rects[DIRTY_MAX_RECTS];
+    int count;  // -1 = none
+} patchHint = {0, 0, {}, -1};
+
+void displayPatchHint(uint32_t baseFrame, uint32_t resultFrame, const DirtyRect *rects, int count) {
+    patchHint.base = baseFrame;
+    patchHint.result = resultFrame;
+    patchHint.count = min(count, DIRTY_MAX_RECTS);
+    memcpy(patchHint.rects, rects, patchHint.count * sizeof(DirtyRect));
+}
+
+// Refresh only the tiles that differ from the panel. rectCount < 0 means the
+// panel content is unknown. Returns false when a full-screen refresh is needed.
+static bool partialRefresh(const uint8_t *image, const DirtyRect *rects, int rectCount, int changed) {
+#if EPD_PARTIAL_RECTS
+    if (rectCount < 0) return false;
+    if (changed > PARTIAL_MAX_AREA_PCT * 10) {
+        Serial.printf("smartDisplay: %d%% changed, above partial limit\n", changed / 10);
+        return false;
+    }
+    if (streamPrimed) {
+        streamPrimed = false;
+        epdStreamCancel();
+    }
+    if (rectCount == 0) {
+        Serial.println("smartDisplay: frame matches panel, no refresh");
+        return true;
+    }
+    if (!panelRamReady()) return false;
+    Serial.printf("smartDisplay: partial refresh, %d rect(s), %d%% of screen (ghost %d/%d)\n",
+                  rectCount, changed / 10, ghostDebt(), GHOST_BUDGET);
+    unsigned long t0 = millis();
+    epdPartialDisplayRects(image, rects, rectCount);
+    Serial.printf("[PARTIAL] %lums\n", millis() - t0);
+    ghostCharge(REFRESH_PARTIAL, changed);
+    return true;
+#else
+    (void)image;
+    (void)rects;
+    (void)rectCount;
+    (void)changed;
+    return false;
+#endif
+}
 
 void smartDisplay(const uint8_t *image) {
+    displayFlush();
 #if EPD_BPP >= 2
     if (useColorBuf) {
-        Serial.printf("smartDisplay: 2bpp color (cycle %d)\n", refreshCount);
+        Serial.println("smartDisplay: 2bpp color");
         epdDisplay2bpp(colorBuf);
         useColorBuf = false;
-        refreshCount++;
+        panelHashValid = false;
+        ghostCharge(REFRESH_FULL, 1000);
+        return;
+    }
+#endif
+    FrameHash next;
+    frameHashCompute(&next, image, ROW_BYTES, H);
+
+    // Share of the screen that changed (per mille); unknown content counts as all
+    DirtyRect rects[DIRTY_MAX_RECTS];
+    int rectCount = -1;
+    int changed = 1000;
+    if (panelKnown()) {
+        long area = 0;
+        if (patchHint.count >= 0 && patchHint.base == panelHash.frame && patchHint.result == next.frame) {
+            // The patch rectangles are tighter than the tiles they touch
+            rectCount = patchHint.count;
+            memcpy(rects, patchHint.rects, rectCount * sizeof(DirtyRect));
+            area = dirtyRectsArea(rects, rectCount);
+        } else {
+            rectCount = dirtyRectsFromTiles(panelHash, next, rects, DIRTY_MAX_RECTS, &area);
+        }
+        changed = (int)(area * 1000 / ((long)W * H));
+    }
+    patchHint.count = -1;
+
+    bool fullDue = ghostFullRefreshDue();
+    if (!fullDue && partialRefresh(image, rects, rectCount, changed)) {
+        rememberPanel(next);
         return;
     }
+
+#if defined(EPD_PANEL_42_GXEPD2_GYE042A87) || defined(EPD_PANEL_42_DKE_RY683)
+    const RefreshKind fastKind = REFRESH_FULL;  // fast path falls back to a full refresh
+#else
+    const RefreshKind fastKind = REFRESH_FAST;
 #endif
-    if (refreshCount % FULL_REFRESH_INTERVAL == 0) {
-        Serial.printf("smartDisplay: full refresh (cycle %d)\n", refreshCount);
+
+    if (streamPrimed) {
+        streamPrimed = false;
+        if (streamHashFrame(image) == streamHash) {
+            Serial.printf("smartDisplay: streamed %s refresh (ghost %d/%d)\n",
+                          streamFast ? "fast" : "full", ghostDebt(), GHOST_BUDGET);
+            epdStreamCommit(image);
+            ghostCharge(streamFast ? fastKind : REFRESH_FULL, changed);
+            rememberPanel(next);
+            Serial.printf("[STREAM] fetch+display %lums, saved ~%lums (init %lums + RAM write %lums during download)\n",
+                          millis() - streamBeginAt, streamInitMs + streamRamUs / 1000,
+                          streamInitMs, streamRamUs / 1000);
+            return;
+        }
+        Serial.println("[STREAM] frame changed since download, full write");
+        epdStreamCancel();
+    }
+    if (fullDue) {
+        Serial.printf("smartDisplay: full refresh (ghost %d/%d, %d cycles)\n",
+                      ghostDebt(), GHOST_BUDGET, ghostCycles());
         epdDisplay(image);
+        ghostCharge(REFRESH_FULL, changed);
     } else {
 #if defined(EPD_PANEL_42_GXEPD2_GYE042A87)
-        Serial.printf("smartDisplay: full refresh fallback (cycle %d)\n", refreshCount);
+        Serial.println("smartDisplay: full refresh fallback");
 #else
-        Serial.printf("smartDisplay: fast refresh (cycle %d)\n", refreshCount);
+        Serial.printf("smartDisplay: fast refresh (ghost %d/%d)\n", ghostDebt(), GHOST_BUDGET);
 #endif
         epdDisplayFast(image);
+        ghostCharge(fastKind, changed);
     }
-    refreshCount++;
+    rememberPanel(next);
 }
@@ -2,9 +2,8 @@
 #define INKSIGHT_DISPLAY_H
 
 #include <Arduino.h>
-
-// Look up glyph data for a character (5x7 pixel font)
-const uint8_t* getGlyph(char c);
+#include "font.h"
+#include "dirty_rect.h"
 
 // Draw scaled text into imgBuf at (x, y)
 void drawText(const char *msg, int x, int y, int scale);
@@ -19,12 +18,38 @@ void showError(const char *msg);
 void showDiagnostic(const char *line1, const char *line2, const char *line3, const char *line4);
 
 int currentPeriodIndex();
+// Seconds until currentPeriodIndex() changes
+int secondsToNextPeriod();
 
 void updateTimeDisplay();
+// Draw the period label into imgBuf the way updateTimeDisplay() shows it, for
+// a refresh after deep sleep: smartDisplay() then only updates the label tiles
+void drawTimeLabel();
 
 // Smart display: uses no-flash partial refresh normally, full refresh every N cycles
+// (content frames get here through displayFrame(), on the display task)
 void smartDisplay(const uint8_t *image);
 
+// Frame patch applied by fetchBMP(): the rectangles that changed between the
+// base frame and the result. The next smartDisplay() refreshes just these
+// (instead of whole tiles) when the panel shows that base and the frame is
+// that result.
+void displayPatchHint(uint32_t baseFrame, uint32_t resultFrame, const DirtyRect *rects, int count);
+
+// Before deep sleep: keep the shown frame (imgBuf) in the offline store when
+// it is not stored yet, so the next wake can refresh partially
+void displaySuspend();
+
+// Streamed display (EPD_STREAM_DISPLAY): fetchBMP() opens a stream before the
+// first row, feeds rows of imgBuf in arrival order (bottom-up for BMP, top-down
+// for PackBits frames) and closes it. A later smartDisplay() of the same frame
+// then only runs the refresh. The panel is only initialized once a row band
+// differs from what it shows. Begin returns false when the panel or build does
+// not support streaming.
+bool displayStreamBegin(bool bottomUp);
+void displayStreamRow(const uint8_t *row);
+void displayStreamEnd(bool ok);
+
 // Show mode name preview screen (displayed briefly on double-click before loading)
 void showModePreview(const char *modeName);
 
@@ -1,10 +1,77 @@
 #include "epd_driver.h"
 #include "config.h"
+#include "pixel_ops.h"
+#include "profiler.h"
+
+// Bumped by every panel refresh so callers can tell the panel content changed.
+// Kept across deep sleep: the panel still shows the same frame after a wake.
+static RTC_DATA_ATTR uint32_t refreshGeneration = 0;
+
+uint32_t epdRefreshGeneration() {
+    return refreshGeneration;
+}
+
+// ── BUSY pin wait ───────────────────────────────────────────
+// Waits block on a BUSY edge interrupt instead of polling. With the radio
+// off the chip light-sleeps instead, woken by BUSY reaching its idle level
+// or by the config button.
+
+#include <WiFi.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+static SemaphoreHandle_t busySem = nullptr;
+
+static void IRAM_ATTR busyIsr() {
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(busySem, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+static void busyIrqAttach() {
+    if (!busySem) busySem = xSemaphoreCreateBinary();
+    xSemaphoreTake(busySem, 0);  // drop a stale edge
+    attachInterrupt(digitalPinToInterrupt(PIN_EPD_BUSY), busyIsr, CHANGE);
+}
+
+static void busyIrqDetach() {
+    detachInterrupt(digitalPinToInterrupt(PIN_EPD_BUSY));
+}
+
+// Light sleep would drop the WiFi association, so only sleep with WiFi off
+static bool busyCanLightSleep() {
+#if EPD_BUSY_LIGHT_SLEEP
+    return WiFi.getMode() == WIFI_OFF;
+#else
+    return false;
+#endif
+}
+
+static void busyLightSleep(int idleLevel, unsigned long maxMs) {
+    Serial.flush();
+    gpio_wakeup_enable((gpio_num_t)PIN_EPD_BUSY,
+                       idleLevel == HIGH ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+    gpio_wakeup_enable((gpio_num_t)PIN_CFG_BTN, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    esp_sleep_enable_timer_wakeup((uint64_t)maxMs * 1000ULL);
+    esp_light_sleep_start();
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+    gpio_wakeup_disable((gpio_num_t)PIN_EPD_BUSY);
+    gpio_wakeup_disable((gpio_num_t)PIN_CFG_BTN);
+}
 
 #if defined(EPD_PANEL_42_SSD1683_BW) || defined(EPD_PANEL_42_DKE_RY683) || defined(EPD_PANEL_42_GDEM042F52)
 
-// ── Software SPI (bit-bang) for 4.2" SSD1683 BW panels ──
-// Avoids Busy Timeout on ESP32-C3 with non-default pins; no GxEPD2 dependency.
+// ── SPI transport for 4.2" directly driven panels ──
+// Hardware SPI by default. EPD_SOFT_SPI=1 selects the bit-bang fallback, which
+// avoids Busy Timeout on ESP32-C3 with non-default pins; the C3 envs still
+// ship with it until hardware SPI is proven on their pin maps.
+// CS stays asserted for a whole data burst, so RAM writes go out back to back.
+
+#if EPD_SOFT_SPI
 
 static void spiWriteByte(uint8_t data) {
     for (int i = 0; i < 8; i++) {
@@ -15,45 +82,229 @@ static void spiWriteByte(uint8_t data) {
     }
 }
 
+static void spiWriteBytes(const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        spiWriteByte(data[i]);
+    }
+}
+
+static void spiBusBegin() {}
+static void spiBusEnd() {}
+
+#else
+#include <SPI.h>
+
+static const SPISettings epdSpiSettings(EPD_SPI_HZ, MSBFIRST, SPI_MODE0);
+
+static void spiWriteByte(uint8_t data) {
+    SPI.transfer(data);
+}
+
+static void spiWriteBytes(const uint8_t *data, size_t len) {
+    SPI.writeBytes(data, len);  // fills the 64-byte HW FIFO per transaction
+}
+
+static void spiBusBegin() { SPI.beginTransaction(epdSpiSettings); }
+static void spiBusEnd() { SPI.endTransaction(); }
+
+#endif
+
+#if defined(EPD_PANEL_42_DKE_RY683) || defined(EPD_PANEL_42_GDEM042F52)
+static const int BUSY_ACTIVE = LOW;
+static const unsigned long BUSY_TIMEOUT_MS = 45000;
+#else
+static const int BUSY_ACTIVE = HIGH;
+static const unsigned long BUSY_TIMEOUT_MS = 10000;
+#endif
+
+static bool refreshPending = false;
+
+static bool epdBusy() {
+    return digitalRead(PIN_EPD_BUSY) == BUSY_ACTIVE;
+}
+
+static void epdWaitBusy(unsigned long maxMs = 0);
+
 static void epdSendCommand(uint8_t cmd) {
+    if (refreshPending) epdRefreshWait();  // never talk to a refreshing panel
     digitalWrite(PIN_EPD_DC, LOW);   // DC low = command
     digitalWrite(PIN_EPD_CS, LOW);
+    spiBusBegin();
     spiWriteByte(cmd);
+    spiBusEnd();
     digitalWrite(PIN_EPD_CS, HIGH);
 }
 
 static void epdSendData(uint8_t data) {
     digitalWrite(PIN_EPD_DC, HIGH);  // DC high = data
     digitalWrite(PIN_EPD_CS, LOW);
+    spiBusBegin();
     spiWriteByte(data);
+    spiBusEnd();
     digitalWrite(PIN_EPD_CS, HIGH);
 }
 
-static void epdWaitBusy(unsigned long maxMs = 0) {
-    unsigned long t0 = millis();
-    unsigned long timeoutMs = maxMs > 0 ? maxMs :
-#if defined(EPD_PANEL_42_DKE_RY683) || defined(EPD_PANEL_42_GDEM042F52)
-        45000;
-#else
-        10000;
+// Data burst: CS held low from epdDataBegin() until epdDataEnd().
+static void epdDataBegin() {
+    digitalWrite(PIN_EPD_DC, HIGH);
+    digitalWrite(PIN_EPD_CS, LOW);
+    spiBusBegin();
+}
+
+static void epdDataWrite(const uint8_t *data, size_t len) {
+    profStart(PROF_SPI);
+    spiWriteBytes(data, len);
+    profStop(PROF_SPI);
+}
+
+static void epdDataEnd() {
+    spiBusEnd();
+    digitalWrite(PIN_EPD_CS, HIGH);
+}
+
+static void epdSendDataBlock(const uint8_t *data, size_t len) {
+    epdDataBegin();
+    epdDataWrite(data, len);
+    epdDataEnd();
+}
+
+// ── Register read (SSD1683 BW) ──────────────────────────────
+// The panel uses 3-wire SPI: SDA turns around after the command byte, so
+// reads are bit-banged with the MOSI pin switched to input. Hardware SPI is
+// detached for the read and reattached afterwards.
+
+#if defined(EPD_PANEL_42_SSD1683_BW)
+static void sdaShiftOut(uint8_t data) {
+    for (int i = 0; i < 8; i++) {
+        digitalWrite(PIN_EPD_MOSI, (data & 0x80) ? HIGH : LOW);
+        data <<= 1;
+        digitalWrite(PIN_EPD_SCK, HIGH);
+        digitalWrite(PIN_EPD_SCK, LOW);
+    }
+}
+
+static uint8_t sdaShiftIn() {
+    uint8_t data = 0;
+    for (int i = 0; i < 8; i++) {
+        digitalWrite(PIN_EPD_SCK, HIGH);
+        data = (data << 1) | (digitalRead(PIN_EPD_MOSI) ? 1 : 0);
+        digitalWrite(PIN_EPD_SCK, LOW);
+    }
+    return data;
+}
+
+static void epdReadRegister(uint8_t cmd, uint8_t *out, int len) {
+#if !EPD_SOFT_SPI
+    SPI.end();
 #endif
-#if defined(EPD_PANEL_42_DKE_RY683) || defined(EPD_PANEL_42_GDEM042F52)
-    while (digitalRead(PIN_EPD_BUSY) == LOW) {
-#else
-    while (digitalRead(PIN_EPD_BUSY) == HIGH) {
+    pinMode(PIN_EPD_MOSI, OUTPUT);
+    pinMode(PIN_EPD_SCK, OUTPUT);
+    digitalWrite(PIN_EPD_SCK, LOW);
+
+    digitalWrite(PIN_EPD_DC, LOW);
+    digitalWrite(PIN_EPD_CS, LOW);
+    sdaShiftOut(cmd);
+    digitalWrite(PIN_EPD_DC, HIGH);
+    pinMode(PIN_EPD_MOSI, INPUT);
+    for (int i = 0; i < len; i++) {
+        out[i] = sdaShiftIn();
+    }
+    digitalWrite(PIN_EPD_CS, HIGH);
+
+    pinMode(PIN_EPD_MOSI, OUTPUT);
+#if !EPD_SOFT_SPI
+    SPI.begin(PIN_EPD_SCK, -1, PIN_EPD_MOSI, -1);
+#endif
+}
 #endif
-        delay(10);
-        if (millis() - t0 > timeoutMs) {
-            Serial.println("EPD busy TIMEOUT!");
-            return;
+
+static void epdWaitBusy(unsigned long maxMs) {
+    unsigned long t0 = millis();
+    unsigned long timeoutMs = maxMs > 0 ? maxMs : BUSY_TIMEOUT_MS;
+    bool lightSleep = busyCanLightSleep();
+    if (!lightSleep) busyIrqAttach();
+    bool timedOut = false;
+    while (epdBusy()) {
+        unsigned long elapsed = millis() - t0;
+        if (elapsed > timeoutMs) {
+            timedOut = true;
+            break;
         }
+        unsigned long remaining = timeoutMs - elapsed + 1;
+        if (!lightSleep) {
+            xSemaphoreTake(busySem, pdMS_TO_TICKS(remaining));
+        } else if (digitalRead(PIN_CFG_BTN) == LOW) {
+            delay(10);  // button held: a level wakeup would fire immediately
+        } else {
+            busyLightSleep(BUSY_ACTIVE == HIGH ? LOW : HIGH, remaining);
+        }
+    }
+    if (!lightSleep) busyIrqDetach();
+    // An async refresh is accounted for as a whole in epdRefreshFinish()
+    if (!refreshPending) profAddUs(PROF_BUSY, (millis() - t0) * 1000UL);
+    if (timedOut) {
+        Serial.println("EPD busy TIMEOUT!");
+        return;
     }
 #if defined(EPD_PANEL_42_DKE_RY683)
     delay(100);
 #endif
 }
 
+// ── Asynchronous refresh ────────────────────────────────────
+// In async mode the display calls return once the update sequence is
+// activated. The next command (or reset) waits for the panel first, so
+// callers only poll when they care about completion.
+
+static bool asyncRefresh = false;
+static unsigned long refreshStartedAt = 0;
+static void (*refreshTail)() = nullptr;
+
+static void epdRefreshFinish() {
+    refreshPending = false;
+    void (*tail)() = refreshTail;
+    refreshTail = nullptr;
+    profAddUs(PROF_BUSY, (millis() - refreshStartedAt) * 1000UL);
+    Serial.printf("[EPD] refresh done %lums\n", millis() - refreshStartedAt);
+    if (tail) tail();
+}
+
+// Called right after the update sequence is activated. tail runs once the
+// panel is idle (power-off on the colour controllers).
+static void epdRefreshStarted(void (*tail)() = nullptr) {
+    if (!asyncRefresh) {
+        epdWaitBusy();
+        if (tail) tail();
+        return;
+    }
+    refreshPending = true;
+    refreshTail = tail;
+    refreshStartedAt = millis();
+}
+
+void epdSetAsyncRefresh(bool enable) {
+    if (!enable) epdRefreshWait();
+    asyncRefresh = enable;
+}
+
+bool epdRefreshPoll() {
+    if (!refreshPending) return true;
+    bool busy = epdBusy();
+    if (busy && millis() - refreshStartedAt <= BUSY_TIMEOUT_MS) return false;
+    if (busy) Serial.println("EPD busy TIMEOUT!");
+    epdRefreshFinish();
+    return true;
+}
+
+void epdRefreshWait() {
+    if (!refreshPending) return;
+    unsigned long elapsed = millis() - refreshStartedAt;
+    epdWaitBusy(elapsed < BUSY_TIMEOUT_MS ? BUSY_TIMEOUT_MS - elapsed : 1);
+    epdRefreshFinish();
+}
+
 static void epdReset() {
+    epdRefreshWait();
 #if defined(EPD_PANEL_42_GDEM042F52)
     delay(20);
     digitalWrite(PIN_EPD_RST, LOW);  delay(40);
@@ -92,6 +343,14 @@ static void epdSetFullWindow() {
     epdSendData(0x00);
 }
 
+// Streamed write in progress (see epdStreamBegin)
+static bool streamActive = false;
+static bool streamFast = false;
+
+// Both RAM planes hold the shown frame; lost when the controller sleeps
+static bool ramValid = false;
+static int ramRestoreY = -1;  // next row of epdRamRestoreRow(), -1 = idle
+
 // ── GPIO initialization ─────────────────────────────────────
 
 void gpioInit() {
@@ -105,10 +364,53 @@ void gpioInit() {
     digitalWrite(PIN_EPD_RST, HIGH);
     digitalWrite(PIN_EPD_CS,  HIGH);
     digitalWrite(PIN_EPD_SCK, LOW);
+#if !EPD_SOFT_SPI
+    SPI.begin(PIN_EPD_SCK, -1, PIN_EPD_MOSI, -1);  // CS driven manually
+#endif
 }
 
 // ── EPD full init (standard mode, 4.2" SSD1683 BW) ──
 
+// ── Panel temperature ───────────────────────────────────────
+// Sampled from the internal sensor at init, before epdInitFast() overrides
+// the temperature register to select its LUT. A sample costs a LUT load and
+// a BUSY wait, so a reading is reused for EPD_TEMP_SAMPLE_S; it is kept in
+// RTC memory with its time() stamp across deep sleep.
+
+static RTC_DATA_ATTR int panelTempC = 0;
+static RTC_DATA_ATTR bool panelTempValid = false;
+static RTC_DATA_ATTR uint32_t panelTempAt = 0;  // time() of the last sample, 0 = none
+
+static void epdSampleTemperature() {
+#if defined(EPD_PANEL_42_SSD1683_BW)
+    uint32_t now = (uint32_t)time(nullptr);
+    if (panelTempAt != 0 && now >= panelTempAt && now - panelTempAt < (uint32_t)EPD_TEMP_SAMPLE_S) return;
+    panelTempAt = now > 0 ? now : 1;
+
+    epdSendCommand(0x18);  // Temperature Sensor Control
+    epdSendData(0x80);     //   Internal sensor
+
+    epdSendCommand(0x22);  // Display Update Control 2
+    epdSendData(0xB1);     //   Load temperature + LUT, no display
+    epdSendCommand(0x20);  // Master Activation
+    epdWaitBusy();
+
+    uint8_t raw[2];
+    epdReadRegister(0x1B, raw, 2);  // Temperature Register: 12-bit, 1/16 C
+    int value = (raw[0] << 4) | (raw[1] >> 4);
+    if (value & 0x800) value -= 0x1000;
+    int celsius = value / 16;
+    panelTempValid = celsius > -30 && celsius < 80;  // floating SDA reads 0xFFF / 0x7FF
+    if (panelTempValid) panelTempC = celsius;
+#endif
+}
+
+bool epdPanelTemperature(int *celsius) {
+    if (!panelTempValid) return false;
+    *celsius = panelTempC;
+    return true;
+}
+
 void epdInit() {
 #if defined(EPD_PANEL_42_DKE_RY683)
     Serial.printf("[EPD-init] begin BUSY=%d\n", digitalRead(PIN_EPD_BUSY));
@@ -218,6 +520,8 @@ void epdInit() {
     epdSendCommand(0x3C);  // Border Waveform Control
     epdSendData(0x05);
 
+    epdSampleTemperature();
+
     epdSetFullWindow();
     epdWaitBusy();
 #endif
@@ -311,6 +615,8 @@ void epdInitFast() {
     epdSendCommand(0x3C);  // Border Waveform Control
     epdSendData(0x05);
 
+    epdSampleTemperature();  // real reading, before the LUT override below
+
     epdSendCommand(0x1A);  // Write to temperature register
     epdSendData(0x6E);     //   Value for ~1.5s fast refresh
 
@@ -327,64 +633,82 @@ void epdInitFast() {
 // ── EPD full-screen display (standard full refresh, 0xF7) ───
 // Clears all ghosting but has visible black-white flash (~3-4s).
 
-static uint8_t packMonoPixelGroup(const uint8_t *image, int rowBytes, int y, int x) {
-    uint8_t packed = 0;
-    for (int bit = 0; bit < 4; bit++) {
-        int px = x + bit;
-        bool isBlack = (image[y * rowBytes + px / 8] & (0x80 >> (px % 8))) == 0;
-        uint8_t color = isBlack ? 0x00 : 0x01;
-        packed |= color << (6 - bit * 2);
-    }
-    return packed;
-}
+// ── 2bpp packing (colour panels) ────────────────────────────
+// Mono rows expand through a byte -> word LUT (pixel_ops.h). The GDEM042F52
+// colour-code remap is folded into a per-byte LUT, so every row goes straight
+// to the bulk SPI writer without a full colorBuf copy.
 
+static uint16_t monoTo2bpp[256];
 #if defined(EPD_PANEL_42_GDEM042F52)
+static uint8_t remap2bpp[256];
+
 static uint8_t epdRemap2bppColor(uint8_t color) {
     return color & 0x03;
 }
+#endif
+static bool packLutReady = false;
 
-static void epdWriteMapped2bpp(const uint8_t *buf2bpp) {
+static void epdBuildPackLuts() {
+    if (packLutReady) return;
+#if defined(EPD_PANEL_42_GDEM042F52)
+    for (int v = 0; v < 256; v++) {
+        remap2bpp[v] = (epdRemap2bppColor((v >> 6) & 0x03) << 6) |
+                       (epdRemap2bppColor((v >> 4) & 0x03) << 4) |
+                       (epdRemap2bppColor((v >> 2) & 0x03) << 2) |
+                        epdRemap2bppColor(v & 0x03);
+    }
+    mono2bppBuildLut(monoTo2bpp, remap2bpp);
+#else
+    mono2bppBuildLut(monoTo2bpp, nullptr);
+#endif
+    packLutReady = true;
+}
+
+// Send the 2bpp data plane (0x10) row by row, from a packed 2bpp buffer or,
+// when buf2bpp is null, expanded on the fly from a mono frame.
+static void epdWrite2bppPlane(const uint8_t *buf2bpp, const uint8_t *mono) {
+    epdBuildPackLuts();
+    uint8_t row[COLOR_ROW_BYTES];
     epdSendCommand(0x10);
-    for (int i = 0; i < COLOR_BUF_LEN; i++) {
-        uint8_t src = buf2bpp[i];
-        uint8_t dst = 0;
-        dst |= epdRemap2bppColor((src >> 6) & 0x03) << 6;
-        dst |= epdRemap2bppColor((src >> 4) & 0x03) << 4;
-        dst |= epdRemap2bppColor((src >> 2) & 0x03) << 2;
-        dst |= epdRemap2bppColor(src & 0x03);
-        epdSendData(dst);
+    epdDataBegin();
+    for (int y = 0; y < H; y++) {
+        if (mono) {
+            mono2bppPackRow(monoTo2bpp, mono + y * ROW_BYTES, row, ROW_BYTES);
+            epdDataWrite(row, COLOR_ROW_BYTES);
+        } else {
+            const uint8_t *src = buf2bpp + y * COLOR_ROW_BYTES;
+#if defined(EPD_PANEL_42_GDEM042F52)
+            remapRow(remap2bpp, src, row, COLOR_ROW_BYTES);
+            epdDataWrite(row, COLOR_ROW_BYTES);
+#else
+            epdDataWrite(src, COLOR_ROW_BYTES);
+#endif
+        }
     }
+    epdDataEnd();
 }
 
+// Power off (JD79668 / RY683 controllers)
 static void epdPowerOff() {
     epdSendCommand(0x02);
     epdSendData(0x00);
     epdWaitBusy();
 }
-#endif
 
-static void epdSend2bppAndRefresh(const uint8_t *buf2bpp) {
+// Exactly one of buf2bpp (packed 2bpp frame) and mono (1bpp frame) is set.
+static void epdSend2bppAndRefresh(const uint8_t *buf2bpp, const uint8_t *mono) {
     for (int attempt = 0; attempt < 3; attempt++) {
         unsigned long t0 = millis();
         Serial.printf("[EPD] attempt %d start BUSY=%d\n", attempt, digitalRead(PIN_EPD_BUSY));
         epdInit();
         Serial.printf("[EPD] init done %lums BUSY=%d\n", millis()-t0, digitalRead(PIN_EPD_BUSY));
-#if defined(EPD_PANEL_42_GDEM042F52)
-        epdWriteMapped2bpp(buf2bpp);
-#else
-        epdSendCommand(0x10);
-        for (int i = 0; i < COLOR_BUF_LEN; i++) {
-            epdSendData(buf2bpp[i]);
-        }
-#endif
+        epdWrite2bppPlane(buf2bpp, mono);
         Serial.printf("[EPD] data done %lums\n", millis()-t0);
 #if defined(EPD_PANEL_42_GDEM042F52)
         epdSendCommand(0x12);
         epdSendData(0x00);
-        epdWaitBusy();
-        Serial.printf("[EPD] refresh done %lums\n", millis()-t0);
-        epdPowerOff();
-        Serial.printf("[EPD] all done %lums\n", millis()-t0);
+        epdRefreshStarted(epdPowerOff);
+        Serial.printf("[EPD] %s %lums\n", refreshPending ? "refresh started" : "all done", millis()-t0);
         return;
 #else
         epdSendCommand(0x04);
@@ -397,12 +721,8 @@ static void epdSend2bppAndRefresh(const uint8_t *buf2bpp) {
         Serial.printf("[EPD] power-on done %lums\n", millis()-t0);
         epdSendCommand(0x12);
         epdSendData(0x00);
-        epdWaitBusy();
-        Serial.printf("[EPD] refresh done %lums\n", millis()-t0);
-        epdSendCommand(0x02);
-        epdSendData(0x00);
-        epdWaitBusy();
-        Serial.printf("[EPD] all done %lums\n", millis()-t0);
+        epdRefreshStarted(epdPowerOff);
+        Serial.printf("[EPD] %s %lums\n", refreshPending ? "refresh started" : "all done", millis()-t0);
         return;
 #endif
     }
@@ -410,40 +730,30 @@ static void epdSend2bppAndRefresh(const uint8_t *buf2bpp) {
 }
 
 void epdDisplay(const uint8_t *image) {
+    refreshGeneration++;
 #if defined(EPD_PANEL_42_DKE_RY683) || defined(EPD_PANEL_42_GDEM042F52)
-    int rowBytes = W / 8;
-    int out = 0;
-    for (int y = 0; y < H; y++) {
-        for (int x = 0; x < W; x += 4) {
-            colorBuf[out++] = packMonoPixelGroup(image, rowBytes, y, x);
-        }
-    }
-    epdSend2bppAndRefresh(colorBuf);
+    epdSend2bppAndRefresh(nullptr, image);
 #else
     epdInit();
 
-    int w = W / 8;
-
     epdSendCommand(0x24);  // Write Black/White RAM
-    for (int j = 0; j < H; j++)
-        for (int i = 0; i < w; i++)
-            epdSendData(image[i + j * w]);
+    epdSendDataBlock(image, IMG_BUF_LEN);
 
     epdSendCommand(0x26);  // Write RED RAM (old data for refresh)
-    for (int j = 0; j < H; j++)
-        for (int i = 0; i < w; i++)
-            epdSendData(image[i + j * w]);
+    epdSendDataBlock(image, IMG_BUF_LEN);
+    ramValid = true;
 
     epdSendCommand(0x22);  // Display Update Control 2
     epdSendData(0xF7);     //   Full update sequence
     epdSendCommand(0x20);  // Activate Display Update Sequence
-    epdWaitBusy();
+    epdRefreshStarted();
 #endif
 }
 
 void epdDisplay2bpp(const uint8_t *image2bpp) {
+    refreshGeneration++;
 #if defined(EPD_PANEL_42_DKE_RY683) || defined(EPD_PANEL_42_GDEM042F52)
-    epdSend2bppAndRefresh(image2bpp);
+    epdSend2bppAndRefresh(image2bpp, nullptr);
 #else
     (void)image2bpp;
     epdDisplay(imgBuf);
@@ -453,47 +763,36 @@ void epdDisplay2bpp(const uint8_t *image2bpp) {
 // ── EPD full-screen display (fast refresh, 0xC7) ────────────
 
 void epdDisplayFast(const uint8_t *image) {
+    refreshGeneration++;
 #if defined(EPD_PANEL_42_GDEM042F52)
-    int rowBytes = W / 8;
-    int out = 0;
-    for (int y = 0; y < H; y++) {
-        for (int x = 0; x < W; x += 4) {
-            colorBuf[out++] = packMonoPixelGroup(image, rowBytes, y, x);
-        }
-    }
     epdInitFast();
-    epdWriteMapped2bpp(colorBuf);
+    epdWrite2bppPlane(nullptr, image);
     epdSendCommand(0x12);
     epdSendData(0x00);
-    epdWaitBusy();
-    epdPowerOff();
+    epdRefreshStarted(epdPowerOff);
 #elif defined(EPD_PANEL_42_DKE_RY683)
     epdDisplay(image);
 #else
     epdInitFast();
 
-    int w = W / 8;
-
     epdSendCommand(0x24);  // Write Black/White RAM
-    for (int j = 0; j < H; j++)
-        for (int i = 0; i < w; i++)
-            epdSendData(image[i + j * w]);
+    epdSendDataBlock(image, IMG_BUF_LEN);
 
     epdSendCommand(0x26);  // Write RED RAM
-    for (int j = 0; j < H; j++)
-        for (int i = 0; i < w; i++)
-            epdSendData(image[i + j * w]);
+    epdSendDataBlock(image, IMG_BUF_LEN);
+    ramValid = true;
 
     epdSendCommand(0x22);  // Display Update Control 2
     epdSendData(0xC7);     //   Fast update: skip LUT load (already loaded by InitFast)
     epdSendCommand(0x20);  // Activate Display Update Sequence
-    epdWaitBusy();
+    epdRefreshStarted();
 #endif
 }
 
 // ── EPD partial refresh ─────────────────────────────────────
 
 void epdPartialDisplay(uint8_t *data, int xStart, int yStart, int xEnd, int yEnd) {
+    refreshGeneration++;
 #if defined(EPD_PANEL_42_DKE_RY683) || defined(EPD_PANEL_42_GDEM042F52)
     (void)data;
     (void)xStart;
@@ -502,6 +801,8 @@ void epdPartialDisplay(uint8_t *data, int xStart, int yStart, int xEnd, int yEnd
     (void)yEnd;
     epdDisplay(imgBuf);
 #else
+    streamActive = false;  // partial write overwrites streamed RAM
+
     int xS = xStart / 8;
     int xE = (xEnd - 1) / 8;
     int width = xE - xS + 1;
@@ -535,16 +836,203 @@ void epdPartialDisplay(uint8_t *data, int xStart, int yStart, int xEnd, int yEnd
     epdSendData((yStart >> 8) & 0xFF);
 
     epdSendCommand(0x24);  // Write Black/White RAM
-    for (int i = 0; i < count; i++)
-        epdSendData(data[i]);
+    epdSendDataBlock(data, count);
+
+    epdSendCommand(0x22);  // Display Update Control 2
+    epdSendData(0xFF);     //   Partial update sequence
+    epdSendCommand(0x20);  // Activate Display Update Sequence
+    epdRefreshStarted();
+#endif
+}
+
+// Write the rectangles of a full frame (stride ROW_BYTES) into one RAM plane
+static void epdWriteRects(uint8_t cmd, const uint8_t *image, const DirtyRect *rects, int count) {
+    for (int i = 0; i < count; i++) {
+        const DirtyRect &r = rects[i];
+        int xS = r.x0 / 8;
+        int xE = (r.x1 - 1) / 8;
+
+        epdSendCommand(0x44);  // Set RAM X address range
+        epdSendData(xS & 0xFF);
+        epdSendData(xE & 0xFF);
+
+        epdSendCommand(0x45);  // Set RAM Y address range
+        epdSendData(r.y0 & 0xFF);
+        epdSendData((r.y0 >> 8) & 0xFF);
+        epdSendData((r.y1 - 1) & 0xFF);
+        epdSendData(((r.y1 - 1) >> 8) & 0xFF);
+
+        epdSendCommand(0x4E);  // Set RAM X address counter
+        epdSendData(xS & 0xFF);
+
+        epdSendCommand(0x4F);  // Set RAM Y address counter
+        epdSendData(r.y0 & 0xFF);
+        epdSendData((r.y0 >> 8) & 0xFF);
+
+        epdSendCommand(cmd);
+        epdDataBegin();
+        for (int y = r.y0; y < r.y1; y++) {
+            epdDataWrite(image + y * ROW_BYTES + xS, xE - xS + 1);
+        }
+        epdDataEnd();
+    }
+}
+
+void epdPartialDisplayRects(const uint8_t *image, const DirtyRect *rects, int count) {
+    refreshGeneration++;
+#if defined(EPD_PANEL_42_DKE_RY683) || defined(EPD_PANEL_42_GDEM042F52)
+    (void)rects;
+    (void)count;
+    epdDisplay(image);
+#else
+    streamActive = false;  // rect writes overwrite streamed RAM
+
+    epdSendCommand(0x3C);  // Border Waveform Control
+    epdSendData(0x80);
+
+    epdSendCommand(0x21);  // Display Update Control 1
+    epdSendData(0x00);
+    epdSendData(0x00);
+
+    // Only dirty rows/bytes go over SPI; one differential refresh covers all
+    epdWriteRects(0x24, image, rects, count);
 
     epdSendCommand(0x22);  // Display Update Control 2
     epdSendData(0xFF);     //   Partial update sequence
     epdSendCommand(0x20);  // Activate Display Update Sequence
     epdWaitBusy();
+
+    // Sync the old-data plane so the next differential refresh starts from
+    // what the panel now shows.
+    epdWriteRects(0x26, image, rects, count);
+    epdSetFullWindow();
+#endif
+}
+
+// ── Streamed frame write ────────────────────────────────────
+// Rows go straight into B/W RAM while the download is still in flight. BMP
+// rows arrive bottom-up, so that case runs the RAM window in Y-decrement mode.
+
+bool epdStreamBegin(bool fast, bool bottomUp) {
+#if defined(EPD_PANEL_42_SSD1683_BW)
+    if (fast) epdInitFast();
+    else      epdInit();
+
+    if (bottomUp) {
+        epdSendCommand(0x11);  // Data Entry Mode Setting
+        epdSendData(0x01);     //   X increment, Y decrement
+
+        epdSendCommand(0x44);  // Set RAM X address range
+        epdSendData(0x00);
+        epdSendData((W - 1) / 8);
+
+        epdSendCommand(0x45);  // Set RAM Y address range (start at bottom row)
+        epdSendData((H - 1) & 0xFF);
+        epdSendData(((H - 1) >> 8) & 0xFF);
+        epdSendData(0x00);
+        epdSendData(0x00);
+
+        epdSendCommand(0x4E);  // Set RAM X address counter
+        epdSendData(0x00);
+
+        epdSendCommand(0x4F);  // Set RAM Y address counter
+        epdSendData((H - 1) & 0xFF);
+        epdSendData(((H - 1) >> 8) & 0xFF);
+    }
+
+    epdSendCommand(0x24);  // Write Black/White RAM
+    streamActive = true;
+    streamFast = fast;
+    return true;
+#else
+    (void)fast;
+    (void)bottomUp;
+    return false;
 #endif
 }
 
+void epdStreamRow(const uint8_t *row) {
+    if (!streamActive) return;
+    epdSendDataBlock(row, ROW_BYTES);
+}
+
+void epdStreamEnd() {
+    if (!streamActive) return;
+    epdSetFullWindow();  // back to X/Y increment for the 0x26 write and partials
+}
+
+void epdStreamCancel() {
+    if (!streamActive) return;
+    epdSetFullWindow();
+    streamActive = false;
+}
+
+void epdStreamCommit(const uint8_t *image) {
+    refreshGeneration++;
+    if (!streamActive) {
+        epdDisplay(image);
+        return;
+    }
+    streamActive = false;
+
+    epdSendCommand(0x26);  // Write RED RAM (old data for refresh)
+    epdSendDataBlock(image, IMG_BUF_LEN);
+    ramValid = true;
+
+    epdSendCommand(0x22);  // Display Update Control 2
+    epdSendData(streamFast ? 0xC7 : 0xF7);
+    epdSendCommand(0x20);  // Activate Display Update Sequence
+    epdRefreshStarted();
+}
+
+// ── Controller RAM restore ──────────────────────────────────
+// After a deep-sleep wake the panel still shows its frame but the controller
+// RAM is gone; the frame is written back into both planes (no refresh) so a
+// differential refresh can follow.
+
+bool epdRamValid() {
+#if defined(EPD_PANEL_42_SSD1683_BW)
+    return ramValid;
+#else
+    return true;  // partial refreshes are full-screen writes here
+#endif
+}
+
+bool epdRamRestoreBegin() {
+#if defined(EPD_PANEL_42_SSD1683_BW)
+    streamActive = false;
+    epdInit();
+    ramRestoreY = 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void epdRamRestoreRow(const uint8_t *row) {
+    if (ramRestoreY < 0 || ramRestoreY >= H) return;
+    static const uint8_t planes[] = {0x24, 0x26};  // new data, old data
+    for (uint8_t plane : planes) {
+        epdSendCommand(0x4E);  // Set RAM X address counter
+        epdSendData(0x00);
+
+        epdSendCommand(0x4F);  // Set RAM Y address counter
+        epdSendData(ramRestoreY & 0xFF);
+        epdSendData((ramRestoreY >> 8) & 0xFF);
+
+        epdSendCommand(plane);
+        epdSendDataBlock(row, ROW_BYTES);
+    }
+    ramRestoreY++;
+}
+
+void epdRamRestoreEnd(bool ok) {
+    if (ramRestoreY < 0) return;
+    ramValid = ok && ramRestoreY == H;
+    ramRestoreY = -1;
+    epdSetFullWindow();
+}
+
 // ── EPD sleep ───────────────────────────────────────────────
 
 void epdSleep() {
@@ -556,6 +1044,7 @@ void epdSleep() {
     epdSendCommand(0x10);  // Deep Sleep Mode
     epdSendData(0x01);     //   Enter deep sleep
     delay(200);
+    ramValid = false;
 #endif
 }
 
@@ -589,42 +1078,56 @@ void epdSleep() {
   #include <gdey/GxEPD2_290_GDEY029T94.h>
   GxEPD2_BW<GxEPD2_290_GDEY029T94, GxEPD2_290_GDEY029T94::HEIGHT> display(
       GxEPD2_290_GDEY029T94(PIN_EPD_CS, PIN_EPD_DC, PIN_EPD_RST, PIN_EPD_BUSY));
-  static uint8_t rotated_buffer[IMG_BUF_LEN];
 
-  static bool is_black_pixel(const uint8_t* buffer, int width, int x, int y) {
-      int row_bytes = (width + 7) / 8;
-      return (buffer[y * row_bytes + x / 8] & (0x80 >> (x % 8))) == 0;
-  }
+  // ── 90° rotation (landscape frame -> portrait controller RAM) ──
+  // Landscape frames go out rotated (pixel_ops.h) in 64-row bands, so no
+  // full-size rotated copy is kept.
+
+  static const int PANEL_ROW_BYTES = GxEPD2_290_GDEY029T94::WIDTH / 8;
+  static const int ROT_BAND_COLS = 8;  // source byte columns per band
+
+  struct PanelRect {
+      int x, y, w, h;
+  };
 
-  static void set_black_pixel(uint8_t* buffer, int width, int x, int y) {
-      int row_bytes = (width + 7) / 8;
-      buffer[y * row_bytes + x / 8] &= ~(0x80 >> (x % 8));
+  // Landscape rect -> panel rect; y is widened to whole bytes of panel x
+  static PanelRect panel_rect(int x0, int y0, int x1, int y1) {
+      y0 &= ~7;
+      y1 = min(H, (y1 + 7) & ~7);
+      PanelRect r = {y0, W - x1, y1 - y0, x1 - x0};
+      return r;
   }
 
-  static void rotate_landscape_to_panel(const uint8_t* source) {
-      memset(rotated_buffer, 0xFF, sizeof(rotated_buffer));
-      for (int src_y = 0; src_y < H; src_y++) {
-          for (int src_x = 0; src_x < W; src_x++) {
-              if (!is_black_pixel(source, W, src_x, src_y)) continue;
-              int dst_x = src_y;
-              int dst_y = W - 1 - src_x;
-              set_black_pixel(rotated_buffer, GxEPD2_290_GDEY029T94::WIDTH, dst_x, dst_y);
-          }
+  // Rotate the landscape rect [x0,x1) x [y0,y1) (x on bytes) into panel RAM
+  static void write_rotated_rect(const uint8_t *source, int x0, int y0, int x1, int y1) {
+      uint8_t band[ROT_BAND_COLS * 8 * PANEL_ROW_BYTES];
+      y0 &= ~7;
+      y1 = min(H, (y1 + 7) & ~7);
+      for (int bx0 = x0 / 8; bx0 < x1 / 8; bx0 += ROT_BAND_COLS) {
+          int bx1 = min(bx0 + ROT_BAND_COLS, x1 / 8);
+          int bandTop = W - bx1 * 8;
+          rotateBand(source, ROW_BYTES, W, bx0, bx1, y0, y1, band);
+          display.writeImage(band, y0, bandTop, y1 - y0, (bx1 - bx0) * 8, false, false, false);
       }
   }
 #elif defined(EPD_PANEL_583)
+  // Frames are written with writeImage(), never drawn through the GFX page
+  // buffer, so it is kept at the 8-row minimum (~10 KB saved on the big panels)
   #include <gdeq/GxEPD2_583_GDEQ0583T31.h>
-  GxEPD2_BW<GxEPD2_583_GDEQ0583T31, GxEPD2_583_GDEQ0583T31::HEIGHT / 4> display(
+  GxEPD2_BW<GxEPD2_583_GDEQ0583T31, 8> display(
       GxEPD2_583_GDEQ0583T31(PIN_EPD_CS, PIN_EPD_DC, PIN_EPD_RST, PIN_EPD_BUSY));
+  #define GX_STREAM_BANDS 1
 #elif defined(EPD_PANEL_75)
   #include <epd/GxEPD2_750_T7.h>
-  GxEPD2_BW<GxEPD2_750_T7, GxEPD2_750_T7::HEIGHT / 4> display(
+  GxEPD2_BW<GxEPD2_750_T7, 8> display(
       GxEPD2_750_T7(PIN_EPD_CS, PIN_EPD_DC, PIN_EPD_RST, PIN_EPD_BUSY));
+  #define GX_STREAM_BANDS 1
 #else
   #error "No EPD panel type defined. Use -DEPD_PANEL_42_SSD1683_BW, -DEPD_PANEL_42_DKE_RY683, -DEPD_PANEL_42_GDEM042F52, -DEPD_PANEL_42_GXEPD2_T81, -DEPD_PANEL_42_GXEPD2_GYE042A87, -DEPD_PANEL_42_GXEPD2_420, -DEPD_PANEL_42_GXEPD2_M01, -DEPD_PANEL_29, -DEPD_PANEL_583, or -DEPD_PANEL_75"
 #endif
 
 static bool _initialized = false;
+static bool ramValid = false;  // controller holds the shown frame (see epdRamValid)
 #if defined(EPD_PANEL_42_GXEPD2_GYE042A87)
 static bool _needs_full_refresh_write = true;
 #endif
@@ -640,10 +1143,20 @@ void gpioInit() {
     SPI.begin(PIN_EPD_SCK, -1, PIN_EPD_MOSI, PIN_EPD_CS);
 }
 
+// GxEPD2 polls BUSY in its own loop; park the task until the pin changes
+// instead of spinning on delay(1).
+static void gxBusyCallback(const void *) {
+    unsigned long t0 = micros();
+    xSemaphoreTake(busySem, pdMS_TO_TICKS(20));
+    profAddUs(PROF_BUSY, micros() - t0);
+}
+
 void epdInit() {
     if (!_initialized) {
         display.epd2.selectSPI(SPI, SPISettings(EPD_GXEPD2_SPI_HZ, MSBFIRST, SPI_MODE0));
         display.init(0);
+        busyIrqAttach();
+        display.epd2.setBusyCallback(gxBusyCallback);
         display.setRotation(DISPLAY_ROTATION);
         _initialized = true;
     }
@@ -654,19 +1167,10 @@ void epdInitFast() {
 }
 
 void epdDisplay(const uint8_t *image) {
+    refreshGeneration++;
     epdInit();
 #if defined(EPD_PANEL_29)
-    rotate_landscape_to_panel(image);
-    display.writeImage(
-        rotated_buffer,
-        0,
-        0,
-        GxEPD2_290_GDEY029T94::WIDTH,
-        GxEPD2_290_GDEY029T94::HEIGHT,
-        false,
-        false,
-        false
-    );
+    write_rotated_rect(image, 0, 0, W, H);
 #elif defined(EPD_PANEL_42_GXEPD2_GYE042A87)
     if (_needs_full_refresh_write) {
         display.epd2.writeImageForFullRefresh(image, 0, 0, W, H, false, false, false);
@@ -679,48 +1183,35 @@ void epdDisplay(const uint8_t *image) {
 #endif
     display.refresh(false);
     display.powerOff();
+    ramValid = true;
 }
 
 void epdDisplayFast(const uint8_t *image) {
+    refreshGeneration++;
 #if defined(EPD_PANEL_42_GXEPD2_GYE042A87)
     epdDisplay(image);
     return;
 #endif
     epdInit();
 #if defined(EPD_PANEL_29)
-    rotate_landscape_to_panel(image);
-    display.writeImage(
-        rotated_buffer,
-        0,
-        0,
-        GxEPD2_290_GDEY029T94::WIDTH,
-        GxEPD2_290_GDEY029T94::HEIGHT,
-        false,
-        false,
-        false
-    );
+    write_rotated_rect(image, 0, 0, W, H);
 #else
     display.writeImage(image, 0, 0, W, H, false, false, false);
 #endif
     display.refresh(true);
     display.powerOff();
+    ramValid = true;
 }
 
 void epdPartialDisplay(uint8_t *data, int xStart, int yStart, int xEnd, int yEnd) {
+    refreshGeneration++;
     epdInit();
 #if defined(EPD_PANEL_29)
-    rotate_landscape_to_panel(imgBuf);
-    display.writeImage(
-        rotated_buffer,
-        0,
-        0,
-        GxEPD2_290_GDEY029T94::WIDTH,
-        GxEPD2_290_GDEY029T94::HEIGHT,
-        false,
-        false,
-        false
-    );
-    display.refresh(true);
+    // data is the packed label; imgBuf holds the same pixels at full stride
+    (void)data;
+    write_rotated_rect(imgBuf, xStart, yStart, xEnd, yEnd);
+    PanelRect pr = panel_rect(xStart, yStart, xEnd, yEnd);
+    display.refresh(pr.x, pr.y, pr.w, pr.h);
 #else
     int w = xEnd - xStart;
     int h = yEnd - yStart;
@@ -730,9 +1221,159 @@ void epdPartialDisplay(uint8_t *data, int xStart, int yStart, int xEnd, int yEnd
     display.powerOff();
 }
 
+void epdPartialDisplayRects(const uint8_t *image, const DirtyRect *rects, int count) {
+    refreshGeneration++;
+    epdInit();
+#if defined(EPD_PANEL_29)
+    // Rotate just the dirty rects; refresh their bounding box in panel space
+    PanelRect u = panel_rect(rects[0].x0, rects[0].y0, rects[0].x1, rects[0].y1);
+    for (int i = 0; i < count; i++) {
+        const DirtyRect &r = rects[i];
+        write_rotated_rect(image, r.x0, r.y0, r.x1, r.y1);
+        PanelRect pr = panel_rect(r.x0, r.y0, r.x1, r.y1);
+        int ux1 = max(u.x + u.w, pr.x + pr.w);
+        int uy1 = max(u.y + u.h, pr.y + pr.h);
+        u.x = min(u.x, pr.x);
+        u.y = min(u.y, pr.y);
+        u.w = ux1 - u.x;
+        u.h = uy1 - u.y;
+    }
+    display.refresh(u.x, u.y, u.w, u.h);
+#else
+    DirtyRect u = rects[0];
+    for (int i = 0; i < count; i++) {
+        const DirtyRect &r = rects[i];
+        display.writeImagePart(image, r.x0, r.y0, W, H, r.x0, r.y0,
+                               r.x1 - r.x0, r.y1 - r.y0, false, false, false);
+        u.x0 = min(u.x0, r.x0);
+        u.y0 = min(u.y0, r.y0);
+        u.x1 = max(u.x1, r.x1);
+        u.y1 = max(u.y1, r.y1);
+    }
+    display.refresh(u.x0, u.y0, u.x1 - u.x0, u.y1 - u.y0);
+#endif
+    display.powerOff();
+}
+
+// GxEPD2 refreshes block inside the library, so there is never one pending.
+void epdSetAsyncRefresh(bool enable) {
+    (void)enable;
+}
+
+bool epdRefreshPoll() {
+    return true;
+}
+
+void epdRefreshWait() {}
+
+// GxEPD2 has no register read path; no temperature available.
+bool epdPanelTemperature(int *celsius) {
+    (void)celsius;
+    return false;
+}
+
+#if defined(GX_STREAM_BANDS)
+// ── Banded stream write (5.83" / 7.5") ──────────────────────
+// Rows are collected into EPD_STREAM_BAND-row strips and written into
+// controller RAM through GxEPD2's windowed writeImage() while the frame
+// downloads; commit then only runs the refresh. BMP rows arrive bottom-up,
+// so those strips fill from their last row.
+
+static const int EPD_STREAM_BAND = 16;
+static uint8_t streamBand[EPD_STREAM_BAND * ROW_BYTES];
+static int streamBandRows = 0;  // rows waiting in streamBand
+static int streamRowsDone = 0;  // rows already in controller RAM
+static bool streamBottomUp = false;
+static bool streamFast = false;
+static bool streamActive = false;
+
+static void streamWriteBand() {
+    if (streamBandRows == 0) return;
+    const uint8_t *rows = streamBand;
+    int y = streamRowsDone;
+    if (streamBottomUp) {
+        rows += (EPD_STREAM_BAND - streamBandRows) * ROW_BYTES;
+        y = H - streamRowsDone - streamBandRows;
+    }
+    display.writeImage(rows, 0, y, W, streamBandRows, false, false, false);
+    streamRowsDone += streamBandRows;
+    streamBandRows = 0;
+}
+
+bool epdStreamBegin(bool fast, bool bottomUp) {
+    epdInit();
+    streamBandRows = 0;
+    streamRowsDone = 0;
+    streamBottomUp = bottomUp;
+    streamFast = fast;
+    streamActive = true;
+    return true;
+}
+
+void epdStreamRow(const uint8_t *row) {
+    if (!streamActive) return;
+    int slot = streamBottomUp ? EPD_STREAM_BAND - 1 - streamBandRows : streamBandRows;
+    memcpy(streamBand + slot * ROW_BYTES, row, ROW_BYTES);
+    if (++streamBandRows == EPD_STREAM_BAND) streamWriteBand();
+}
+
+void epdStreamEnd() {
+    if (!streamActive) return;
+    streamWriteBand();
+    if (streamRowsDone != H) streamActive = false;  // short frame: commit rewrites it
+}
+
+void epdStreamCancel() {
+    streamActive = false;
+    streamBandRows = 0;
+}
+
+void epdStreamCommit(const uint8_t *image) {
+    if (!streamActive) {
+        epdDisplay(image);
+        return;
+    }
+    refreshGeneration++;
+    streamActive = false;
+    display.refresh(streamFast);  // partial_update_mode: fast full-screen update
+    display.powerOff();
+    ramValid = true;
+}
+#else
+// Streaming needs direct RAM-window control; GxEPD2 panels use the buffered path.
+bool epdStreamBegin(bool fast, bool bottomUp) {
+    (void)fast;
+    (void)bottomUp;
+    return false;
+}
+
+void epdStreamRow(const uint8_t *row) { (void)row; }
+void epdStreamEnd() {}
+void epdStreamCancel() {}
+
+void epdStreamCommit(const uint8_t *image) {
+    refreshGeneration++;
+    epdDisplay(image);
+}
+#endif
+
+// GxEPD2 forces a full refresh after hibernation on its own; there is no
+// way to hand it the shown frame, so the first refresh after a wake is full.
+bool epdRamValid() {
+    return ramValid;
+}
+
+bool epdRamRestoreBegin() {
+    return false;
+}
+
+void epdRamRestoreRow(const uint8_t *row) { (void)row; }
+void epdRamRestoreEnd(bool ok) { (void)ok; }
+
 void epdSleep() {
     display.hibernate();
     _initialized = false;
+    ramValid = false;
 #if defined(EPD_PANEL_42_GXEPD2_GYE042A87)
     _needs_full_refresh_write = true;
 #endif
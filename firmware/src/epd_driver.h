@@ -2,6 +2,7 @@
 #define INKSIGHT_EPD_DRIVER_H
 
 #include <Arduino.h>
+#include "dirty_rect.h"
 
 // Initialize GPIO pins and SPI for EPD
 void gpioInit();
@@ -24,6 +25,48 @@ void epdDisplayFast(const uint8_t *image);
 // Partial display refresh for a rectangular region
 void epdPartialDisplay(uint8_t *data, int xStart, int yStart, int xEnd, int yEnd);
 
+// Partial refresh of byte-aligned rectangles read from a full frame buffer;
+// all rectangles are written first and shown by a single refresh
+void epdPartialDisplayRects(const uint8_t *image, const DirtyRect *rects, int count);
+
+// Incremented by every refresh; lets callers detect that the panel changed.
+// Survives deep sleep, like the panel content.
+uint32_t epdRefreshGeneration();
+
+// Controller RAM does not survive epdSleep(), but partial refreshes diff
+// against it. epdRamValid() is false until a full-screen write or a restore:
+// Begin (false where unsupported), the shown frame row by row top-down, then
+// End(ok). Nothing is refreshed.
+bool epdRamValid();
+bool epdRamRestoreBegin();
+void epdRamRestoreRow(const uint8_t *row);
+void epdRamRestoreEnd(bool ok);
+
+// Streamed frame write: rows are pushed into controller RAM while the frame is
+// still downloading, bottom-up (BMP order) or top-down. Begin returns false on
+// panels without stream support; commit writes the old-data plane from the
+// finished frame (SSD1683) and runs the refresh selected at begin. The GxEPD2
+// 5.83"/7.5" panels take the rows in bands through writeImage().
+bool epdStreamBegin(bool fast, bool bottomUp);
+void epdStreamRow(const uint8_t *row);
+void epdStreamEnd();
+void epdStreamCancel();
+void epdStreamCommit(const uint8_t *image);
+
+// Panel temperature from the controller sensor, sampled at init at most once
+// per EPD_TEMP_SAMPLE_S (the reading survives deep sleep).
+// Returns false where the controller exposes none (or the read looked bogus).
+bool epdPanelTemperature(int *celsius);
+
+// Asynchronous refresh (directly driven panels). When enabled, full, fast and
+// time-label refreshes return as soon as the panel starts updating; the
+// wait is to be done in epdRefreshPoll() (true once idle) or epdRefreshWait().
+// Any later driver call waits for a pending refresh on its own. GxEPD2 panels
+// always refresh synchronously.
+void epdSetAsyncRefresh(bool enable);
+bool epdRefreshPoll();
+void epdRefreshWait();
+
 // Put EPD into deep sleep mode
 void epdSleep();
 
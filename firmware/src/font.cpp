@@ -0,0 +1,235 @@
+#include "font.h"
+
+// ── Unified 5x7 pixel font ─────────────────────────────────
+// Printable ASCII (0x20-0x7E), indexed by c - 0x20. Each glyph is 5 columns
+// x 7 rows, stored column-major. Bit 0 = top row, bit 6 = bottom row.
+
+static const int FONT_FIRST = 0x20;
+static const int FONT_COUNT = 0x7F - FONT_FIRST;
+
+static constexpr uint8_t FONT_5X7[FONT_COUNT][5] = {
+    {0x00,0x00,0x00,0x00,0x00},  // 0x20 ' '
+    {0x00,0x00,0x5F,0x00,0x00},  // 0x21 '!'
+    {0x00,0x07,0x00,0x07,0x00},  // 0x22 '"'
+    {0x14,0x7F,0x14,0x7F,0x14},  // 0x23 '#'
+    {0x24,0x2A,0x7F,0x2A,0x12},  // 0x24 '$'
+    {0x23,0x13,0x08,0x64,0x62},  // 0x25 '%'
+    {0x36,0x49,0x55,0x22,0x50},  // 0x26 '&'
+    {0x00,0x05,0x03,0x00,0x00},  // 0x27 '\''
+    {0x00,0x1C,0x22,0x41,0x00},  // 0x28 '('
+    {0x00,0x41,0x22,0x1C,0x00},  // 0x29 ')'
+    {0x14,0x08,0x3E,0x08,0x14},  // 0x2A '*'
+    {0x08,0x08,0x3E,0x08,0x08},  // 0x2B '+'
+    {0x00,0x50,0x30,0x00,0x00},  // 0x2C ','
+    {0x08,0x08,0x08,0x08,0x08},  // 0x2D '-'
+    {0x00,0x60,0x60,0x00,0x00},  // 0x2E '.'
+    {0x20,0x10,0x08,0x04,0x02},  // 0x2F '/'
+    {0x3E,0x51,0x49,0x45,0x3E},  // 0x30 '0'
+    {0x00,0x42,0x7F,0x40,0x00},  // 0x31 '1'
+    {0x42,0x61,0x51,0x49,0x46},  // 0x32 '2'
+    {0x21,0x41,0x45,0x4B,0x31},  // 0x33 '3'
+    {0x18,0x14,0x12,0x7F,0x10},  // 0x34 '4'
+    {0x27,0x45,0x45,0x45,0x39},  // 0x35 '5'
+    {0x3C,0x4A,0x49,0x49,0x30},  // 0x36 '6'
+    {0x01,0x71,0x09,0x05,0x03},  // 0x37 '7'
+    {0x36,0x49,0x49,0x49,0x36},  // 0x38 '8'
+    {0x06,0x49,0x49,0x29,0x1E},  // 0x39 '9'
+    {0x00,0x00,0x36,0x36,0x00},  // 0x3A ':'
+    {0x00,0x56,0x36,0x00,0x00},  // 0x3B ';'
+    {0x08,0x14,0x22,0x41,0x00},  // 0x3C '<'
+    {0x14,0x14,0x14,0x14,0x14},  // 0x3D '='
+    {0x00,0x41,0x22,0x14,0x08},  // 0x3E '>'
+    {0x02,0x01,0x51,0x09,0x06},  // 0x3F '?'
+    {0x32,0x49,0x79,0x41,0x3E},  // 0x40 '@'
+    {0x7E,0x11,0x11,0x11,0x7E},  // 0x41 'A'
+    {0x7F,0x49,0x49,0x49,0x36},  // 0x42 'B'
+    {0x3E,0x41,0x41,0x41,0x22},  // 0x43 'C'
+    {0x7F,0x41,0x41,0x22,0x1C},  // 0x44 'D'
+    {0x7F,0x49,0x49,0x49,0x41},  // 0x45 'E'
+    {0x7F,0x09,0x09,0x09,0x01},  // 0x46 'F'
+    {0x3E,0x41,0x49,0x49,0x3A},  // 0x47 'G'
+    {0x7F,0x08,0x08,0x08,0x7F},  // 0x48 'H'
+    {0x00,0x41,0x7F,0x41,0x00},  // 0x49 'I'
+    {0x20,0x40,0x41,0x3F,0x01},  // 0x4A 'J'
+    {0x7F,0x08,0x14,0x22,0x41},  // 0x4B 'K'
+    {0x7F,0x40,0x40,0x40,0x40},  // 0x4C 'L'
+    {0x7F,0x02,0x0C,0x02,0x7F},  // 0x4D 'M'
+    {0x7F,0x04,0x08,0x10,0x7F},  // 0x4E 'N'
+    {0x3E,0x41,0x41,0x41,0x3E},  // 0x4F 'O'
+    {0x7F,0x09,0x09,0x09,0x06},  // 0x50 'P'
+    {0x3E,0x41,0x51,0x21,0x5E},  // 0x51 'Q'
+    {0x7F,0x09,0x19,0x29,0x46},  // 0x52 'R'
+    {0x26,0x49,0x49,0x49,0x32},  // 0x53 'S'
+    {0x01,0x01,0x7F,0x01,0x01},  // 0x54 'T'
+    {0x3F,0x40,0x40,0x40,0x3F},  // 0x55 'U'
+    {0x1F,0x20,0x40,0x20,0x1F},  // 0x56 'V'
+    {0x3F,0x40,0x38,0x40,0x3F},  // 0x57 'W'
+    {0x63,0x14,0x08,0x14,0x63},  // 0x58 'X'
+    {0x07,0x08,0x70,0x08,0x07},  // 0x59 'Y'
+    {0x61,0x51,0x49,0x45,0x43},  // 0x5A 'Z'
+    {0x00,0x7F,0x41,0x41,0x00},  // 0x5B '['
+    {0x02,0x04,0x08,0x10,0x20},  // 0x5C '\\'
+    {0x00,0x41,0x41,0x7F,0x00},  // 0x5D ']'
+    {0x04,0x02,0x01,0x02,0x04},  // 0x5E '^'
+    {0x40,0x40,0x40,0x40,0x40},  // 0x5F '_'
+    {0x00,0x01,0x02,0x04,0x00},  // 0x60 '`'
+    {0x20,0x54,0x54,0x54,0x78},  // 0x61 'a'
+    {0x7F,0x48,0x44,0x44,0x38},  // 0x62 'b'
+    {0x38,0x44,0x44,0x44,0x28},  // 0x63 'c'
+    {0x38,0x44,0x44,0x28,0x7F},  // 0x64 'd'
+    {0x38,0x54,0x54,0x54,0x18},  // 0x65 'e'
+    {0x00,0x08,0x7E,0x09,0x02},  // 0x66 'f'
+    {0x0C,0x52,0x52,0x52,0x3E},  // 0x67 'g'
+    {0x7F,0x08,0x04,0x04,0x78},  // 0x68 'h'
+    {0x00,0x44,0x7D,0x40,0x00},  // 0x69 'i'
+    {0x20,0x40,0x44,0x3D,0x00},  // 0x6A 'j'
+    {0x7F,0x10,0x28,0x44,0x00},  // 0x6B 'k'
+    {0x00,0x41,0x7F,0x40,0x00},  // 0x6C 'l'
+    {0x7C,0x04,0x18,0x04,0x78},  // 0x6D 'm'
+    {0x7C,0x08,0x04,0x04,0x78},  // 0x6E 'n'
+    {0x38,0x44,0x44,0x44,0x38},  // 0x6F 'o'
+    {0x7C,0x14,0x14,0x14,0x08},  // 0x70 'p'
+    {0x08,0x14,0x14,0x18,0x7C},  // 0x71 'q'
+    {0x7C,0x08,0x04,0x04,0x08},  // 0x72 'r'
+    {0x48,0x54,0x54,0x54,0x24},  // 0x73 's'
+    {0x04,0x3F,0x44,0x40,0x20},  // 0x74 't'
+    {0x3C,0x40,0x40,0x20,0x7C},  // 0x75 'u'
+    {0x1C,0x20,0x40,0x20,0x1C},  // 0x76 'v'
+    {0x3C,0x40,0x30,0x40,0x3C},  // 0x77 'w'
+    {0x44,0x28,0x10,0x28,0x44},  // 0x78 'x'
+    {0x0C,0x50,0x50,0x50,0x3C},  // 0x79 'y'
+    {0x44,0x64,0x54,0x4C,0x44},  // 0x7A 'z'
+    {0x00,0x08,0x36,0x41,0x00},  // 0x7B '{'
+    {0x00,0x00,0x7F,0x00,0x00},  // 0x7C '|'
+    {0x00,0x41,0x36,0x08,0x00},  // 0x7D '}'
+    {0x08,0x04,0x08,0x10,0x08},  // 0x7E '~'
+};
+
+const uint8_t* getGlyph(char c) {
+    int i = (uint8_t)c - FONT_FIRST;
+    return FONT_5X7[i >= 0 && i < FONT_COUNT ? i : 0];  // others draw as space
+}
+
+// Row r of a glyph as 5 bits, bit 4 = leftmost column
+static inline uint8_t glyphRow(const uint8_t *g, int r) {
+    return (((g[0] >> r) & 1) << 4) | (((g[1] >> r) & 1) << 3) | (((g[2] >> r) & 1) << 2) |
+           (((g[3] >> r) & 1) << 1) | ((g[4] >> r) & 1);
+}
+
+// ── Span blitter ────────────────────────────────────────────
+// A span is up to 57 pixels packed MSB-first into a uint64_t (bit 63 = the
+// pixel at x, 1 = black). Callers clip first: 0 <= x, x + n <= width, and
+// only the top n bits may be set. It is written a byte at a time.
+
+static const int SPAN_MAX = 57;  // n + (x & 7) must fit the 64-bit word
+
+static inline void clearSpan(uint8_t *row, int x, uint64_t bits, int n) {
+    uint8_t *p = row + (x >> 3);
+    int sh = x & 7;
+    bits >>= sh;
+    for (n += sh; n > 0; n -= 8, bits <<= 8) *p++ &= ~(uint8_t)(bits >> 56);
+}
+
+static inline uint64_t topBits(int n) {
+    return n >= 64 ? ~0ULL : ~(~0ULL >> n);
+}
+
+// ── Filled rectangle ────────────────────────────────────────
+
+void fillRectInto(uint8_t *buffer, int width, int height, int x, int y, int w, int h) {
+    int x0 = max(x, 0), x1 = min(x + w, width);
+    int y0 = max(y, 0), y1 = min(y + h, height);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    int rowBytes = (width + 7) / 8;
+    int b0 = x0 >> 3, b1 = (x1 - 1) >> 3;
+    uint8_t first = 0xFF >> (x0 & 7);                // pixels of the first byte
+    uint8_t last = 0xFF << (7 - ((x1 - 1) & 7));     // pixels of the last byte
+    for (int py = y0; py < y1; py++) {
+        uint8_t *row = buffer + py * rowBytes;
+        if (b0 == b1) {
+            row[b0] &= ~(first & last);
+            continue;
+        }
+        row[b0] &= ~first;
+        if (b1 > b0 + 1) memset(row + b0 + 1, 0x00, b1 - b0 - 1);
+        row[b1] &= ~last;
+    }
+}
+
+// ── Draw scaled 5x7 text ────────────────────────────────────
+// Glyph rows are pre-expanded for the current scale: spread[p] is the 5-bit
+// row pattern p with every column widened to scale pixels.
+
+static uint64_t spread[32];
+static int spreadScale = 0;
+
+static void buildSpread(int scale) {
+    uint64_t col = topBits(scale);
+    for (int p = 0; p < 32; p++) {
+        uint64_t bits = 0;
+        for (int c = 0; c < 5; c++) {
+            if (p & (0x10 >> c)) bits |= col >> (c * scale);
+        }
+        spread[p] = bits;
+    }
+    spreadScale = scale;
+}
+
+// Scales too wide for one span: a filled square per pixel
+static void drawGlyphBlocks(uint8_t *buffer, int width, int height, const uint8_t *glyph,
+                            int x, int y, int scale) {
+    for (int col = 0; col < 5; col++) {
+        for (int row = 0; row < 7; row++) {
+            if (glyph[col] & (1 << row)) {
+                fillRectInto(buffer, width, height, x + col * scale, y + row * scale, scale, scale);
+            }
+        }
+    }
+}
+
+void drawTextInto(uint8_t *buffer, int width, int height, const char *msg, int x, int y, int scale) {
+    if (scale <= 0 || y >= height || y + 7 * scale <= 0) return;
+    int rowBytes = (width + 7) / 8;
+    int glyphW = 5 * scale;
+    bool spans = glyphW <= SPAN_MAX;
+    if (spans && spreadScale != scale) buildSpread(scale);
+
+    for (int cx = x; *msg && cx < width; msg++, cx += 6 * scale) {
+        if (cx + glyphW <= 0) continue;
+        const uint8_t *glyph = getGlyph(*msg);
+        if (!spans) {
+            drawGlyphBlocks(buffer, width, height, glyph, cx, y, scale);
+            continue;
+        }
+        // Clip the glyph box once
+        int cut = cx < 0 ? -cx : 0;
+        int n = min(glyphW, width - cx) - cut;
+        uint64_t keep = topBits(n);
+        for (int row = 0; row < 7; row++) {
+            uint8_t pattern = glyphRow(glyph, row);
+            if (!pattern) continue;
+            uint64_t bits = (spread[pattern] << cut) & keep;
+            int py0 = max(y + row * scale, 0);
+            int py1 = min(y + (row + 1) * scale, height);
+            for (int py = py0; py < py1; py++) {
+                clearSpan(buffer + py * rowBytes, cx + cut, bits, n);
+            }
+        }
+    }
+}
+
+// ── 16x16 glyphs ────────────────────────────────────────────
+
+void drawGlyph16(uint8_t *buffer, int width, int height, int x, int y, const uint16_t *glyph) {
+    int rowBytes = (width + 7) / 8;
+    int cut = x < 0 ? -x : 0;
+    int n = min(16, width - x) - cut;
+    if (n <= 0) return;
+    uint64_t keep = topBits(n);
+    int row0 = max(0, -y), row1 = min(16, height - y);
+    for (int row = row0; row < row1; row++) {
+        uint64_t bits = ((uint64_t)glyph[row] << (48 + cut)) & keep;
+        if (bits) clearSpan(buffer + (y + row) * rowBytes, x + cut, bits, n);
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef INKSIGHT_FONT_H
+#define INKSIGHT_FONT_H
+
+#include <Arduino.h>
+
+// ── Bitmap fonts ────────────────────────────────────────────
+// Glyphs are drawn black (bit cleared) into a 1bpp buffer of width x height
+// pixels, rows (width + 7) / 8 bytes long, MSB = leftmost pixel. Every
+// primitive clips its box to the buffer once and then writes whole bytes or
+// masked spans per row.
+
+// Look up glyph data for a character (5x7 pixel font, printable ASCII;
+// anything else is a space)
+const uint8_t* getGlyph(char c);
+
+// Solid black rectangle
+void fillRectInto(uint8_t *buffer, int width, int height, int x, int y, int w, int h);
+
+// 5x7 text scaled by scale; characters advance 6 * scale pixels
+void drawTextInto(uint8_t *buffer, int width, int height, const char *msg, int x, int y, int scale);
+
+// 16x16 glyph, one uint16_t per row, MSB = leftmost pixel
+void drawGlyph16(uint8_t *buffer, int width, int height, int x, int y, const uint16_t *glyph);
+
+#endif // INKSIGHT_FONT_H
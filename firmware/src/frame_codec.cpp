@@ -0,0 +1,77 @@
+#include "frame_codec.h"
+
+void packBitsBegin(PackBitsDecoder *d, uint8_t *dst, int dstLen) {
+    packBitsBeginRect(d, dst, dstLen, dstLen, 1);
+}
+
+void packBitsBeginRect(PackBitsDecoder *d, uint8_t *dst, int stride, int rowLen, int rows) {
+    d->dst = dst;
+    d->dstLen = rowLen * rows;
+    d->rowLen = rowLen;
+    d->stride = stride;
+    d->out = 0;
+    d->literal = 0;
+    d->repeat = 0;
+    d->error = false;
+}
+
+// Where output byte d->out goes, and how many fit before the row ends
+static uint8_t *outPtr(const PackBitsDecoder *d, int *room) {
+    if (d->rowLen == d->dstLen) {
+        *room = d->dstLen - d->out;
+        return d->dst + d->out;
+    }
+    int row = d->out / d->rowLen;
+    int col = d->out - row * d->rowLen;
+    *room = d->rowLen - col;
+    return d->dst + row * d->stride + col;
+}
+
+bool packBitsFeed(PackBitsDecoder *d, const uint8_t *src, int len) {
+    int i = 0;
+    while (i < len && !d->error) {
+        if (d->literal > 0) {
+            int n = min(d->literal, len - i);
+            if (d->out + n > d->dstLen) {
+                d->error = true;
+                break;
+            }
+            d->literal -= n;
+            while (n > 0) {
+                int room;
+                uint8_t *p = outPtr(d, &room);
+                int k = min(n, room);
+                memcpy(p, src + i, k);
+                d->out += k;
+                i += k;
+                n -= k;
+            }
+        } else if (d->repeat > 0) {
+            if (d->out + d->repeat > d->dstLen) {
+                d->error = true;
+                break;
+            }
+            while (d->repeat > 0) {
+                int room;
+                uint8_t *p = outPtr(d, &room);
+                int k = min(d->repeat, room);
+                memset(p, src[i], k);
+                d->out += k;
+                d->repeat -= k;
+            }
+            i++;
+        } else {
+            uint8_t header = src[i++];
+            if (header < 128) {
+                d->literal = header + 1;
+            } else if (header > 128) {
+                d->repeat = 257 - header;
+            }
+        }
+    }
+    return !d->error;
+}
+
+bool packBitsDone(const PackBitsDecoder *d) {
+    return !d->error && d->out == d->dstLen && d->literal == 0 && d->repeat == 0;
+}
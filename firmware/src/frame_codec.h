@@ -0,0 +1,36 @@
+#ifndef INKSIGHT_FRAME_CODEC_H
+#define INKSIGHT_FRAME_CODEC_H
+
+#include <Arduino.h>
+
+// ── PackBits stream decoder ─────────────────────────────────
+// Decodes a PackBits stream fed in arbitrary chunks straight into a fixed
+// destination buffer; no intermediate frame copy is needed.
+//   header 0..127   -> n+1 literal bytes follow
+//   header 129..255 -> next byte repeated 257-n times
+//   header 128      -> no-op
+
+struct PackBitsDecoder {
+    uint8_t *dst;
+    int dstLen;     // output bytes expected in total
+    int rowLen;     // output rows of rowLen bytes...
+    int stride;     // ...start stride bytes apart in dst
+    int out;        // bytes decoded so far
+    int literal;    // literal bytes still expected
+    int repeat;     // >0: next input byte is repeated this many times
+    bool error;     // output overflow
+};
+
+void packBitsBegin(PackBitsDecoder *d, uint8_t *dst, int dstLen);
+
+// Decode rows x rowLen bytes into a window of a larger buffer whose rows are
+// stride bytes apart (a frame patch rectangle inside imgBuf)
+void packBitsBeginRect(PackBitsDecoder *d, uint8_t *dst, int stride, int rowLen, int rows);
+
+// Feed the next input chunk. Returns false once output would overflow dst.
+bool packBitsFeed(PackBitsDecoder *d, const uint8_t *src, int len);
+
+// True when dst is completely filled and no packet is left half-read.
+bool packBitsDone(const PackBitsDecoder *d);
+
+#endif // INKSIGHT_FRAME_CODEC_H
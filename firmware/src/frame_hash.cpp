@@ -0,0 +1,91 @@
+#include "frame_hash.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_rom_crc.h>
+
+uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t len) {
+    return esp_rom_crc32_le(crc, data, len);  // zlib-compatible CRC32 in ROM
+}
+#else
+// Table-driven fallback for host builds; same result as zlib.crc32().
+uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t len) {
+    static uint32_t table[256];
+    static bool ready = false;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        ready = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+#endif
+
+// murmur3 finalizer: breaks CRC linearity so equal XOR changes in two rows
+// (e.g. a text line moving down) cannot cancel out inside a tile sum.
+static uint32_t mix32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+int tileByteWidth(int rowBytes) {
+    return (rowBytes + TILE_COLS - 1) / TILE_COLS;
+}
+
+int tileHeight(int rows) {
+    return (rows + TILE_ROWS - 1) / TILE_ROWS;
+}
+
+void frameHashBegin(FrameHash *h, int rowBytes, int rows) {
+    memset(h->tiles, 0, sizeof(h->tiles));
+    h->frame = 0;
+    h->rowBytes = rowBytes;
+    h->rows = rows;
+}
+
+void frameHashRow(FrameHash *h, int y, const uint8_t *row) {
+    int tw = tileByteWidth(h->rowBytes);
+    uint32_t *tileRow = h->tiles + (y / tileHeight(h->rows)) * TILE_COLS;
+    uint32_t seed = (uint32_t)y * 0x9E3779B1u;
+    for (int tx = 0, x = 0; x < h->rowBytes; tx++, x += tw) {
+        int len = min(tw, h->rowBytes - x);
+        tileRow[tx] += mix32(crc32Update(seed, row + x, len));
+    }
+}
+
+void frameHashFinish(FrameHash *h) {
+    uint8_t le[TILE_COUNT * 4];
+    for (int i = 0; i < TILE_COUNT; i++) {
+        le[i * 4 + 0] = h->tiles[i] & 0xFF;
+        le[i * 4 + 1] = (h->tiles[i] >> 8) & 0xFF;
+        le[i * 4 + 2] = (h->tiles[i] >> 16) & 0xFF;
+        le[i * 4 + 3] = (h->tiles[i] >> 24) & 0xFF;
+    }
+    h->frame = crc32Update(0, le, sizeof(le));
+}
+
+void frameHashCompute(FrameHash *h, const uint8_t *buf, int rowBytes, int rows) {
+    frameHashBegin(h, rowBytes, rows);
+    for (int y = 0; y < rows; y++) {
+        frameHashRow(h, y, buf + y * rowBytes);
+    }
+    frameHashFinish(h);
+}
+
+String frameHashEtag(const FrameHash &h) {
+    return frameHashEtag(h.frame);
+}
+
+String frameHashEtag(uint32_t frame) {
+    char buf[12];
+    snprintf(buf, sizeof(buf), "\"%08x\"", (unsigned)frame);
+    return String(buf);
+}
@@ -0,0 +1,42 @@
+#ifndef INKSIGHT_FRAME_HASH_H
+#define INKSIGHT_FRAME_HASH_H
+
+#include <Arduino.h>
+
+// ── Frame / tile hashing ────────────────────────────────────
+// A frame buffer (rowBytes x rows) is split into an 8x8 grid of byte-aligned
+// tiles. Every row segment is hashed with CRC32 seeded by its row index, run
+// through a non-linear mixer and summed into its tile, so rows can be fed in
+// any order (BMP bottom-up, PackBits top-down) while they arrive. The frame
+// hash is CRC32 over the finished tile array; backend ETags use the same
+// scheme (core/renderer.py frame_hash).
+
+static const int TILE_COLS  = 8;
+static const int TILE_ROWS  = 8;
+static const int TILE_COUNT = TILE_COLS * TILE_ROWS;
+
+struct FrameHash {
+    uint32_t tiles[TILE_COUNT];
+    uint32_t frame;
+    int rowBytes;
+    int rows;
+};
+
+// Tile geometry: width in bytes and height in rows (last column/row may be smaller)
+int tileByteWidth(int rowBytes);
+int tileHeight(int rows);
+
+void frameHashBegin(FrameHash *h, int rowBytes, int rows);
+void frameHashRow(FrameHash *h, int y, const uint8_t *row);
+void frameHashFinish(FrameHash *h);
+
+// One-shot hash of a complete buffer
+void frameHashCompute(FrameHash *h, const uint8_t *buf, int rowBytes, int rows);
+
+// Quoted lowercase hex of the frame hash, as sent in ETag / If-None-Match
+String frameHashEtag(const FrameHash &h);
+String frameHashEtag(uint32_t frame);
+
+uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t len);
+
+#endif // INKSIGHT_FRAME_HASH_H
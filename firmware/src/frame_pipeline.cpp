@@ -0,0 +1,152 @@
+#include "frame_pipeline.h"
+#include "config.h"
+#include "display.h"
+#include "epd_driver.h"
+
+#if TASK_RUNTIME
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+static_assert(FRAME_POOL_SIZE >= 1 && FRAME_POOL_SIZE <= 8, "FRAME_POOL_SIZE must be 1..8");
+
+static const uint32_t DISPLAY_TASK_STACK = 6144;
+static const UBaseType_t DISPLAY_TASK_PRIO = 1;  // same as loopTask: time-sliced on the C3
+
+static uint8_t *pool[FRAME_POOL_SIZE];
+static int poolSize = 0;
+
+// Shared with the display task, under pipeMux
+static uint8_t inFlight = 0;  // pool bits queued or being written to the panel
+static int pending = 0;       // frames handed off and not through their refresh yet
+static portMUX_TYPE pipeMux = portMUX_INITIALIZER_UNLOCKED;
+
+static QueueHandle_t readyQueue = nullptr;  // pool indices, loop -> display task
+static SemaphoreHandle_t doneSem = nullptr; // given on every state change above
+static TaskHandle_t displayTask = nullptr;
+
+static uint8_t inFlightBits() {
+    portENTER_CRITICAL(&pipeMux);
+    uint8_t bits = inFlight;
+    portEXIT_CRITICAL(&pipeMux);
+    return bits;
+}
+
+static int pendingFrames() {
+    portENTER_CRITICAL(&pipeMux);
+    int n = pending;
+    portEXIT_CRITICAL(&pipeMux);
+    return n;
+}
+
+// Only the loop task waits, so one binary semaphore is enough: every wait
+// re-checks its condition after a give.
+static void waitForDisplayTask() {
+    xSemaphoreTake(doneSem, portMAX_DELAY);
+}
+
+static int poolIndex(const uint8_t *buf) {
+    for (int i = 0; i < poolSize; i++) {
+        if (pool[i] == buf) return i;
+    }
+    return -1;
+}
+
+static void displayTaskMain(void *) {
+    uint8_t index;
+    for (;;) {
+        if (xQueueReceive(readyQueue, &index, portMAX_DELAY) != pdTRUE) continue;
+        smartDisplay(pool[index]);
+        portENTER_CRITICAL(&pipeMux);
+        inFlight &= ~(1u << index);
+        portEXIT_CRITICAL(&pipeMux);
+        xSemaphoreGive(doneSem);
+
+        // The next panel command would wait for BUSY anyway
+        epdRefreshWait();
+        portENTER_CRITICAL(&pipeMux);
+        pending--;
+        portEXIT_CRITICAL(&pipeMux);
+        xSemaphoreGive(doneSem);
+    }
+}
+
+void framePipelineBegin() {
+    if (displayTask) return;
+    pool[0] = imgBuf;
+    poolSize = 1;
+    for (int i = 1; i < FRAME_POOL_SIZE; i++) {
+        uint8_t *buf = (uint8_t *)malloc(IMG_BUF_LEN);
+        if (!buf) {
+            Serial.printf("[PIPE] No heap for frame buffer %d\n", i + 1);
+            break;
+        }
+        pool[poolSize++] = buf;
+    }
+
+    // The core loopTask is not on (WiFi runs there too); core 0 on the C3
+    BaseType_t core = portNUM_PROCESSORS > 1 ? 1 - xPortGetCoreID() : 0;
+    readyQueue = xQueueCreate(FRAME_POOL_SIZE, sizeof(uint8_t));
+    doneSem = xSemaphoreCreateBinary();
+    if (!readyQueue || !doneSem ||
+        xTaskCreatePinnedToCore(displayTaskMain, "display", DISPLAY_TASK_STACK, nullptr,
+                                DISPLAY_TASK_PRIO, &displayTask, core) != pdPASS) {
+        displayTask = nullptr;
+        Serial.println("[PIPE] Display task not started, displaying from loop()");
+        return;
+    }
+    Serial.printf("[PIPE] Display task on core %d, %d frame buffer(s)\n", (int)core, poolSize);
+}
+
+void frameAcquire() {
+    if (!displayTask) return;
+    int current = poolIndex(imgBuf);
+    for (;;) {
+        uint8_t bits = inFlightBits();
+        if (!(bits & (1u << current))) return;
+        for (int i = 0; i < poolSize; i++) {
+            if (!(bits & (1u << i))) {
+                imgBuf = pool[i];
+                return;
+            }
+        }
+        waitForDisplayTask();
+    }
+}
+
+void displayFrame() {
+    if (!displayTask) {
+        smartDisplay(imgBuf);
+        return;
+    }
+    uint8_t index = (uint8_t)poolIndex(imgBuf);
+    // Shown twice in a row: the first hand-off has to finish first
+    while (inFlightBits() & (1u << index)) waitForDisplayTask();
+    portENTER_CRITICAL(&pipeMux);
+    inFlight |= 1u << index;
+    pending++;
+    portEXIT_CRITICAL(&pipeMux);
+    xQueueSend(readyQueue, &index, portMAX_DELAY);  // never full: one slot per buffer
+}
+
+void displayFlush() {
+    if (!displayTask || xTaskGetCurrentTaskHandle() == displayTask) return;
+    while (pendingFrames() > 0) waitForDisplayTask();
+}
+
+bool displayPoll() {
+    if (!displayTask) return epdRefreshPoll();
+    return pendingFrames() == 0;
+}
+
+#else
+
+void framePipelineBegin() {}
+void frameAcquire() {}
+void displayFrame() { smartDisplay(imgBuf); }
+void displayFlush() {}
+bool displayPoll() { return epdRefreshPoll(); }
+
+#endif
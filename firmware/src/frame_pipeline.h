@@ -0,0 +1,36 @@
+#ifndef INKSIGHT_FRAME_PIPELINE_H
+#define INKSIGHT_FRAME_PIPELINE_H
+
+#include <Arduino.h>
+
+// ── Frame pipeline (TASK_RUNTIME) ───────────────────────────
+// The loop task owns WiFi and HTTP and decodes frames into imgBuf; a display
+// task owns the panel and runs smartDisplay() on them. displayFrame() hands
+// the buffer over through a queue and returns at once; the display task gives
+// it back after the panel RAM write and then waits out the refresh. With a
+// pool of two the next download goes into the other buffer meanwhile: on the
+// WROOM32E's second core, on the single-core C3 interleaved with the display
+// task's BUSY waits.
+//
+// The loop task calls frameAcquire() before overwriting all of imgBuf, and
+// displayFlush() before drawing into it or using the panel otherwise (the
+// display.cpp screens do that themselves). With TASK_RUNTIME=0 frames are
+// displayed synchronously and these calls do nothing.
+
+// Set up the pool and start the display task (after gpioInit)
+void framePipelineBegin();
+
+// Point imgBuf at a buffer the display task is done with, waiting for one if
+// all are handed off. imgBuf stays put when it was not handed off.
+void frameAcquire();
+
+// smartDisplay(imgBuf) on the display task
+void displayFrame();
+
+// Wait until every handed-off frame is on the panel and its refresh finished
+void displayFlush();
+
+// Non-blocking displayFlush(): true once the panel is idle
+bool displayPoll();
+
+#endif // INKSIGHT_FRAME_PIPELINE_H
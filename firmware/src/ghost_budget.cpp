@@ -0,0 +1,66 @@
+#include "ghost_budget.h"
+#include "config.h"
+#include "epd_driver.h"
+#include "storage.h"
+
+static int debt = 0;
+static int cycles = 0;
+static bool loaded = false;
+static volatile int budgetPct = 100;
+
+static void ensureLoaded() {
+    if (loaded) return;
+    loadGhostState(&debt, &cycles);
+    loaded = true;
+}
+
+int ghostCost(RefreshKind kind, int changedPermille, bool tempValid, int tempC) {
+    if (kind == REFRESH_FULL) return 0;
+    changedPermille = constrain(changedPermille, 0, 1000);
+
+    // Fast refresh drives every pixel with a short waveform; partial refresh
+    // only touches the changed area but leaves more residue there.
+    int cost = (kind == REFRESH_FAST) ? GHOST_FAST_BASE + changedPermille
+                                      : changedPermille * 2;
+
+    // Cold panels respond slower, so short waveforms leave more behind
+    if (tempValid) {
+        if (tempC < 5)       cost *= 3;
+        else if (tempC < 15) cost *= 2;
+    }
+    return cost;
+}
+
+void ghostSetBudgetScale(int pct) {
+    budgetPct = max(pct, 100);
+}
+
+bool ghostFullRefreshDue() {
+    ensureLoaded();
+    int pct = budgetPct;
+    return debt >= GHOST_BUDGET * pct / 100 || cycles >= GHOST_MAX_CYCLES * pct / 100;
+}
+
+void ghostCharge(RefreshKind kind, int changedPermille) {
+    ensureLoaded();
+    if (kind == REFRESH_FULL) {
+        debt = 0;
+        cycles = 0;
+    } else {
+        int tempC = 0;
+        bool tempValid = epdPanelTemperature(&tempC);
+        debt = min(debt + ghostCost(kind, changedPermille, tempValid, tempC), GHOST_BUDGET * 2 * budgetPct / 100);
+        cycles++;
+    }
+    saveGhostState(debt, cycles);
+}
+
+int ghostDebt() {
+    ensureLoaded();
+    return debt;
+}
+
+int ghostCycles() {
+    ensureLoaded();
+    return cycles;
+}
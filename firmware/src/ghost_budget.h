@@ -0,0 +1,35 @@
+#ifndef INKSIGHT_GHOST_BUDGET_H
+#define INKSIGHT_GHOST_BUDGET_H
+
+#include <Arduino.h>
+
+// ── Ghosting budget (full-refresh scheduler) ────────────────
+// Every fast or partial refresh leaves some residue on the panel. Each one
+// is charged in per-mille of the screen it touched, weighted by refresh kind
+// and panel temperature. A full refresh is scheduled once the accumulated
+// debt reaches GHOST_BUDGET (or after GHOST_MAX_CYCLES updates) and clears
+// it. The debt lives in NVS so it survives reboots and deep sleep.
+
+enum RefreshKind {
+    REFRESH_FULL,
+    REFRESH_FAST,
+    REFRESH_PARTIAL,
+};
+
+// Cost of one refresh; changedPermille = share of the screen that changed (0-1000)
+int ghostCost(RefreshKind kind, int changedPermille, bool tempValid, int tempC);
+
+// Stretch GHOST_BUDGET and GHOST_MAX_CYCLES to pct percent (>= 100) so that
+// fewer full refreshes run while the battery is low
+void ghostSetBudgetScale(int pct);
+
+// True when the next update should be a full refresh
+bool ghostFullRefreshDue();
+
+// Record a finished refresh and persist the new debt
+void ghostCharge(RefreshKind kind, int changedPermille);
+
+int ghostDebt();
+int ghostCycles();
+
+#endif // INKSIGHT_GHOST_BUDGET_H
@@ -0,0 +1,201 @@
+#include "json_scan.h"
+
+enum {
+    SCAN_START,   // before the opening brace
+    SCAN_KEY,     // expecting a key or the closing brace
+    SCAN_COLON,
+    SCAN_VALUE,   // expecting a value
+    SCAN_SCALAR,  // inside a number / literal
+    SCAN_NESTED,  // inside a nested object or array
+    SCAN_COMMA,   // after a value
+};
+
+void jsonScanBegin(JsonScanner *s, JsonField *fields, int count) {
+    memset(s, 0, sizeof(*s));
+    s->fields = fields;
+    s->count = count;
+    s->state = SCAN_START;
+    s->field = -1;
+    for (int i = 0; i < count; i++) {
+        fields[i].found = false;
+        fields[i].truncated = false;
+        if (fields[i].cap > 0) fields[i].value[0] = '\0';
+    }
+}
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static void putValue(JsonScanner *s, char c) {
+    if (s->field < 0) return;
+    JsonField &f = s->fields[s->field];
+    if (s->len + 1 < f.cap) {
+        f.value[s->len++] = c;
+        f.value[s->len] = '\0';
+    } else {
+        f.truncated = true;
+    }
+}
+
+static void matchKey(JsonScanner *s) {
+    s->field = -1;
+    for (int i = 0; i < s->count; i++) {
+        if (strcmp(s->key, s->fields[i].key) == 0) {
+            s->field = i;
+            return;
+        }
+    }
+}
+
+static void beginValue(JsonScanner *s) {
+    s->len = 0;
+    if (s->field >= 0) {
+        s->fields[s->field].found = true;
+        s->fields[s->field].truncated = false;
+        if (s->fields[s->field].cap > 0) s->fields[s->field].value[0] = '\0';
+    }
+}
+
+// Characters of a string token: the key in SCAN_KEY, a value in SCAN_VALUE,
+// or skipped text inside a nested value
+static void stringChar(JsonScanner *s, char c) {
+    if (s->unicode > 0) {
+        if (--s->unicode == 0 && s->state != SCAN_NESTED) {
+            c = '?';  // non-ASCII escapes are not needed by any caller
+        } else {
+            return;
+        }
+    } else if (s->escape) {
+        s->escape = false;
+        switch (c) {
+            case 'n': c = '\n'; break;
+            case 't': c = '\t'; break;
+            case 'r': c = '\r'; break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'u': s->unicode = 4; return;
+            default: break;  // \" \\ \/
+        }
+    } else if (c == '\\') {
+        s->escape = true;
+        return;
+    } else if (c == '"') {
+        s->inString = false;
+        if (s->state == SCAN_KEY) {
+            s->key[s->len] = '\0';
+            matchKey(s);
+            s->state = SCAN_COLON;
+        } else if (s->state == SCAN_VALUE) {
+            s->field = -1;
+            s->state = SCAN_COMMA;
+        }
+        return;
+    }
+
+    if (s->state == SCAN_KEY) {
+        if (s->len + 1 < sizeof(s->key)) {
+            s->key[s->len++] = c;
+        } else {
+            s->key[0] = '\x01';  // overlong key: never matches
+        }
+    } else if (s->state == SCAN_VALUE) {
+        putValue(s, c);
+    }
+}
+
+static bool scanChar(JsonScanner *s, char c) {
+    if (s->inString) {
+        stringChar(s, c);
+        return true;
+    }
+    switch (s->state) {
+        case SCAN_START:
+            if (isSpace(c)) return true;
+            if (c != '{') return false;
+            s->depth = 1;
+            s->state = SCAN_KEY;
+            return true;
+        case SCAN_KEY:
+            if (isSpace(c)) return true;
+            if (c == '}') {
+                s->done = true;
+                return true;
+            }
+            if (c != '"') return false;
+            s->inString = true;
+            s->len = 0;
+            return true;
+        case SCAN_COLON:
+            if (isSpace(c)) return true;
+            if (c != ':') return false;
+            s->state = SCAN_VALUE;
+            return true;
+        case SCAN_VALUE:
+            if (isSpace(c)) return true;
+            beginValue(s);
+            if (c == '"') {
+                s->inString = true;
+            } else if (c == '{' || c == '[') {
+                s->depth++;
+                s->state = SCAN_NESTED;
+            } else {
+                s->state = SCAN_SCALAR;
+                putValue(s, c);
+            }
+            return true;
+        case SCAN_SCALAR:
+            if (c == ',' || c == '}' || isSpace(c)) {
+                s->field = -1;
+                s->state = SCAN_COMMA;
+                return scanChar(s, c);
+            }
+            putValue(s, c);
+            return true;
+        case SCAN_NESTED:
+            if (c == '"') {
+                s->inString = true;
+            } else if (c == '{' || c == '[') {
+                s->depth++;
+            } else if (c == '}' || c == ']') {
+                if (--s->depth == 1) {
+                    s->field = -1;
+                    s->state = SCAN_COMMA;
+                }
+            }
+            return true;
+        case SCAN_COMMA:
+            if (isSpace(c)) return true;
+            if (c == ',') {
+                s->state = SCAN_KEY;
+                return true;
+            }
+            if (c == '}') {
+                s->done = true;
+                return true;
+            }
+            return false;
+    }
+    return false;
+}
+
+bool jsonScanFeed(JsonScanner *s, const char *data, size_t len) {
+    for (size_t i = 0; i < len && !s->done && !s->error; i++) {
+        if (!scanChar(s, data[i])) s->error = true;
+    }
+    return !s->error;
+}
+
+bool jsonScanDone(const JsonScanner *s) {
+    return s->done && !s->error;
+}
+
+bool jsonFieldTrue(const JsonField &f) {
+    if (!f.found) return false;
+    if (strcmp(f.value, "true") == 0) return true;
+    return atof(f.value) != 0.0;
+}
+
+bool jsonFieldPresent(const JsonField &f) {
+    return f.found && f.value[0] != '\0' && strcmp(f.value, "null") != 0;
+}
@@ -0,0 +1,50 @@
+#ifndef INKSIGHT_JSON_SCAN_H
+#define INKSIGHT_JSON_SCAN_H
+
+#include <Arduino.h>
+
+// ── Streaming JSON field scanner ────────────────────────────
+// Extracts the values of selected top-level keys from a JSON object fed in
+// arbitrary chunks, straight into caller-owned fixed buffers. Whitespace,
+// key order, nested objects/arrays and string escapes are handled; nothing
+// is allocated. String values are stored unescaped, other scalars (numbers,
+// true/false/null) as their literal text. Nested values are skipped.
+
+struct JsonField {
+    const char *key;
+    char *value;    // NUL-terminated; truncated to cap-1 bytes
+    size_t cap;
+    bool found;
+    bool truncated; // value did not fit
+};
+
+struct JsonScanner {
+    JsonField *fields;
+    int count;
+    int state;
+    int depth;
+    bool inString;
+    bool escape;
+    int unicode;    // \uXXXX hex digits still to skip
+    int field;      // index of the field receiving the current value, or -1
+    size_t len;     // bytes written to the current key / value
+    char key[32];
+    bool done;      // top-level object closed
+    bool error;     // not a JSON object
+};
+
+void jsonScanBegin(JsonScanner *s, JsonField *fields, int count);
+
+// Feed the next chunk. Returns false once the input is known not to be a
+// JSON object; bytes after the closing brace are ignored.
+bool jsonScanFeed(JsonScanner *s, const char *data, size_t len);
+
+// True once the top-level object has been closed without error
+bool jsonScanDone(const JsonScanner *s);
+
+// Field value helpers: true for `true` or a non-zero number
+bool jsonFieldTrue(const JsonField &f);
+// Non-empty value that is not `null`
+bool jsonFieldPresent(const JsonField &f);
+
+#endif // INKSIGHT_JSON_SCAN_H
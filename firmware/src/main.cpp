@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
 
 #include "config.h"
 #include "epd_driver.h"
@@ -11,9 +13,16 @@
 #include "storage.h"
 #include "portal.h"
 #include "offline_cache.h"
+#include "push_channel.h"
+#include "profiler.h"
+#include "frame_pipeline.h"
+#include "button.h"
+#include "power_manager.h"
+#include "ghost_budget.h"
 
 // ── Shared framebuffers (referenced by other modules via extern) ──
-uint8_t imgBuf[IMG_BUF_LEN];
+static uint8_t frameBuf[IMG_BUF_LEN];
+uint8_t *imgBuf = frameBuf;
 #if EPD_BPP >= 2
 uint8_t colorBuf[COLOR_BUF_LEN];
 bool useColorBuf = false;
@@ -34,12 +43,11 @@ enum class DeviceState : uint8_t {
 struct DeviceContext {
     DeviceState state = DeviceState::BOOT;
 
-    // Button state
-    unsigned long btnPressStart = 0;
-    bool ignoreConfigButtonUntilRelease = false;
     bool liveMode = false;
     unsigned long lastLivePollAt = 0;
     unsigned long lastLiveWiFiRetryAt = 0;
+    unsigned long pushFailedAt = 0;  // push channel down since, 0 = usable
+    bool alertPending = false;       // push channel announced a focus alert
 
     // Timing
     unsigned long setupDoneAt = 0;
@@ -54,15 +62,31 @@ static DeviceContext ctx;
 static bool focusListening = false;
 static bool alwaysActive = false;
 
-// Content dedup — skip display refresh when content unchanged
-static uint32_t lastContentChecksum = 0;
-static int lastRenderedPeriod = -1;
+// Content dedup — skip display refresh when content unchanged.
+// Compares the frame hash fetchBMP() computes while rows arrive.
+static RTC_DATA_ATTR uint32_t lastContentHash = 0;
+static RTC_DATA_ATTR int lastRenderedPeriod = -1;
+// Whether the frame on screen carries the low-battery badge; a change forces
+// a redraw even when the content is unchanged
+static RTC_DATA_ATTR bool lowBatteryShown = false;
+
+// ── Interval deep sleep (INTERVAL_DEEP_SLEEP) ───────────────
+// Between refreshes an interval device sleeps with the timer set for the
+// earliest of: the next online refresh, the next prefetched frame and (sleep
+// above 3 h) the next period label change. Timer wakes skip the boot delay,
+// the portal-button probe and the LED feedback.
+enum WakeReason : uint8_t {
+    WAKE_BOOT,      // power-up, reset or button
+    WAKE_REFRESH,   // online refresh
+    WAKE_QUEUED,    // show the next prefetched frame
+    WAKE_CLOCK,     // period label change
+    WAKE_RETRY,     // retry after a failed boot
+};
+static const char *const WAKE_NAMES[] = {"boot", "refresh", "queued", "clock", "retry"};
 
-static uint32_t computeChecksum(const uint8_t *buf, int len) {
-    uint32_t sum = 0;
-    for (int i = 0; i < len; i++) sum += buf[i];
-    return sum;
-}
+static RTC_DATA_ATTR uint8_t sleepReason = WAKE_BOOT;
+static RTC_DATA_ATTR uint32_t nextRefreshAt = 0;  // time()
+static bool quietWake = false;
 
 // ── Forward declarations ────────────────────────────────────
 static void checkConfigButton();
@@ -70,8 +94,16 @@ static void triggerImmediateRefresh(bool nextMode = false, bool keepWiFi = false
 static void handleLiveMode();
 static bool waitForContentReady();
 static void handleFailure(const char *reason);
-static void enterDeepSleep(int minutes);
+static void enterDeepSleep(uint32_t seconds, WakeReason reason);
 static void enterPortalMode();
+static void restoreAfterAlert();
+static bool showQueuedFrame();
+static void scheduleNextRefresh();
+static bool intervalSleepAllowed();
+static void sleepUntilNextEvent();
+static void applyPowerPolicy();
+static void showContentFrame();
+static bool lowBatteryBadgeChanged();
 
 // ── LED feedback ────────────────────────────────────────────
 
@@ -81,6 +113,7 @@ static void ledInit() {
 }
 
 static void ledFeedback(const char *pattern) {
+    if (quietWake) return;
     if (strcmp(pattern, "ack") == 0) {
         for (int i = 0; i < 2; i++) {
             digitalWrite(PIN_LED, HIGH); delay(80);
@@ -112,6 +145,12 @@ static void ledFeedback(const char *pattern) {
     }
 }
 
+// POST the runtime mode unless the batched wake already recorded it
+static void reportRuntimeMode(const WakeReply &wake, const char *mode) {
+    if (wake.batched && wake.runtimeMode == mode) return;
+    postRuntimeMode(mode);
+}
+
 static void enterPortalMode() {
     String mac = WiFi.macAddress();
     String apName = "InkSight-" + mac.substring(mac.length() - 5);
@@ -120,16 +159,18 @@ static void enterPortalMode() {
     ctx.liveMode = false;
     ctx.wantEnterLiveMode = false;
     ctx.wantRefresh = false;
-    ctx.btnPressStart = 0;
 
+    pushChannelClose();
+    httpSessionClose();
     WiFi.disconnect(true);
     WiFi.mode(WIFI_OFF);
+    profCycleEnd();
 
     ledFeedback("portal");
     showSetupScreen(apName.c_str());
     startCaptivePortal();
     ctx.state = DeviceState::PORTAL;
-    ctx.ignoreConfigButtonUntilRelease = (digitalRead(PIN_CFG_BTN) == LOW);
+    buttonIgnoreUntilRelease();
 }
 
 // ═════════════════════════════════════════════════════════════
@@ -137,23 +178,44 @@ static void enterPortalMode() {
 // ═════════════════════════════════════════════════════════════
 
 void setup() {
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    WakeReason wakeReason = cause == ESP_SLEEP_WAKEUP_TIMER ? (WakeReason)sleepReason : WAKE_BOOT;
+    bool buttonWake = (cause == ESP_SLEEP_WAKEUP_EXT0);
+    sleepReason = WAKE_BOOT;
+    quietWake = (wakeReason == WAKE_REFRESH || wakeReason == WAKE_QUEUED || wakeReason == WAKE_CLOCK);
+    profCycleBegin(buttonWake ? "button" : WAKE_NAMES[wakeReason]);
+
     Serial.begin(115200);
-    delay(3000);
+    if (wakeReason == WAKE_BOOT && !buttonWake) delay(3000);
     Serial.println("\n=== InkSight ===");
+    if (wakeReason != WAKE_BOOT) Serial.printf("Timer wake: %s\n", WAKE_NAMES[wakeReason]);
 
     gpioInit();
+    epdSetAsyncRefresh(true);  // refreshes return early; the button stays responsive
     ledInit();
 
     bool forcePortal = false;
-    if (digitalRead(PIN_CFG_BTN) == LOW) {
+    if (buttonWake) {
+        // Woken by the config button: a hold opens the portal, a click goes live
+        unsigned long pressedAt = millis();
+        while (digitalRead(PIN_CFG_BTN) == LOW && millis() - pressedAt < (unsigned long)CFG_BTN_HOLD_MS) {
+            delay(10);
+        }
+        forcePortal = (digitalRead(PIN_CFG_BTN) == LOW);
+        Serial.println(forcePortal ? "Button wake: hold" : "Button wake: click");
+    } else if (!quietWake && digitalRead(PIN_CFG_BTN) == LOW) {
         delay(400);
         forcePortal = (digitalRead(PIN_CFG_BTN) == LOW);
     }
+    framePipelineBegin();
+    buttonBegin();
 
     cacheInit();
     Serial.println("EPD ready");
 
     loadConfig();
+    powerUpdate(true);  // radio still off: a quiet ADC reading
+    applyPowerPolicy();
 
     bool hasConfig   = (cfgSSID.length() > 0);
 
@@ -172,47 +234,89 @@ void setup() {
         return;
     }
 
+    // Offline timer wakes: prefetched frame or period label, no WiFi
+    if (wakeReason == WAKE_QUEUED || wakeReason == WAKE_CLOCK) {
+        restoreClock();
+        bool shown = false;
+        if (wakeReason == WAKE_QUEUED) {
+            shown = showQueuedFrame();
+            if (!shown) clearFrameQueue();
+        } else if (EPD_BPP < 2 && restoreFetchedFrame()) {  // colorBuf is lost in sleep
+            // Only the label tiles differ from the panel: partial refresh
+            drawTimeLabel();
+            showContentFrame();
+            lastRenderedPeriod = currentPeriodIndex();
+            shown = true;
+        }
+        if (shown) sleepUntilNextEvent();
+        Serial.println("Frame not available locally, refreshing online");
+    }
+
     // Normal boot: connect WiFi and fetch image
     int retryCount = getRetryCount();
     Serial.printf("Retry count: %d/%d\n", retryCount, MAX_RETRY_COUNT);
 
     ledFeedback("connecting");
-    if (!connectWiFi()) {
+    if (!connectWiFi(false)) {
         if (g_userAborted) {
             Serial.println("User aborted during WiFi connect -> portal");
             enterPortalMode();
             return;
         }
+        if (quietWake) {
+            // Same as a failed refresh while awake: keep the content, try next time
+            Serial.println("WiFi failed, keeping old content");
+            scheduleNextRefresh();
+            sleepUntilNextEvent();
+        }
         ledFeedback("fail");
         handleFailure("WiFi failed");
         return;
     }
 
-    // Best-effort fetch config flags from backend
-    bool focusFlag = false;
-    bool alwaysActiveFlag = false;
-    if (fetchConfigFlags(&focusFlag, &alwaysActiveFlag)) {
-        focusListening = focusFlag;
-        alwaysActive = alwaysActiveFlag;
-    } else {
-        focusListening = false;
-        alwaysActive = false;
-    }
-    if (g_userAborted) {
-        Serial.println("User aborted during config flag fetch -> portal");
-        enterPortalMode();
-        return;
-    }
+    // One batched wake request: frame, config flags, runtime mode, heartbeat
+    // A low battery postpones first-install live mode to a later boot
+    bool firstInstallLivePending = isFirstInstallLiveModePending() && powerTier() == POWER_NORMAL;
+    WakeReply wake = {};
+    wake.runtime = firstInstallLivePending ? "active" : "interval";
 
     Serial.println("Fetching image...");
     ledFeedback("downloading");
     bool gotFallback = false;
-    bool ok = fetchBMP(false, &gotFallback);
+    bool ok = fetchBMP(false, &gotFallback, nullptr, &wake);
     if (g_userAborted) {
         Serial.println("User aborted during fetch -> portal");
         enterPortalMode();
         return;
     }
+
+    if (wake.batched) {
+        focusListening = wake.focusListening;
+        alwaysActive = wake.alwaysActive;
+    } else {
+        // Backend without batched wake: heartbeat and config flags separately
+        postHeartbeat(true);
+        bool focusFlag = false;
+        bool alwaysActiveFlag = false;
+        if (powerTier() != POWER_CRITICAL && fetchConfigFlags(&focusFlag, &alwaysActiveFlag)) {
+            focusListening = focusFlag;
+            alwaysActive = alwaysActiveFlag;
+        } else {
+            focusListening = false;
+            alwaysActive = false;
+        }
+        if (g_userAborted) {
+            Serial.println("User aborted during config flag fetch -> portal");
+            enterPortalMode();
+            return;
+        }
+    }
+    applyPowerPolicy();
+    if (!ok && quietWake) {
+        Serial.println("Fetch failed, keeping old content");
+        scheduleNextRefresh();
+        sleepUntilNextEvent();
+    }
     if (!ok || gotFallback) {
         if (!waitForContentReady()) {
             ledFeedback("fail");
@@ -224,17 +328,22 @@ void setup() {
     // Success - reset retry counter
     resetRetryCount();
 
-    cacheSave(imgBuf, IMG_BUF_LEN);
-    lastContentChecksum = computeChecksum(imgBuf, IMG_BUF_LEN);
+    // After deep sleep the panel still shows the last frame
+    bool unchanged = quietWake && fetchedFrameHash.frame == lastContentHash && !lowBatteryBadgeChanged();
+    lastContentHash = fetchedFrameHash.frame;
     syncNTP();
-    Serial.println("Displaying image...");
-    smartDisplay(imgBuf);
-    ledFeedback("success");
-    Serial.println("Display done");
+    if (unchanged) {
+        Serial.println("Content unchanged, skipping display refresh");
+    } else {
+        Serial.println("Displaying image...");
+        showContentFrame();
+        ledFeedback("success");
+        Serial.println("Display done");
+    }
     lastRenderedPeriod = currentPeriodIndex();
     ctx.lastClockTick = millis();
+    scheduleNextRefresh();
 
-    bool firstInstallLivePending = isFirstInstallLiveModePending();
     if (firstInstallLivePending || alwaysActive) {
         ctx.liveMode = true;
         ctx.lastLivePollAt = 0;
@@ -242,17 +351,19 @@ void setup() {
         if (firstInstallLivePending) {
             markFirstInstallLiveModeDone();
         }
-        postRuntimeMode("active");
+        reportRuntimeMode(wake, "active");
         if (alwaysActive) {
             Serial.println("[LIVE] Always-active enabled");
         } else {
             Serial.println("[LIVE] First install: default to active mode");
         }
     } else {
-        postRuntimeMode("interval");
+        reportRuntimeMode(wake, "interval");
+        if (!buttonWake) fetchFrameBatch();
         if (focusListening) {
             Serial.println("[FOCUS] Focus listening enabled, keeping WiFi connected in interval mode");
         } else {
+            httpSessionClose();
             WiFi.disconnect(true);
             WiFi.mode(WIFI_OFF);
         }
@@ -260,6 +371,13 @@ void setup() {
 
     ctx.state = DeviceState::DISPLAYING;
     ctx.setupDoneAt = millis();
+    if (buttonWake) {
+        // The click that woke the device toggles live mode, as it would awake
+        ctx.wantEnterLiveMode = true;
+        buttonIgnoreUntilRelease();
+        return;
+    }
+    if (intervalSleepAllowed()) return;  // loop() puts the device to sleep
 #if DEBUG_MODE
     Serial.printf("[DEBUG] Staying awake, refresh every %d min (user config: %d min)\n",
                   DEBUG_REFRESH_MIN, cfgSleepMin);
@@ -273,6 +391,12 @@ void setup() {
 // ═════════════════════════════════════════════════════════════
 
 void loop() {
+    // A refresh cycle ends once its panel update has finished
+    if (displayPoll()) {
+        profCycleEnd();
+        configFlush();
+    }
+
     // Portal mode: only handle web requests
     if (ctx.state == DeviceState::PORTAL) {
         handlePortalClients();
@@ -282,6 +406,7 @@ void loop() {
     }
 
     checkConfigButton();
+    if (powerUpdate()) applyPowerPolicy();
 
     if (ctx.wantEnterLiveMode) {
         ctx.wantEnterLiveMode = false;
@@ -294,13 +419,19 @@ void loop() {
             ctx.liveMode = false;
             Serial.println("[LIVE] Live mode disabled, back to interval mode");
             ledFeedback("ack");
+            pushChannelClose();
             postRuntimeMode("interval");
+            httpSessionClose();
             WiFi.disconnect(true);
             WiFi.mode(WIFI_OFF);
+        } else if (powerTier() != POWER_NORMAL) {
+            Serial.println("[LIVE] Battery low, staying in interval mode");
+            ledFeedback("fail");
         } else {
             ctx.liveMode = true;
             ctx.lastLivePollAt = 0;
             ctx.lastLiveWiFiRetryAt = 0;
+            clearFrameQueue();
             Serial.println("[LIVE] Live mode enabled");
             ledFeedback("ack");
             if (connectWiFi()) {
@@ -316,6 +447,11 @@ void loop() {
 
     handleLiveMode();
 
+    if (intervalSleepAllowed() && !ctx.wantEnterLiveMode && !buttonPressed() &&
+        (quietWake || millis() - ctx.setupDoneAt >= BOOT_AWAKE_MS)) {
+        sleepUntilNextEvent();
+    }
+
     unsigned long now = millis();
     bool timeChanged = false;
     while (now - ctx.lastClockTick >= 1000UL) {
@@ -331,18 +467,28 @@ void loop() {
         }
     }
 
-    if (!ctx.liveMode) {
+    if (!ctx.liveMode && queuedFrames() > 0) {
+        // Prefetched frames carry their own schedule; go online once they run out
+        if (queuedFrameDue()) {
+            if (!showQueuedFrame()) {
+                Serial.println("[BATCH] Queued frame unavailable, refreshing online");
+                clearFrameQueue();
+                triggerImmediateRefresh();
+            }
+            ctx.setupDoneAt = millis();
+        }
+    } else if (!ctx.liveMode) {
         unsigned long refreshInterval = 0;
 #if DEBUG_MODE
         refreshInterval = (unsigned long)DEBUG_REFRESH_MIN * 60000UL;
 #else
-        refreshInterval = (unsigned long)cfgSleepMin * 60000UL;
+        refreshInterval = (unsigned long)powerRefreshMin(cfgSleepMin) * 60000UL;
 #endif
         if (millis() - ctx.setupDoneAt >= refreshInterval) {
 #if DEBUG_MODE
             Serial.printf("[DEBUG] %d min elapsed, refreshing content...\n", DEBUG_REFRESH_MIN);
 #else
-            Serial.printf("%d min elapsed, refreshing content...\n", cfgSleepMin);
+            Serial.printf("%d min elapsed, refreshing content...\n", powerRefreshMin(cfgSleepMin));
 #endif
             triggerImmediateRefresh();
             ctx.setupDoneAt = millis();
@@ -353,39 +499,40 @@ void loop() {
         postHeartbeat();
     }
 
-    // Focus Mode: 10s poll alert-bmp and show full-screen alert for 30s
+    // Focus Mode: show a waiting alert full-screen for 30s. Alerts are announced
+    // by the push channel in live mode, otherwise a HEAD check runs every 10s.
+    // Nothing is backed up: the frame underneath is restored from colorBuf or
+    // the offline cache afterwards.
     static unsigned long lastAlertPollAt = 0;
     static bool alertVisible = false;
     static unsigned long alertShownAt = 0;
-    static uint8_t alertBackupBuf[IMG_BUF_LEN];
-    static bool hasAlertBackup = false;
 
     if (focusListening) {
         unsigned long nowMs = millis();
         if (!alertVisible) {
             const unsigned long ALERT_INTERVAL_MS = 10000UL;
-            if (lastAlertPollAt == 0 || nowMs - lastAlertPollAt >= ALERT_INTERVAL_MS) {
+            bool announced = ctx.alertPending;
+            bool pushActive = ctx.liveMode && ctx.pushFailedAt == 0;
+            bool pollDue = !pushActive &&
+                (lastAlertPollAt == 0 || nowMs - lastAlertPollAt >= ALERT_INTERVAL_MS);
+            if (announced || pollDue) {
                 lastAlertPollAt = nowMs;
-                memcpy(alertBackupBuf, imgBuf, IMG_BUF_LEN);
-                hasAlertBackup = true;
-                if (fetchFocusAlertBMP()) {
-                    epdDisplayFast(imgBuf);
-                    alertVisible = true;
-                    alertShownAt = nowMs;
-                } else {
-                    if (hasAlertBackup) memcpy(imgBuf, alertBackupBuf, IMG_BUF_LEN);
-                    hasAlertBackup = false;
+                ctx.alertPending = false;
+                if (announced || focusAlertAvailable()) {
+                    if (fetchFocusAlertBMP()) {
+                        displayFrame();
+                        alertVisible = true;
+                        alertShownAt = nowMs;
+                    } else {
+                        restoreAfterAlert();  // imgBuf may hold part of the alert
+                    }
                 }
             }
         } else {
             const unsigned long ALERT_DISPLAY_MS = 30000UL;
             if (nowMs - alertShownAt >= ALERT_DISPLAY_MS) {
-                if (hasAlertBackup) {
-                    memcpy(imgBuf, alertBackupBuf, IMG_BUF_LEN);
-                    epdDisplayFast(imgBuf);
-                }
-                hasAlertBackup = false;
                 alertVisible = false;
+                restoreAfterAlert();
             }
         }
     }
@@ -393,17 +540,123 @@ void loop() {
     delay(50);
 }
 
+// Put the content frame back after a focus alert. The partial/fast refresh in
+// smartDisplay() only redraws what the alert changed.
+static void restoreAfterAlert() {
+    if (!restoreFetchedFrame()) {
+        Serial.println("[FOCUS] Frame not available locally, refetching");
+        if (!fetchBMP()) {
+            Serial.println("[FOCUS] Refetch failed, keeping alert on screen");
+            return;
+        }
+        lastContentHash = fetchedFrameHash.frame;
+    }
+    showContentFrame();
+}
+
+// ── Power policy ────────────────────────────────────────────
+// Below the normal tier the always-on features go: live mode, always-active
+// and focus listening, together with the radio they keep up. Refreshes are
+// stretched by powerRefreshMin() and full refreshes spaced out by the larger
+// ghosting budget.
+
+static void applyPowerPolicy() {
+    ghostSetBudgetScale(powerGhostBudgetPct());
+    if (powerTier() == POWER_NORMAL) return;
+    if (focusListening || alwaysActive || ctx.liveMode) {
+        Serial.printf("[POWER] Battery %s, live mode and focus listening off\n", powerTierName(powerTier()));
+    }
+    focusListening = false;
+    alwaysActive = false;
+    if (ctx.state != DeviceState::DISPLAYING) return;
+    if (ctx.liveMode) {
+        ctx.liveMode = false;
+        pushChannelClose();
+        postRuntimeMode("interval");
+    }
+    if (WiFi.getMode() != WIFI_OFF) {
+        httpSessionClose();
+        WiFi.disconnect(true);
+        WiFi.mode(WIFI_OFF);
+    }
+}
+
+static bool lowBatteryBadgeChanged() {
+    return (powerTier() == POWER_CRITICAL) != lowBatteryShown;
+}
+
+// displayFrame() for content, with a badge in the bottom right corner on a
+// critical battery so the device does not go dark without warning
+static void showContentFrame() {
+    lowBatteryShown = (powerTier() == POWER_CRITICAL);
+    if (lowBatteryShown) {
+        const int badgeScale = 2;
+        const int badgeLen = 11;  // "LOW BATTERY"
+        const int badgeWidth = badgeLen * (5 * badgeScale + badgeScale) - badgeScale;
+        drawText("LOW BATTERY", W - badgeWidth - 4, H - 7 * badgeScale - 4, badgeScale);
+    }
+    displayFrame();
+}
+
 // ── Deep sleep helper ───────────────────────────────────────
 
-static void enterDeepSleep(int minutes) {
-    if (focusListening || alwaysActive) {
-        Serial.println("[LIVE] Active keep-awake enabled, skipping deep sleep");
-        return;
+static uint32_t refreshIntervalSec() {
+#if DEBUG_MODE
+    return (uint32_t)DEBUG_REFRESH_MIN * 60U;
+#else
+    return (uint32_t)powerRefreshMin(cfgSleepMin) * 60U;
+#endif
+}
+
+static void scheduleNextRefresh() {
+    nextRefreshAt = (uint32_t)time(nullptr) + refreshIntervalSec();
+}
+
+static bool intervalSleepAllowed() {
+#if INTERVAL_DEEP_SLEEP
+    return ctx.state == DeviceState::DISPLAYING && !ctx.liveMode && !focusListening && !alwaysActive;
+#else
+    return false;
+#endif
+}
+
+static void sleepUntilNextEvent() {
+    uint32_t now = (uint32_t)time(nullptr);
+    uint32_t at = nextRefreshAt;
+    WakeReason reason = WAKE_REFRESH;
+    if (queuedFrames() > 0 && nextQueuedFrameAt() <= at) {
+        at = nextQueuedFrameAt();
+        reason = WAKE_QUEUED;
+    }
+    if (cfgSleepMin > 180 && restoreClock()) {
+        uint32_t labelAt = now + (uint32_t)secondsToNextPeriod();
+        if (labelAt < at) {
+            at = labelAt;
+            reason = WAKE_CLOCK;
+        }
     }
+    uint32_t seconds = at > now + DEEP_SLEEP_MIN_S ? at - now : DEEP_SLEEP_MIN_S;
+    enterDeepSleep(seconds, reason);
+}
+
+static void enterDeepSleep(uint32_t seconds, WakeReason reason) {
+    sleepReason = reason;
+    pushChannelClose();
+    httpSessionClose();
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    displayFlush();
+    epdRefreshWait();
+    displaySuspend();
+    profCycleEnd();
+    configFlush();
     epdSleep();
-    Serial.printf("Deep sleep for %d min (~%duA)\n", minutes, 5);
+    Serial.printf("Deep sleep for %lu s, next wake: %s\n", (unsigned long)seconds, WAKE_NAMES[reason]);
     Serial.flush();
-    esp_sleep_enable_timer_wakeup((uint64_t)minutes * 60ULL * 1000000ULL);
+    esp_sleep_enable_timer_wakeup((uint64_t)seconds * 1000000ULL);
+#if defined(BOARD_PROFILE_ESP32_WROOM32E)
+    esp_sleep_enable_ext0_wakeup((gpio_num_t)PIN_CFG_BTN, 0);
+#endif
     esp_deep_sleep_start();
 }
 
@@ -416,6 +669,25 @@ static void showFailureDiagnostic(const char *reason) {
     showDiagnostic(reason, l2, l3, "Hold BOOT to reconfigure");
 }
 
+// Offline, each failed refresh shows the next of the recently stored frames
+// (one per mode) instead of the same stale one. Survives deep sleep.
+static RTC_DATA_ATTR int offlineRotation = 0;
+
+static bool loadOfflineFrame() {
+    for (int tries = 0; tries < CACHE_SLOTS_MAX; tries++) {
+        int frames = cacheCount();
+        if (frames == 0) return false;
+        int n = offlineRotation++ % frames;
+        char mode[24];
+        frameAcquire();
+        if (cacheLoadRecent(n, imgBuf, IMG_BUF_LEN, mode, sizeof(mode))) {
+            Serial.printf("Offline frame %d/%d (%s)\n", n + 1, frames, mode[0] ? mode : "-");
+            return true;
+        }
+    }
+    return false;
+}
+
 static void handleFailure(const char *reason) {
     // Show diagnostic screen so user can see what's wrong
     Serial.printf("[DIAG] %s | SSID=%s | Server=%s\n",
@@ -426,7 +698,7 @@ static void handleFailure(const char *reason) {
     delay(5000);
 
     // Try offline cache
-    if (cacheLoad(imgBuf, IMG_BUF_LEN)) {
+    if (loadOfflineFrame()) {
         Serial.println("Showing cached content (offline mode)");
         const int offlineScale = 2;
         const int offlineLen = 7;
@@ -435,15 +707,17 @@ static void handleFailure(const char *reason) {
         const int offlineY = (H * 12 / 100) + 2;
         drawText("OFFLINE", offlineX, offlineY, offlineScale);
         syncNTP();
-        smartDisplay(imgBuf);
+        showContentFrame();
         ledFeedback("success");
         updateTimeDisplay();
         lastRenderedPeriod = currentPeriodIndex();
         ctx.lastClockTick = millis();
+        httpSessionClose();
         WiFi.disconnect(true);
         WiFi.mode(WIFI_OFF);
         ctx.state = DeviceState::DISPLAYING;
         ctx.setupDoneAt = millis();
+        scheduleNextRefresh();
         resetRetryCount();
         return;
     }
@@ -457,8 +731,7 @@ static void handleFailure(const char *reason) {
 
         Serial.printf("%s, retry %d/%d in %ds...\n",
                       reason, retryCount + 1, MAX_RETRY_COUNT, delaySec);
-        delay((unsigned long)delaySec * 1000);
-        ESP.restart();
+        enterDeepSleep(delaySec, WAKE_RETRY);
     } else {
         Serial.println("Max retries reached, entering deep sleep");
         resetRetryCount();
@@ -468,8 +741,7 @@ static void handleFailure(const char *reason) {
             ctx.setupDoneAt = millis();
             return;
         }
-        esp_sleep_enable_timer_wakeup((uint64_t)cfgSleepMin * 60ULL * 1000000ULL);
-        esp_deep_sleep_start();
+        enterDeepSleep(refreshIntervalSec(), WAKE_RETRY);
     }
 }
 
@@ -497,14 +769,29 @@ static void handleLiveMode() {
         return;
     }
 
-    if (ctx.lastLivePollAt != 0 &&
-        now - ctx.lastLivePollAt < (unsigned long)LIVE_POLL_MS) {
-        return;
+    // Wait on the push channel; poll /state only while it is unavailable
+    bool pendingAction = false;
+    bool shouldExitLive = false;
+    if (ctx.pushFailedAt != 0 && now - ctx.pushFailedAt >= PUSH_RETRY_MS) {
+        ctx.pushFailedAt = 0;
+    }
+    if (ctx.pushFailedAt == 0) {
+        PushEvent ev = pushChannelPoll();
+        if (ev == PUSH_FAILED) {
+            Serial.println("[LIVE] Push channel unavailable, falling back to polling");
+            ctx.pushFailedAt = now ? now : 1;
+            ctx.lastLivePollAt = 0;
+        }
+        pendingAction = (ev == PUSH_REFRESH);
+        shouldExitLive = (ev == PUSH_INTERVAL);
+        if (ev == PUSH_ALERT) ctx.alertPending = true;
+    } else if (ctx.lastLivePollAt == 0 ||
+               now - ctx.lastLivePollAt >= (unsigned long)LIVE_POLL_MS) {
+        ctx.lastLivePollAt = now;
+        pendingAction = hasPendingRemoteAction(&shouldExitLive);
     }
-    ctx.lastLivePollAt = now;
 
-    bool shouldExitLive = false;
-    if (hasPendingRemoteAction(&shouldExitLive)) {
+    if (pendingAction) {
         Serial.println("[LIVE] Pending action detected, refreshing now");
         triggerImmediateRefresh(false, true);
         ctx.setupDoneAt = millis();
@@ -512,7 +799,9 @@ static void handleLiveMode() {
     }
     if (shouldExitLive && !alwaysActive) {
         ctx.liveMode = false;
+        pushChannelClose();
         postRuntimeMode("interval");
+        httpSessionClose();
         WiFi.disconnect(true);
         WiFi.mode(WIFI_OFF);
         Serial.println("[LIVE] Backend requested interval mode");
@@ -532,54 +821,48 @@ static void handleLiveMode() {
 
 static void triggerImmediateRefresh(bool nextMode, bool keepWiFi) {
     Serial.println("[REFRESH] Triggering immediate refresh...");
+    profCycleBegin(ctx.liveMode ? "live" : "refresh");
     ledFeedback("ack");
     if (nextMode) {
         showModePreview("NEXT");
     }
     bool connected = (WiFi.status() == WL_CONNECTED);
+    bool reconnected = false;
     if (!connected) {
         ledFeedback("connecting");
-        connected = connectWiFi();
+        connected = reconnected = connectWiFi(false);
     }
     if (connected) {
         ledFeedback("downloading");
         bool forceRefresh = false;
-        if (fetchBMP(nextMode, nullptr, &forceRefresh)) {
-            bool hasRaw2bpp = false;
-#if EPD_BPP >= 2
-            hasRaw2bpp = useColorBuf;
-#endif
-            if (!hasRaw2bpp) {
-                cacheSave(imgBuf, IMG_BUF_LEN);
-            }
-
-            uint32_t newChecksum = 0;
-#if EPD_BPP >= 2
-            newChecksum = hasRaw2bpp
-                ? computeChecksum(colorBuf, COLOR_BUF_LEN)
-                : computeChecksum(imgBuf, IMG_BUF_LEN);
-#else
-            newChecksum = computeChecksum(imgBuf, IMG_BUF_LEN);
-#endif
+        WakeReply wake = {};
+        wake.runtime = ctx.liveMode ? "active" : "interval";
+        bool fetched = fetchBMP(nextMode, nullptr, &forceRefresh, reconnected ? &wake : nullptr);
+        if (reconnected && !wake.batched) postHeartbeat(true);
+        if (fetched) {
+            uint32_t newHash = fetchedFrameHash.frame;
             syncNTP();
-            if (newChecksum == lastContentChecksum && !nextMode && !forceRefresh) {
+            if (newHash == lastContentHash && !nextMode && !forceRefresh && !lowBatteryBadgeChanged()) {
                 Serial.println("Content unchanged, skipping display refresh");
                 ledFeedback("success");
             } else {
                 Serial.println("Displaying new content...");
-                smartDisplay(imgBuf);
-                lastContentChecksum = newChecksum;
+                showContentFrame();
+                lastContentHash = newHash;
                 ledFeedback("success");
                 Serial.println("Display done");
             }
 
             lastRenderedPeriod = currentPeriodIndex();
             ctx.lastClockTick = millis();
+            scheduleNextRefresh();
+            if (!ctx.liveMode) fetchFrameBatch();
         } else {
             ledFeedback("fail");
             Serial.println("Fetch failed, keeping old content");
         }
         if (!keepWiFi) {
+            httpSessionClose();
             WiFi.disconnect(true);
             WiFi.mode(WIFI_OFF);
         }
@@ -589,6 +872,21 @@ static void triggerImmediateRefresh(bool nextMode, bool keepWiFi) {
     }
 }
 
+// Show the next prefetched frame with the radio off; the next online refresh
+// is due one interval later. False when the stored frame is gone.
+static bool showQueuedFrame() {
+    if (!loadQueuedFrame()) return false;
+    uint32_t newHash = fetchedFrameHash.frame;
+    if (newHash != lastContentHash || lowBatteryBadgeChanged()) {
+        Serial.printf("[BATCH] Showing queued frame (%d left)\n", queuedFrames());
+        showContentFrame();
+        lastContentHash = newHash;
+    }
+    lastRenderedPeriod = currentPeriodIndex();
+    scheduleNextRefresh();
+    return true;
+}
+
 static bool waitForContentReady() {
     const int maxRetries = 4;
     const int waitMs = 15000;
@@ -635,36 +933,15 @@ static bool waitForContentReady() {
 // Long press (>=2s):  restart into config portal
 
 static void checkConfigButton() {
-    bool isPressed = (digitalRead(PIN_CFG_BTN) == LOW);
-
-    if (ctx.ignoreConfigButtonUntilRelease) {
-        if (!isPressed) {
-            ctx.ignoreConfigButtonUntilRelease = false;
-        }
-        ctx.btnPressStart = 0;
-        return;
-    }
-
-    if (isPressed) {
-        if (ctx.btnPressStart == 0) {
-            ctx.btnPressStart = millis();
-        } else {
-            unsigned long holdTime = millis() - ctx.btnPressStart;
-            if (holdTime >= (unsigned long)CFG_BTN_HOLD_MS) {
-                Serial.printf("Config button held for %dms, restarting...\n", CFG_BTN_HOLD_MS);
-                ESP.restart();
-            }
-        }
-    } else {
-        if (ctx.btnPressStart != 0) {
-            unsigned long pressDuration = millis() - ctx.btnPressStart;
-            ctx.btnPressStart = 0;
-
-            if (pressDuration >= (unsigned long)SHORT_PRESS_MIN_MS &&
-                pressDuration < (unsigned long)CFG_BTN_HOLD_MS) {
-                Serial.println("[BTN] Single click -> toggle live mode");
-                ctx.wantEnterLiveMode = true;
-            }
-        }
+    ButtonEvent ev = buttonTakeEvent();
+    if (ev == BTN_HOLD) {
+        Serial.printf("Config button held for %dms, restarting...\n", CFG_BTN_HOLD_MS);
+        displayFlush();
+        epdRefreshWait();
+        configFlush();
+        ESP.restart();
+    } else if (ev == BTN_CLICK) {
+        Serial.println("[BTN] Single click -> toggle live mode");
+        ctx.wantEnterLiveMode = true;
     }
 }
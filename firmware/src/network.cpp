@@ -2,16 +2,29 @@
 #include "config.h"
 #include "storage.h"
 #include "certs.h"
+#include "display.h"
+#include "frame_pipeline.h"
+#include "frame_codec.h"
+#include "offline_cache.h"
+#include "frame_hash.h"
+#include "json_scan.h"
+#include "pixel_ops.h"
+#include "request_builder.h"
+#include "profiler.h"
+#include "power_manager.h"
+#include "push_channel.h"
 
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
 #include <HTTPClient.h>
 #include <time.h>
+#include <stddef.h>
 
 // ── Time state ──────────────────────────────────────────────
 int curHour, curMin, curSec;
 static unsigned long lastHeartbeatAt = 0;
 bool g_userAborted = false;
+FrameHash fetchedFrameHash;
 
 static bool checkAbort() {
     if (digitalRead(PIN_CFG_BTN) == LOW) {
@@ -24,41 +37,193 @@ static bool checkAbort() {
     return false;
 }
 
-static bool beginHttpForUrl(HTTPClient &http, WiFiClient &plainClient, WiFiClientSecure &secClient, const String &url);
+static HTTPClient &httpSession();
+static bool beginHttpForUrl(HTTPClient &http, const char *url);
+static void httpEnd(HTTPClient &http, bool bodyRead);
 static bool recoverDeviceTokenIfUnauthorized(int code);
-static String extractJsonStringField(const String &body, const char *key);
+static bool readJsonResponse(HTTPClient &http, JsonField *fields, int count);
+static void logErrorResponse(HTTPClient &http, const char *tag, int code);
+
+// ── Request buffers ─────────────────────────────────────────
+// URLs and JSON bodies are formatted into these static buffers
+// (request_builder.h) instead of concatenated Strings. The URL is rebuilt on
+// every attempt: a token recovery between attempts sends its own request
+// through reqUrl.
+
+static char reqUrl[REQ_URL_MAX];
+static char reqBody[REQ_BODY_MAX];
+
+static const char *deviceMac() {
+    static char mac[18];
+    if (mac[0] == '\0') {
+        uint8_t m[6] = {0};
+        WiFi.macAddress(m);
+        if (m[0] | m[1] | m[2] | m[3] | m[4] | m[5]) {
+            snprintf(mac, sizeof(mac), "%02X:%02X:%02X:%02X:%02X:%02X",
+                     m[0], m[1], m[2], m[3], m[4], m[5]);
+        }
+    }
+    return mac;
+}
+
+// Start reqUrl as <server>/api/device/<mac><path>
+static bool deviceUrl(ReqBuilder *b, const char *path) {
+    reqBegin(b, reqUrl, sizeof(reqUrl));
+    return reqAppendf(b, "%s/api/device/%s%s", cfgServer.c_str(), deviceMac(), path);
+}
+
+static bool reqReady(const ReqBuilder *b, const char *tag) {
+    if (reqOk(b)) return true;
+    Serial.printf("%s request exceeds %u bytes\n", tag, (unsigned)b->cap);
+    return false;
+}
 
 // ── WiFi connection ─────────────────────────────────────────
 
-bool connectWiFi() {
-    g_userAborted = false;
-    Serial.printf("WiFi: %s ", cfgSSID.c_str());
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(cfgSSID.c_str(), cfgPass.c_str());
+// Last successful join, kept in RTC memory (survives deep sleep) and mirrored
+// to NVS (survives power loss). The credential CRC drops the record when the
+// SSID/password change.
+struct WiFiFastJoin {
+    uint32_t magic;
+    uint32_t credCrc;
+    uint8_t  bssid[6];
+    uint8_t  channel;
+    uint8_t  uses;      // fast joins since the lease came from DHCP
+    uint32_t ip, gateway, subnet, dns;
+};
+
+static const uint32_t FAST_JOIN_MAGIC = 0x464A4E31;  // "FJN1"
+static RTC_DATA_ATTR WiFiFastJoin fastJoin;
+
+static uint32_t credentialCrc() {
+    uint32_t crc = crc32Update(0, (const uint8_t *)cfgSSID.c_str(), cfgSSID.length());
+    return crc32Update(crc, (const uint8_t *)cfgPass.c_str(), cfgPass.length());
+}
+
+static bool fastJoinValid() {
+    if (fastJoin.magic != FAST_JOIN_MAGIC
+        && loadWiFiFastJoin(&fastJoin, sizeof(fastJoin)) != sizeof(fastJoin)) {
+        return false;
+    }
+    return fastJoin.magic == FAST_JOIN_MAGIC && fastJoin.credCrc == credentialCrc()
+        && fastJoin.channel > 0 && fastJoin.ip != 0 && fastJoin.uses < WIFI_FAST_JOIN_MAX;
+}
+
+static void fastJoinInvalidate() {
+    if (fastJoin.magic != FAST_JOIN_MAGIC) return;
+    fastJoin.magic = 0;
+    saveWiFiFastJoin(&fastJoin, sizeof(fastJoin));
+}
 
+// Remember the AP and lease of the current connection. NVS is only written
+// when the AP, channel or lease changed; the use counter lives in RTC.
+static void fastJoinRemember(bool fromDhcp) {
+    WiFiFastJoin rec = {};
+    rec.magic = FAST_JOIN_MAGIC;
+    rec.credCrc = credentialCrc();
+    const uint8_t *bssid = WiFi.BSSID();
+    if (bssid) memcpy(rec.bssid, bssid, sizeof(rec.bssid));
+    rec.channel = (uint8_t)WiFi.channel();
+    rec.uses = fromDhcp ? 0 : (uint8_t)(fastJoin.uses + 1);
+    rec.ip = (uint32_t)WiFi.localIP();
+    rec.gateway = (uint32_t)WiFi.gatewayIP();
+    rec.subnet = (uint32_t)WiFi.subnetMask();
+    rec.dns = (uint32_t)WiFi.dnsIP();
+
+    bool changed = fastJoin.magic != FAST_JOIN_MAGIC
+        || memcmp(&rec.credCrc, &fastJoin.credCrc, offsetof(WiFiFastJoin, uses) - offsetof(WiFiFastJoin, credCrc)) != 0
+        || rec.ip != fastJoin.ip || rec.gateway != fastJoin.gateway
+        || rec.subnet != fastJoin.subnet || rec.dns != fastJoin.dns;
+    fastJoin = rec;
+    if (changed) saveWiFiFastJoin(&fastJoin, sizeof(fastJoin));
+}
+
+// Poll until connected; false on timeout or abort. A fast join also gives up
+// as soon as the driver reports the AP missing or the auth failed.
+static bool waitWiFiConnected(unsigned long timeoutMs, bool direct) {
     unsigned long t0 = millis();
-    while (WiFi.status() != WL_CONNECTED) {
+    while (true) {
+        wl_status_t st = WiFi.status();
+        if (st == WL_CONNECTED) return true;
         if (checkAbort()) return false;
-        if (millis() - t0 > (unsigned long)WIFI_TIMEOUT) {
-            Serial.println("TIMEOUT");
-            return false;
+        if (direct && (st == WL_CONNECT_FAILED || st == WL_NO_SSID_AVAIL)) return false;
+        if (millis() - t0 > timeoutMs) return false;
+        delay(direct ? 20 : 300);
+        if (!direct) Serial.print(".");
+    }
+}
+
+#if INKSIGHT_PROFILE
+// Runs on the WiFi event task: association done, DHCP (or static IP) next
+static void onStaConnected(arduino_event_id_t) {
+    profStop(PROF_WIFI);
+    profStart(PROF_DHCP);
+}
+#endif
+
+static bool joinWiFi() {
+#if INKSIGHT_PROFILE
+    static bool eventHooked = false;
+    if (!eventHooked) {
+        WiFi.onEvent(onStaConnected, ARDUINO_EVENT_WIFI_STA_CONNECTED);
+        eventHooked = true;
+    }
+#endif
+    profStart(PROF_WIFI);
+    WiFi.mode(WIFI_STA);
+#if WIFI_FAST_JOIN
+    if (fastJoinValid()) {
+        Serial.printf("(fast ch%d) ", fastJoin.channel);
+        WiFi.config(IPAddress(fastJoin.ip), IPAddress(fastJoin.gateway),
+                    IPAddress(fastJoin.subnet), IPAddress(fastJoin.dns));
+        WiFi.begin(cfgSSID.c_str(), cfgPass.c_str(), fastJoin.channel, fastJoin.bssid);
+        if (waitWiFiConnected(WIFI_FAST_TIMEOUT, true)) {
+            fastJoinRemember(false);
+            return true;
         }
-        delay(300);
-        Serial.print(".");
+        if (g_userAborted) return false;
+        Serial.print("fast join failed, scanning ");
+        fastJoinInvalidate();
+        WiFi.disconnect();
     }
-    Serial.printf(" OK  IP=%s\n", WiFi.localIP().toString().c_str());
+    // Back to DHCP for the full join
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+#endif
+    WiFi.begin(cfgSSID.c_str(), cfgPass.c_str());
+    if (!waitWiFiConnected(WIFI_TIMEOUT, false)) return false;
+#if WIFI_FAST_JOIN
+    fastJoinRemember(true);
+#endif
+    return true;
+}
+
+bool connectWiFi(bool heartbeat) {
+    g_userAborted = false;
+    Serial.printf("WiFi: %s ", cfgSSID.c_str());
+    unsigned long t0 = millis();
+    bool joined = joinWiFi();
+    profStop(PROF_WIFI);
+    profStop(PROF_DHCP);
+    if (!joined) {
+        if (!g_userAborted) Serial.println("TIMEOUT");
+        return false;
+    }
+    Serial.printf(" OK  IP=%s (%lums)\n", WiFi.localIP().toString().c_str(), millis() - t0);
     if (!ensureDeviceToken()) return false;
     if (cfgPendingPairCode.length() > 0) {
-        String mac = WiFi.macAddress();
-        String url = cfgServer + "/api/device/" + mac + "/claim-token";
-        String body = String("{\"pair_code\":\"") + cfgPendingPairCode + "\"}";
-        for (int attempt = 0; attempt < 3; attempt++) {
+        ReqBuilder body;
+        reqBegin(&body, reqBody, sizeof(reqBody));
+        reqAppend(&body, "{\"pair_code\":");
+        reqAppendJsonString(&body, cfgPendingPairCode.c_str());
+        reqAppend(&body, "}");
+        for (int attempt = 0; attempt < 3 && reqReady(&body, "[PAIR]"); attempt++) {
             if (checkAbort()) return false;
-            Serial.printf("[PAIR] POST %s (attempt %d/3)\n", url.c_str(), attempt + 1);
-            WiFiClient plainClient;
-            WiFiClientSecure secClient;
-            HTTPClient http;
-            if (!beginHttpForUrl(http, plainClient, secClient, url)) {
+            ReqBuilder url;
+            deviceUrl(&url, "/claim-token");
+            if (!reqReady(&url, "[PAIR]")) break;
+            Serial.printf("[PAIR] POST %s (attempt %d/3)\n", reqUrl, attempt + 1);
+            HTTPClient &http = httpSession();
+            if (!beginHttpForUrl(http, reqUrl)) {
                 Serial.println("[PAIR] begin failed");
                 delay(800);
                 continue;
@@ -69,13 +234,13 @@ bool connectWiFi() {
             }
             http.setTimeout(HTTP_TIMEOUT);
 
-            int code = http.POST(body);
+            int code = http.POST((uint8_t *)reqBody, body.len);
             Serial.printf("[PAIR] HTTP code: %d\n", code);
             if (code >= 200 && code < 300) {
-                String resp = http.getString();
-                String savedPairCode = extractJsonStringField(resp, "pair_code");
-                http.end();
-                if (savedPairCode == cfgPendingPairCode) {
+                char savedPairCode[24];
+                JsonField fields[] = {{"pair_code", savedPairCode, sizeof(savedPairCode)}};
+                readJsonResponse(http, fields, 1);
+                if (fields[0].found && !fields[0].truncated && cfgPendingPairCode == savedPairCode) {
                     clearPendingPairCode();
                     Serial.println("[PAIR] pair code registered");
                     break;
@@ -83,97 +248,470 @@ bool connectWiFi() {
                 Serial.printf(
                     "[PAIR] pair code mismatch: local=%s remote=%s\n",
                     cfgPendingPairCode.c_str(),
-                    savedPairCode.length() > 0 ? savedPairCode.c_str() : "empty"
+                    savedPairCode[0] ? savedPairCode : "empty"
                 );
                 delay(800);
                 continue;
             }
-            if (code < 0) {
-                Serial.printf("[PAIR] error: %s\n", http.errorToString(code).c_str());
-            } else {
-                String resp = http.getString();
-                Serial.printf("[PAIR] response: %s\n", resp.substring(0, 300).c_str());
-            }
-            http.end();
+            logErrorResponse(http, "[PAIR]", code);
             if (!recoverDeviceTokenIfUnauthorized(code)) {
                 delay(800);
             }
         }
     }
-    postHeartbeat(true);
+    if (heartbeat) postHeartbeat(true);
     return true;
 }
 
-// ── Battery voltage ─────────────────────────────────────────
+// ── Stream helpers ──────────────────────────────────────────
+// Socket data is pulled in bulk reads of up to NET_CHUNK bytes. While waiting
+// for the next segment the task sleeps 1 ms, so the scheduler (and the WiFi
+// stack) run and checkAbort() stays responsive.
 
-float readBatteryVoltage() {
-    const int SAMPLES = 16;
-    const int DISCARD = 2;  // Discard highest and lowest outliers
-    int readings[SAMPLES];
+static const int NET_CHUNK = 2048;
+static const unsigned long NET_READ_TIMEOUT_MS = 10000;
+static uint8_t netChunk[NET_CHUNK];
 
-    for (int i = 0; i < SAMPLES; i++) {
-        readings[i] = analogRead(PIN_BAT_ADC);
-        delayMicroseconds(100);
+static int waitAndRead(WiFiClient *s, uint8_t *buf, int maxLen) {
+    unsigned long t0 = millis();
+    for (;;) {
+        int avail = s->available();
+        if (avail > 0) {
+            return s->read(buf, min(avail, maxLen));
+        }
+        if (!s->connected()) return -1;
+        if (millis() - t0 > NET_READ_TIMEOUT_MS) return -2;
+        if (checkAbort()) return -3;
+        delay(1);
     }
+}
 
-    // Sort for outlier removal
-    for (int i = 0; i < SAMPLES - 1; i++)
-        for (int j = i + 1; j < SAMPLES; j++)
-            if (readings[i] > readings[j]) {
-                int tmp = readings[i];
-                readings[i] = readings[j];
-                readings[j] = tmp;
-            }
+// Read up to maxLen bytes that are available now, waiting for the first one.
+// Returns the byte count, or -1 disconnected, -2 timeout, -3 user abort.
+static int readSome(WiFiClient *s, uint8_t *buf, int maxLen) {
+    profStart(PROF_BODY);
+    int r = waitAndRead(s, buf, maxLen);
+    profStop(PROF_BODY);
+    return r;
+}
+
+static const char *readErrorName(int err) {
+    switch (err) {
+        case -1: return "disconnected";
+        case -2: return "timeout";
+        case -3: return "aborted";
+        default: return "read error";
+    }
+}
 
-    // Average middle readings (discard DISCARD highest and lowest)
-    long sum = 0;
-    for (int i = DISCARD; i < SAMPLES - DISCARD; i++)
-        sum += readings[i];
+static bool readExact(WiFiClient *s, uint8_t *buf, int len) {
+    int got = 0;
+    while (got < len) {
+        int r = readSome(s, buf + got, len - got);
+        if (r <= 0) {
+            Serial.printf("readExact: %s %d/%d\n", readErrorName(r), got, len);
+            return false;
+        }
+        got += r;
+    }
+    return true;
+}
 
-    float avgRaw = (float)sum / (SAMPLES - 2 * DISCARD);
-    return avgRaw * (3.3f / 4095.0f) * 2.0f;
+static uint32_t le32(const uint8_t *p) {
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
 }
 
-// ── Stream helper ───────────────────────────────────────────
+static bool skipBytes(WiFiClient *s, int len) {
+    while (len > 0) {
+        int r = readSome(s, netChunk, min(len, NET_CHUNK));
+        if (r <= 0) {
+            Serial.printf("skipBytes: %s, %d left\n", readErrorName(r), len);
+            return false;
+        }
+        len -= r;
+    }
+    return true;
+}
 
-static bool readExact(WiFiClient *s, uint8_t *buf, int len) {
+// Read H bottom-up BMP rows (ROW_STRIDE bytes each) into a top-down image
+// (pixel_ops.h). Completed rows are hashed into hash (if given) and, with
+// streamRows, handed to the display stream.
+static bool readBmpRows(WiFiClient *s, uint8_t *image, bool streamRows, FrameHash *hash) {
+    if (hash) frameHashBegin(hash, ROW_BYTES, H);
+    BmpRowReader rows;
+    bmpRowsBegin(&rows, image, ROW_BYTES, ROW_STRIDE, H);
+    while (bmpRowsRemaining(&rows) > 0) {
+        int n = readSome(s, netChunk, min(NET_CHUNK, bmpRowsRemaining(&rows)));
+        if (n <= 0) {
+            Serial.printf("Failed to read row %d (%s)\n", rows.bmpY, readErrorName(n));
+            return false;
+        }
+        profStart(PROF_DECODE);
+        for (int off = 0; off < n;) {
+            int y;
+            off += bmpRowsFeed(&rows, netChunk + off, n - off, &y);
+            if (y < 0) continue;
+            const uint8_t *row = image + y * ROW_BYTES;
+            if (hash) frameHashRow(hash, y, row);
+            if (streamRows) displayStreamRow(row);
+        }
+        profStop(PROF_DECODE);
+    }
+    if (hash) frameHashFinish(hash);
+    return true;
+}
+
+// Read a raw top-down frame of len bytes, hashing rows as they complete.
+static bool readRawRows(WiFiClient *s, uint8_t *dst, int len, int rowBytes, FrameHash *hash) {
+    frameHashBegin(hash, rowBytes, len / rowBytes);
     int got = 0;
-    unsigned long t0 = millis();
+    int rowsHashed = 0;
     while (got < len) {
-        if (!s->connected() && !s->available()) {
-            Serial.printf("readExact: disconnected %d/%d\n", got, len);
+        int r = readSome(s, dst + got, min(len - got, NET_CHUNK));
+        if (r <= 0) {
+            Serial.printf("readRawRows: %s %d/%d\n", readErrorName(r), got, len);
             return false;
         }
-        if (millis() - t0 > 10000) {
-            Serial.printf("readExact: timeout %d/%d\n", got, len);
+        got += r;
+        profStart(PROF_DECODE);
+        while ((rowsHashed + 1) * rowBytes <= got) {
+            frameHashRow(hash, rowsHashed, dst + rowsHashed * rowBytes);
+            rowsHashed++;
+        }
+        profStop(PROF_DECODE);
+    }
+    frameHashFinish(hash);
+    return true;
+}
+
+// Decode a PackBits body into imgBuf (bpp 1) or colorBuf (bpp 2). srcLen is
+// the Content-Length, or -1 to read until the frame is complete. Rows are
+// hashed as soon as they are decoded; mono rows also feed the display stream
+// (top-down).
+static bool readPackedFrame(WiFiClient *s, int srcLen, int bpp, FrameHash *hash, bool allowStream = true) {
+    frameAcquire();
+    uint8_t *dst = imgBuf;
+    int dstLen = IMG_BUF_LEN;
+    int rowBytes = ROW_BYTES;
+    if (bpp == 2) {
+#if EPD_BPP >= 2
+        dst = colorBuf;
+        dstLen = COLOR_BUF_LEN;
+        rowBytes = COLOR_ROW_BYTES;
+#else
+        Serial.println("PackBits: 2bpp frame on mono panel");
+        return false;
+#endif
+    } else if (bpp != 1) {
+        Serial.printf("PackBits: unsupported bpp %d\n", bpp);
+        return false;
+    }
+
+    PackBitsDecoder dec;
+    packBitsBegin(&dec, dst, dstLen);
+    frameHashBegin(hash, rowBytes, H);
+    bool streaming = allowStream && (dst == imgBuf) && displayStreamBegin(false);
+    int rowsDone = 0;
+    int remaining = srcLen;
+    while (!packBitsDone(&dec) && remaining != 0) {
+        int want = remaining > 0 ? min(remaining, NET_CHUNK) : NET_CHUNK;
+        int n = readSome(s, netChunk, want);
+        if (n <= 0) {
+            Serial.printf("PackBits: %s after %d bytes\n", readErrorName(n), dec.out);
+            break;
+        }
+        if (remaining > 0) remaining -= n;
+        profStart(PROF_DECODE);
+        bool fed = packBitsFeed(&dec, netChunk, n);
+        while (fed && (rowsDone + 1) * rowBytes <= dec.out) {
+            const uint8_t *row = dst + rowsDone * rowBytes;
+            frameHashRow(hash, rowsDone, row);
+            if (streaming) displayStreamRow(row);
+            rowsDone++;
+        }
+        profStop(PROF_DECODE);
+        if (!fed) {
+            Serial.println("PackBits: output overflow");
+            break;
+        }
+    }
+
+    bool ok = packBitsDone(&dec);
+    displayStreamEnd(ok);
+    if (!ok) {
+        Serial.printf("PackBits: decoded %d/%d bytes\n", dec.out, dstLen);
+        return false;
+    }
+    frameHashFinish(hash);
+#if EPD_BPP >= 2
+    useColorBuf = (dst == colorBuf);
+#endif
+    Serial.printf("PackBits OK  %d -> %d bytes (%dbpp)\n", srcLen, dstLen, bpp);
+    return true;
+}
+
+// ── Conditional GET ─────────────────────────────────────────
+// The ETag is the frame hash (frame_hash.h), which the backend computes the
+// same way. monoHash is the frame last shown from the offline store (kept in
+// RTC memory across deep sleep; after a cold boot, the newest stored frame);
+// colorEtag tags the raw 2bpp frame still held in colorBuf during this boot.
+// A 304 restores the tagged frame locally.
+
+static RTC_DATA_ATTR uint32_t monoHash = 0;
+static RTC_DATA_ATTR bool monoValid = false;
+static RTC_DATA_ATTR bool monoLoaded = false;
+static char fetchedMode[24];   // X-InkSight-Mode of the last downloaded frame
+#if EPD_BPP >= 2
+static String colorEtag;
+static FrameHash colorFrameHash;
+#endif
+
+static String conditionalEtag() {
+    if (!monoLoaded) {
+        monoValid = cacheNewest(&monoHash);
+        monoLoaded = true;
+    }
+#if EPD_BPP >= 2
+    if (colorEtag.length() > 0) return colorEtag;
+#endif
+    if (monoValid) return frameHashEtag(monoHash);
+    return "";
+}
+
+static void forgetFrameEtags() {
+    monoValid = false;
+#if EPD_BPP >= 2
+    colorEtag = "";
+#endif
+}
+
+// Load the frame a 304 refers to back into the framebuffer and check that it
+// still hashes to the ETag.
+static bool restoreNotModifiedFrame(const String &etag) {
+    frameAcquire();
+#if EPD_BPP >= 2
+    if (colorEtag.length() > 0 && etag == colorEtag) {
+        fetchedFrameHash = colorFrameHash;
+        useColorBuf = true;
+        return true;
+    }
+    useColorBuf = false;
+#endif
+    if (!monoValid || etag != frameHashEtag(monoHash) || !cacheLoadHash(imgBuf, IMG_BUF_LEN, monoHash)) {
+        return false;
+    }
+    frameHashCompute(&fetchedFrameHash, imgBuf, ROW_BYTES, H);
+    return frameHashEtag(fetchedFrameHash) == etag;
+}
+
+// Record a freshly downloaded frame: mono frames go to the offline store
+// (a frame it already holds is not rewritten) and become the ETag once stored.
+static void rememberFrame() {
+#if EPD_BPP >= 2
+    if (useColorBuf) {
+        colorEtag = frameHashEtag(fetchedFrameHash);
+        colorFrameHash = fetchedFrameHash;
+        return;
+    }
+    colorEtag = "";
+#endif
+    monoValid = cacheSave(imgBuf, IMG_BUF_LEN, fetchedMode, fetchedFrameHash.frame);
+    monoHash = fetchedFrameHash.frame;
+    monoLoaded = true;
+}
+
+// Apply a patch body (format in docs/api.md) to the frame it was made
+// against: that frame is restored into imgBuf, each rectangle is decoded in
+// place, and the result has to hash to the patch's result hash. False means
+// the full frame has to be fetched instead; imgBuf may be half patched then.
+static bool readFramePatch(WiFiClient *s, const String &baseEtag, FrameHash *hash) {
+    uint8_t hdr[16];
+    if (!readExact(s, hdr, sizeof(hdr)) || memcmp(hdr, "IKP1", 4) != 0) {
+        Serial.println("[PATCH] bad header");
+        return false;
+    }
+    uint32_t base = le32(hdr + 4);
+    uint32_t result = le32(hdr + 8);
+    int count = hdr[12] | (hdr[13] << 8);
+    if (frameHashEtag(base) != baseEtag || !restoreNotModifiedFrame(baseEtag)) {
+        Serial.println("[PATCH] base frame unavailable");
+        return false;
+    }
+
+    DirtyRect rects[DIRTY_MAX_RECTS + 1];
+    int rectCount = 0;
+    for (int i = 0; i < count; i++) {
+        uint8_t entry[12];
+        if (!readExact(s, entry, sizeof(entry))) return false;
+        int x = entry[0] | (entry[1] << 8);
+        int y = entry[2] | (entry[3] << 8);
+        int w = entry[4] | (entry[5] << 8);
+        int h = entry[6] | (entry[7] << 8);
+        int remaining = (int)le32(entry + 8);
+        if (((x | w) & 7) || w <= 0 || h <= 0 || x + w > ROW_BYTES * 8 || y + h > H) {
+            Serial.printf("[PATCH] rect %d,%d %dx%d out of bounds\n", x, y, w, h);
             return false;
         }
-        int avail = s->available();
-        if (avail > 0) {
-            int r = s->readBytes(buf + got, min(avail, len - got));
-            got += r;
-            t0 = millis();  // Reset timeout on progress
+        PackBitsDecoder dec;
+        packBitsBeginRect(&dec, imgBuf + y * ROW_BYTES + x / 8, ROW_BYTES, w / 8, h);
+        while (remaining > 0) {
+            int n = readSome(s, netChunk, min(remaining, NET_CHUNK));
+            if (n <= 0) {
+                Serial.printf("[PATCH] %s in rect %d\n", readErrorName(n), i);
+                return false;
+            }
+            remaining -= n;
+            if (!packBitsFeed(&dec, netChunk, n)) break;
         }
+        if (!packBitsDone(&dec)) {
+            Serial.printf("[PATCH] rect %d: decoded %d/%d bytes\n", i, dec.out, dec.dstLen);
+            return false;
+        }
+        DirtyRect r = {x, y, x + w, y + h};
+        rectCount = dirtyRectsAdd(rects, rectCount, DIRTY_MAX_RECTS, r);
+    }
+
+    frameHashCompute(hash, imgBuf, ROW_BYTES, H);
+    if (hash->frame != result) {
+        Serial.println("[PATCH] result hash mismatch");
+        return false;
     }
+    long area = dirtyRectsArea(rects, rectCount);
+    Serial.printf("[PATCH] OK  %d rect(s), %d%% of screen\n", count, (int)(area * 100 / ((long)W * H)));
+    displayPatchHint(base, result, rects, rectCount);
     return true;
 }
 
-static bool beginHttpForUrl(HTTPClient &http, WiFiClient &plainClient, WiFiClientSecure &secClient, const String &url) {
-    if (url.startsWith("https://")) {
-        secClient.setCACert(ROOT_CA);
-        return http.begin(secClient, url);
+bool restoreFetchedFrame() {
+    String etag = conditionalEtag();
+    return etag.length() > 0 && restoreNotModifiedFrame(etag);
+}
+
+// ── HTTP session ────────────────────────────────────────────
+// One keep-alive connection to cfgServer serves every request of a wake
+// cycle, so HTTPS pays for a single TLS handshake (and its ~40 KB of
+// mbedTLS buffers) instead of one per call.
+
+#if INKSIGHT_PROFILE
+// Times connection setup (TCP connect, TLS handshake) inside HTTPClient
+template <class Base>
+class TimedClient : public Base {
+public:
+    using Base::connect;
+    int connect(const char *host, uint16_t port, int32_t timeout) override {
+        profStart(PROF_CONNECT);
+        int ok = Base::connect(host, port, timeout);
+        profStop(PROF_CONNECT);
+        profSampleHeap();  // TLS buffers are allocated now
+        return ok;
+    }
+};
+static TimedClient<WiFiClient> sessionPlain;
+static TimedClient<WiFiClientSecure> sessionSecure;
+#else
+static WiFiClient sessionPlain;
+static WiFiClientSecure sessionSecure;
+#endif
+static HTTPClient sessionHttp;
+static bool sessionSecureReady = false;
+static unsigned long sessionLastUse = 0;
+
+static HTTPClient &httpSession() {
+    return sessionHttp;
+}
+
+WiFiClient &httpSessionClient(bool secure) {
+    if (secure && !sessionSecureReady) {
+        sessionSecure.setCACert(ROOT_CA);
+        sessionSecureReady = true;
     }
-    return http.begin(plainClient, url);
+    return secure ? static_cast<WiFiClient &>(sessionSecure) : sessionPlain;
 }
 
-static String extractJsonStringField(const String &body, const char *key) {
-    String needle = String("\"") + key + "\":\"";
-    int start = body.indexOf(needle);
-    if (start < 0) return "";
-    start += needle.length();
-    int end = body.indexOf('"', start);
-    if (end < 0) return "";
-    return body.substring(start, end);
+void httpSessionTouch() {
+    sessionLastUse = millis();
+}
+
+static bool beginHttpForUrl(HTTPClient &http, const char *url) {
+    pushChannelClose();  // a held long-poll would answer into this request
+    bool secure = strncmp(url, "https://", 8) == 0;
+    WiFiClient &client = httpSessionClient(secure);
+    // Servers drop idle keep-alive sockets after a few seconds; reconnect
+    // rather than fail the first request on a half-closed connection.
+    if (client.connected() && millis() - sessionLastUse > (unsigned long)HTTP_KEEPALIVE_IDLE_MS) {
+        client.stop();
+    }
+    http.setReuse(true);
+    return http.begin(client, url);
+}
+
+// Finish a request. The connection is kept for the next one only when the
+// response body has been read; a small unread body is drained here, a large
+// or partially streamed one closes the socket.
+static void httpEnd(HTTPClient &http, bool bodyRead) {
+    if (!bodyRead) {
+        int size = http.getSize();
+        if (size < 0 || size > HTTP_DRAIN_MAX || !skipBytes(http.getStreamPtr(), size)) {
+            http.setReuse(false);
+        }
+    }
+    http.end();
+    sessionLastUse = millis();
+}
+
+void httpSessionClose() {
+    sessionHttp.end();
+    sessionPlain.stop();
+    sessionSecure.stop();
+}
+
+// Scan a JSON response for the given top-level fields straight off the
+// socket (json_scan.h) and finish the request. The body is read to its end,
+// so the connection stays reusable. Returns true when the object parsed.
+static bool readJsonResponse(HTTPClient &http, JsonField *fields, int count) {
+    JsonScanner scanner;
+    jsonScanBegin(&scanner, fields, count);
+    int left = http.getSize();
+    if (left < 0) {
+        // Chunked / unknown length: buffer it through HTTPClient instead
+        String body = http.getString();
+        jsonScanFeed(&scanner, body.c_str(), body.length());
+        httpEnd(http, true);
+        return jsonScanDone(&scanner);
+    }
+    WiFiClient *stream = http.getStreamPtr();
+    while (left > 0) {
+        int r = readSome(stream, netChunk, min(left, NET_CHUNK));
+        if (r <= 0) {
+            Serial.printf("readJsonResponse: %s, %d left\n", readErrorName(r), left);
+            http.setReuse(false);
+            httpEnd(http, true);
+            return false;
+        }
+        jsonScanFeed(&scanner, (const char *)netChunk, r);
+        left -= r;
+    }
+    httpEnd(http, true);
+    return jsonScanDone(&scanner);
+}
+
+// Log a failed request (transport error, or the start of the error body)
+// and finish it.
+static void logErrorResponse(HTTPClient &http, const char *tag, int code) {
+    if (code < 0) {
+        Serial.printf("%s error: %s\n", tag, http.errorToString(code).c_str());
+        httpEnd(http, true);
+        return;
+    }
+    int size = http.getSize();
+    int n = 0;
+    if (size != 0) {
+        n = readSome(http.getStreamPtr(), netChunk, size > 0 ? min(size, 300) : 300);
+        if (n < 0) n = 0;
+    }
+    Serial.printf("%s response: %.*s\n", tag, n, (const char *)netChunk);
+    if (n != size) http.setReuse(false);
+    httpEnd(http, true);
 }
 
 static bool recoverDeviceTokenIfUnauthorized(int code) {
@@ -183,35 +721,56 @@ static bool recoverDeviceTokenIfUnauthorized(int code) {
     return ensureDeviceToken();
 }
 
+static bool heartbeatDue(unsigned long now) {
+    return lastHeartbeatAt == 0 || now - lastHeartbeatAt >= HEARTBEAT_INTERVAL_MS;
+}
+
 bool postHeartbeat(bool force) {
     if (WiFi.status() != WL_CONNECTED) return false;
     unsigned long now = millis();
-    if (!force && lastHeartbeatAt != 0 && now - lastHeartbeatAt < HEARTBEAT_INTERVAL_MS) {
+    if (!force && !heartbeatDue(now)) {
+        return true;
+    }
+    // Heartbeats are optional on a low battery; /api/render still reports the tier
+    PowerTier tier = powerTier();
+    if (tier == POWER_CRITICAL || (tier == POWER_LOW && !force)) {
         return true;
     }
     if (!ensureDeviceToken()) return false;
 
-    float v = readBatteryVoltage();
+    float v = powerVoltage();
     int rssi = WiFi.RSSI();
-    String mac = WiFi.macAddress();
-    String url = cfgServer + "/api/device/" + mac + "/heartbeat";
-    String body = String("{\"battery_voltage\":") + String(v, 2) + ",\"wifi_rssi\":" + String(rssi) + "}";
+    ReqBuilder body;
+    reqBegin(&body, reqBody, sizeof(reqBody));
+    reqAppendf(&body, "{\"battery_voltage\":%.2f,\"wifi_rssi\":%d", v, rssi);
+    reqAppendf(&body, ",\"power_tier\":\"%s\",\"runtime_hours\":%d",
+               powerTierName(tier), powerRuntimeHours());
+    char profile[PROF_SUMMARY_MAX];
+    bool withProfile = profPendingSummary(profile, sizeof(profile)) > 0;
+    if (withProfile) {
+        reqAppend(&body, ",\"wake_profile\":");
+        reqAppendJsonString(&body, profile);
+    }
+    reqAppend(&body, "}");
+    if (!reqReady(&body, "[HEARTBEAT]")) return false;
     for (int attempt = 0; attempt < 2; attempt++) {
-        WiFiClient plainClient;
-        WiFiClientSecure secClient;
-        HTTPClient http;
-        if (!beginHttpForUrl(http, plainClient, secClient, url)) return false;
+        ReqBuilder url;
+        deviceUrl(&url, "/heartbeat");
+        if (!reqReady(&url, "[HEARTBEAT]")) return false;
+        HTTPClient &http = httpSession();
+        if (!beginHttpForUrl(http, reqUrl)) return false;
         http.addHeader("Content-Type", "application/json");
         if (cfgDeviceToken.length() > 0) {
             http.addHeader("X-Device-Token", cfgDeviceToken);
         }
         http.setTimeout(HTTP_TIMEOUT);
 
-        int code = http.POST(body);
+        int code = http.POST((uint8_t *)reqBody, body.len);
         if (code >= 200 && code < 300) {
             Serial.printf("[HEARTBEAT] POST -> %d\n", code);
-            http.end();
+            httpEnd(http, false);
             lastHeartbeatAt = now;
+            if (withProfile) profMarkUploaded();
             return true;
         }
         if (code < 0) {
@@ -219,7 +778,7 @@ bool postHeartbeat(bool force) {
         } else {
             Serial.printf("[HEARTBEAT] POST -> %d\n", code);
         }
-        http.end();
+        httpEnd(http, false);
         if (!recoverDeviceTokenIfUnauthorized(code)) {
             return false;
         }
@@ -231,16 +790,15 @@ bool ensureDeviceToken() {
     if (cfgDeviceToken.length() > 0) return true;
     if (WiFi.status() != WL_CONNECTED) return false;
 
-    String mac = WiFi.macAddress();
-    String url = cfgServer + "/api/device/" + mac + "/token";
     delay(1200);
     for (int attempt = 0; attempt < 3; attempt++) {
         if (checkAbort()) return false;
-        Serial.printf("[TOKEN] POST %s (attempt %d/3)\n", url.c_str(), attempt + 1);
-        WiFiClient plainClient;
-        WiFiClientSecure secClient;
-        HTTPClient http;
-        if (!beginHttpForUrl(http, plainClient, secClient, url)) {
+        ReqBuilder url;
+        deviceUrl(&url, "/token");
+        if (!reqReady(&url, "[TOKEN]")) return false;
+        Serial.printf("[TOKEN] POST %s (attempt %d/3)\n", reqUrl, attempt + 1);
+        HTTPClient &http = httpSession();
+        if (!beginHttpForUrl(http, reqUrl)) {
             Serial.println("[TOKEN] begin failed");
             delay(800);
             continue;
@@ -248,28 +806,22 @@ bool ensureDeviceToken() {
         http.addHeader("Content-Type", "application/json");
         http.setTimeout(HTTP_TIMEOUT);
 
-        int code = http.POST("{}");
+        int code = http.POST((uint8_t *)"{}", 2);
         Serial.printf("[TOKEN] HTTP code: %d\n", code);
         if (code >= 200 && code < 300) {
-            String body = http.getString();
-            http.end();
-            String token = extractJsonStringField(body, "token");
-            if (token.length() == 0) {
-                Serial.println("[TOKEN] token field empty");
+            char token[96];
+            JsonField fields[] = {{"token", token, sizeof(token)}};
+            readJsonResponse(http, fields, 1);
+            if (token[0] == '\0' || fields[0].truncated) {
+                Serial.println(fields[0].truncated ? "[TOKEN] token too long" : "[TOKEN] token field empty");
                 delay(800);
                 continue;
             }
-            saveDeviceToken(token);
+            saveDeviceToken(String(token));
             Serial.println("[TOKEN] token saved");
             return true;
         }
-        if (code < 0) {
-            Serial.printf("[TOKEN] error: %s\n", http.errorToString(code).c_str());
-        } else {
-            String body = http.getString();
-            Serial.printf("[TOKEN] response: %s\n", body.substring(0, 300).c_str());
-        }
-        http.end();
+        logErrorResponse(http, "[TOKEN]", code);
         delay(800);
     }
     Serial.println("[TOKEN] failed to obtain device token");
@@ -283,21 +835,14 @@ bool fetchConfigFlags(bool *outFocusEnabled, bool *outAlwaysActive) {
     if (WiFi.status() != WL_CONNECTED) return false;
     if (!ensureDeviceToken()) return false;
 
-    String mac = WiFi.macAddress();
-    String url = cfgServer + "/api/config/" + mac;
-    bool useSSL = cfgServer.startsWith("https://");
-
     for (int attempt = 0; attempt < 2; attempt++) {
         if (checkAbort()) return false;
-        WiFiClient plainClient;
-        WiFiClientSecure secClient;
-        HTTPClient http;
-        if (useSSL) {
-            secClient.setCACert(ROOT_CA);
-            http.begin(secClient, url);
-        } else {
-            http.begin(plainClient, url);
-        }
+        ReqBuilder url;
+        reqBegin(&url, reqUrl, sizeof(reqUrl));
+        reqAppendf(&url, "%s/api/config/%s", cfgServer.c_str(), deviceMac());
+        if (!reqReady(&url, "[CONFIG]")) return false;
+        HTTPClient &http = httpSession();
+        beginHttpForUrl(http, reqUrl);
         http.setTimeout(HTTP_TIMEOUT);
         if (cfgDeviceToken.length() > 0) {
             http.addHeader("X-Device-Token", cfgDeviceToken);
@@ -305,23 +850,21 @@ bool fetchConfigFlags(bool *outFocusEnabled, bool *outAlwaysActive) {
 
         int code = http.GET();
         if (code != 200) {
-            http.end();
+            httpEnd(http, false);
             if (!recoverDeviceTokenIfUnauthorized(code)) return false;
             continue;
         }
 
-        String body = http.getString();
-        http.end();
-        bool focusEnabled =
-            body.indexOf("\"is_focus_listening\":true") >= 0 ||
-            body.indexOf("\"is_focus_listening\": true") >= 0 ||
-            body.indexOf("\"focus_listening\":1") >= 0 ||
-            body.indexOf("\"focus_listening\": 1") >= 0;
-        bool keepActive =
-            body.indexOf("\"is_always_active\":true") >= 0 ||
-            body.indexOf("\"is_always_active\": true") >= 0 ||
-            body.indexOf("\"always_active\":1") >= 0 ||
-            body.indexOf("\"always_active\": 1") >= 0;
+        char isFocus[8], focus[8], isActive[8], active[8];
+        JsonField fields[] = {
+            {"is_focus_listening", isFocus, sizeof(isFocus)},
+            {"focus_listening", focus, sizeof(focus)},
+            {"is_always_active", isActive, sizeof(isActive)},
+            {"always_active", active, sizeof(active)},
+        };
+        readJsonResponse(http, fields, 4);
+        bool focusEnabled = jsonFieldTrue(fields[0]) || jsonFieldTrue(fields[1]);
+        bool keepActive = jsonFieldTrue(fields[2]) || jsonFieldTrue(fields[3]);
         *outFocusEnabled = focusEnabled;
         *outAlwaysActive = keepActive;
         Serial.printf("[CONFIG] focus=%s always_active=%s\n",
@@ -332,25 +875,40 @@ bool fetchConfigFlags(bool *outFocusEnabled, bool *outAlwaysActive) {
     return false;
 }
 
-bool fetchFocusAlertBMP() {
+bool focusAlertAvailable() {
     if (WiFi.status() != WL_CONNECTED) return false;
     if (!ensureDeviceToken()) return false;
-    String mac = WiFi.macAddress();
-    String url = cfgServer + "/api/device/" + mac + "/alert-bmp"
-               + "?w=" + String(W) + "&h=" + String(H);
-    bool useSSL = cfgServer.startsWith("https://");
-
     for (int attempt = 0; attempt < 2; attempt++) {
         if (checkAbort()) return false;
-        WiFiClient plainClient;
-        WiFiClientSecure secClient;
-        HTTPClient http;
-        if (useSSL) {
-            secClient.setCACert(ROOT_CA);
-            http.begin(secClient, url);
-        } else {
-            http.begin(plainClient, url);
+        ReqBuilder url;
+        deviceUrl(&url, "/alert-bmp");
+        if (!reqReady(&url, "[FOCUS]")) return false;
+        HTTPClient &http = httpSession();
+        beginHttpForUrl(http, reqUrl);
+        http.setTimeout(HTTP_TIMEOUT);
+        if (cfgDeviceToken.length() > 0) {
+            http.addHeader("X-Device-Token", cfgDeviceToken);
         }
+
+        int code = http.sendRequest("HEAD");
+        httpEnd(http, true);  // HEAD responses carry no body
+        if (code == 200) return true;
+        if (!recoverDeviceTokenIfUnauthorized(code)) return false;
+    }
+    return false;
+}
+
+bool fetchFocusAlertBMP() {
+    if (WiFi.status() != WL_CONNECTED) return false;
+    if (!ensureDeviceToken()) return false;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (checkAbort()) return false;
+        ReqBuilder url;
+        deviceUrl(&url, "/alert-bmp");
+        reqAppendf(&url, "?w=%d&h=%d", W, H);
+        if (!reqReady(&url, "[FOCUS]")) return false;
+        HTTPClient &http = httpSession();
+        beginHttpForUrl(http, reqUrl);
         http.setTimeout(HTTP_TIMEOUT);
         if (cfgDeviceToken.length() > 0) {
             http.addHeader("X-Device-Token", cfgDeviceToken);
@@ -359,40 +917,31 @@ bool fetchFocusAlertBMP() {
         int code = http.GET();
         Serial.printf("[FOCUS] alert-bmp HTTP code: %d\n", code);
         if (code == 204) {
-            http.end();
+            httpEnd(http, false);
             return false;
         }
         if (code != 200) {
-            http.end();
+            httpEnd(http, false);
             if (!recoverDeviceTokenIfUnauthorized(code)) return false;
             continue;
         }
 
         WiFiClient *stream = http.getStreamPtr();
+        frameAcquire();
         uint8_t fileHeader[14];
         if (!readExact(stream, fileHeader, 14)) {
-            http.end();
+            httpEnd(http, false);
             return false;
         }
         uint32_t pixelOffset = fileHeader[10]
                              | ((uint32_t)fileHeader[11] << 8)
                              | ((uint32_t)fileHeader[12] << 16)
                              | ((uint32_t)fileHeader[13] << 24);
-        int toSkip = (int)pixelOffset - 14;
-        while (toSkip > 0 && stream->connected()) {
-            if (stream->available()) { stream->read(); toSkip--; }
-        }
-
-        uint8_t rowBuf[ROW_STRIDE];
-        for (int bmpY = 0; bmpY < H; bmpY++) {
-            if (!readExact(stream, rowBuf, ROW_STRIDE)) {
-                http.end();
-                return false;
-            }
-            int dispY = H - 1 - bmpY;
-            memcpy(imgBuf + dispY * ROW_BYTES, rowBuf, ROW_BYTES);
+        if (!skipBytes(stream, (int)pixelOffset - 14) || !readBmpRows(stream, imgBuf, false, nullptr)) {
+            httpEnd(http, false);
+            return false;
         }
-        http.end();
+        httpEnd(http, true);
         return true;
     }
     return false;
@@ -400,12 +949,15 @@ bool fetchFocusAlertBMP() {
 
 // ── Fetch BMP from backend ──────────────────────────────────
 
-bool fetchBMP(bool nextMode, bool *isFallback, bool *outForceRefresh) {
+bool fetchBMP(bool nextMode, bool *isFallback, bool *outForceRefresh, WakeReply *wake) {
     if (isFallback) *isFallback = false;
+    if (wake) {
+        wake->batched = false;
+        wake->runtimeMode = "";
+    }
     if (outForceRefresh) *outForceRefresh = false;
     if (!ensureDeviceToken()) return false;
-    float v = readBatteryVoltage();
-    String mac = WiFi.macAddress();
+    float v = powerVoltage();
     int rssi = WiFi.RSSI();
 #if EPD_BPP >= 2
     const int colorCapability = 4;
@@ -415,43 +967,62 @@ bool fetchBMP(bool nextMode, bool *isFallback, bool *outForceRefresh) {
 #if DEBUG_MODE
     int effectiveRefreshMin = DEBUG_REFRESH_MIN;
 #else
-    int effectiveRefreshMin = cfgSleepMin;
+    int effectiveRefreshMin = powerRefreshMin(cfgSleepMin);
 #endif
-    String url = cfgServer + "/api/render?v=" + String(v, 2)
-               + "&mac=" + mac + "&rssi=" + String(rssi)
-               + "&refresh_min=" + String(effectiveRefreshMin)
-               + "&w=" + String(W) + "&h=" + String(H)
-               + "&bpp=" + String(EPD_BPP)
-               + "&colors=" + String(colorCapability);
-    if (nextMode) {
-        url += "&next=1";
-    }
-    Serial.printf("GET %s (RSSI=%d)\n", url.c_str(), rssi);
-
-    bool useSSL = cfgServer.startsWith("https://");
-    for (int attempt = 0; attempt < 2; attempt++) {
+
+    bool allowPatch = FRAME_PATCHES;
+    int attempts = 2;
+    for (int attempt = 0; attempt < attempts; attempt++) {
         if (checkAbort()) return false;
-        WiFiClient plainClient;
-        WiFiClientSecure secClient;
-        HTTPClient http;
-        if (useSSL) {
-            secClient.setCACert(ROOT_CA);
-            http.begin(secClient, url);
-        } else {
-            http.begin(plainClient, url);
+        String sentEtag = conditionalEtag();
+        ReqBuilder url;
+        reqBegin(&url, reqUrl, sizeof(reqUrl));
+        reqAppendf(&url, "%s/api/render?v=%.2f&mac=%s&rssi=%d&refresh_min=%d",
+                   cfgServer.c_str(), v, deviceMac(), rssi, effectiveRefreshMin);
+        reqAppendf(&url, "&w=%d&h=%d&bpp=%d&colors=%d&fmt=packbits",
+                   W, H, EPD_BPP, colorCapability);
+        reqAppendf(&url, "&power=%s", powerTierName(powerTier()));
+        if (powerRuntimeHours() >= 0) {
+            reqAppendf(&url, "&runtime_h=%d", powerRuntimeHours());
         }
+        if (nextMode) {
+            reqAppend(&url, "&next=1");
+        }
+        // Sent even without a base, so the server keeps this frame for the next patch
+        if (allowPatch) {
+            reqAppend(&url, "&patch=1");
+        }
+        if (wake) {
+            reqAppend(&url, "&wake=1");
+            if (wake->runtime) reqAppendf(&url, "&runtime=%s", wake->runtime);
+        }
+        if (!reqReady(&url, "[RENDER]")) return false;
+        Serial.printf("GET %s (RSSI=%d)\n", reqUrl, rssi);
+
+        HTTPClient &http = httpSession();
+        beginHttpForUrl(http, reqUrl);
         http.setTimeout(HTTP_TIMEOUT);
         http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-        const char *headerKeys[] = {"X-Content-Fallback", "X-Refresh-Minutes", "X-Preview-Push"};
-        http.collectHeaders(headerKeys, 3);
+        const char *headerKeys[] = {
+            "X-Content-Fallback", "X-Refresh-Minutes", "X-Preview-Push",
+            "X-Frame-Encoding", "X-Frame-Bpp",
+            "X-Wake", "X-Focus-Listening", "X-Always-Active", "X-Runtime-Mode",
+            "X-InkSight-Mode"
+        };
+        http.collectHeaders(headerKeys, sizeof(headerKeys) / sizeof(headerKeys[0]));
 
         http.addHeader("Accept-Encoding", "identity");
         if (cfgDeviceToken.length() > 0) {
             http.addHeader("X-Device-Token", cfgDeviceToken);
         }
+        if (sentEtag.length() > 0) {
+            http.addHeader("If-None-Match", sentEtag);
+        }
 
         Serial.printf("Free heap: %d\n", ESP.getFreeHeap());
+        profStart(PROF_TTFB);
         int code = http.GET();
+        profStop(PROF_TTFB);
         Serial.printf("HTTP code: %d\n", code);
         if (isFallback) {
             String fallbackHeader = http.header("X-Content-Fallback");
@@ -466,6 +1037,15 @@ bool fetchBMP(bool nextMode, bool *isFallback, bool *outForceRefresh) {
             saveSleepMin(serverRefreshMin);
             Serial.printf("[RENDER] Applied refresh interval: %d min\n", serverRefreshMin);
         }
+        if (wake && http.header("X-Wake") == "1") {
+            wake->batched = true;
+            wake->focusListening = http.header("X-Focus-Listening") == "1";
+            wake->alwaysActive = http.header("X-Always-Active") == "1";
+            wake->runtimeMode = http.header("X-Runtime-Mode");
+            Serial.printf("[WAKE] focus=%d always_active=%d runtime=%s\n",
+                          wake->focusListening, wake->alwaysActive,
+                          wake->runtimeMode.length() > 0 ? wake->runtimeMode.c_str() : "-");
+        }
         if (outForceRefresh) {
             String previewPushHeader = http.header("X-Preview-Push");
             *outForceRefresh = (previewPushHeader == "1" || previewPushHeader == "true");
@@ -474,14 +1054,20 @@ bool fetchBMP(bool nextMode, bool *isFallback, bool *outForceRefresh) {
             }
         }
 
-        if (code != 200) {
-            if (code < 0) {
-                Serial.printf("HTTP error: %s\n", http.errorToString(code).c_str());
-            } else {
-                String body = http.getString();
-                Serial.printf("Response: %s\n", body.substring(0, 500).c_str());
+        if (code == 304) {
+            httpEnd(http, false);
+            if (restoreNotModifiedFrame(sentEtag)) {
+                Serial.println("[RENDER] 304 Not Modified, frame restored locally");
+                lastHeartbeatAt = millis();
+                return true;
             }
-            http.end();
+            Serial.println("[RENDER] 304 but local frame unavailable, refetching");
+            forgetFrameEtags();
+            continue;
+        }
+
+        if (code != 200) {
+            logErrorResponse(http, "[RENDER]", code);
             if (!recoverDeviceTokenIfUnauthorized(code)) {
                 return false;
             }
@@ -490,19 +1076,46 @@ bool fetchBMP(bool nextMode, bool *isFallback, bool *outForceRefresh) {
 
         int contentLen = http.getSize();
         Serial.printf("Content-Length: %d\n", contentLen);
+        strlcpy(fetchedMode, http.header("X-InkSight-Mode").c_str(), sizeof(fetchedMode));
 
         WiFiClient *stream = http.getStreamPtr();
+        frameAcquire();  // the body overwrites the frame buffer
+
+        if (http.header("X-Frame-Encoding") == "patch") {
+            bool ok = readFramePatch(stream, sentEtag, &fetchedFrameHash);
+            httpEnd(http, ok);
+            if (!ok) {
+                Serial.println("[RENDER] Patch not applicable, refetching full frame");
+                // imgBuf is half patched: the full frame always gets its own request
+                allowPatch = false;
+                attempts++;
+                continue;
+            }
+            rememberFrame();
+            lastHeartbeatAt = millis();
+            return true;
+        }
+
+        if (http.header("X-Frame-Encoding") == "packbits") {
+            bool ok = readPackedFrame(stream, contentLen, http.header("X-Frame-Bpp").toInt(), &fetchedFrameHash);
+            httpEnd(http, ok);
+            if (!ok) return false;
+            rememberFrame();
+            lastHeartbeatAt = millis();
+            return true;
+        }
 
 #if EPD_BPP >= 2
         if (contentLen == COLOR_BUF_LEN) {
-            if (!readExact(stream, colorBuf, COLOR_BUF_LEN)) {
+            if (!readRawRows(stream, colorBuf, COLOR_BUF_LEN, COLOR_ROW_BYTES, &fetchedFrameHash)) {
                 Serial.println("Failed to read 2bpp data");
-                http.end();
+                httpEnd(http, false);
                 return false;
             }
             useColorBuf = true;
-            http.end();
+            httpEnd(http, true);
             Serial.printf("2BPP OK  %d bytes\n", COLOR_BUF_LEN);
+            rememberFrame();
             lastHeartbeatAt = millis();
             return true;
         }
@@ -512,7 +1125,7 @@ bool fetchBMP(bool nextMode, bool *isFallback, bool *outForceRefresh) {
         uint8_t fileHeader[14];
         if (!readExact(stream, fileHeader, 14)) {
             Serial.println("Failed to read BMP header");
-            http.end();
+            httpEnd(http, false);
             return false;
         }
 
@@ -522,85 +1135,217 @@ bool fetchBMP(bool nextMode, bool *isFallback, bool *outForceRefresh) {
                              | ((uint32_t)fileHeader[13] << 24);
         Serial.printf("BMP pixel offset: %u\n", pixelOffset);
 
-        int toSkip = pixelOffset - 14;
-        while (toSkip > 0 && stream->connected()) {
-            if (stream->available()) { stream->read(); toSkip--; }
+        if (!skipBytes(stream, (int)pixelOffset - 14)) {
+            httpEnd(http, false);
+            return false;
         }
 
-        uint8_t rowBuf[ROW_STRIDE];
-        for (int bmpY = 0; bmpY < H; bmpY++) {
-            if (!readExact(stream, rowBuf, ROW_STRIDE)) {
-                Serial.printf("Failed to read row %d\n", bmpY);
-                http.end();
-                return false;
-            }
-            int dispY = H - 1 - bmpY;
-            memcpy(imgBuf + dispY * ROW_BYTES, rowBuf, ROW_BYTES);
+        bool streaming = displayStreamBegin(true);
+        if (!readBmpRows(stream, imgBuf, streaming, &fetchedFrameHash)) {
+            displayStreamEnd(false);
+            httpEnd(http, false);
+            return false;
         }
+        displayStreamEnd(true);
 
-        http.end();
+        httpEnd(http, true);
         Serial.printf("BMP OK  %d bytes\n", IMG_BUF_LEN);
+        rememberFrame();
         lastHeartbeatAt = millis();
         return true;
     }
     return false;
 }
 
+// ── Prefetch queue ──────────────────────────────────────────
+
+struct QueuedFrame {
+    uint32_t hash;
+    uint32_t displayAt;  // time(), seconds
+};
+
+static const int FRAME_QUEUE_MAX = PREFETCH_FRAMES > 0 ? PREFETCH_FRAMES : 1;
+static RTC_DATA_ATTR QueuedFrame frameQueue[FRAME_QUEUE_MAX];
+static RTC_DATA_ATTR int frameQueueLen = 0;
+
+static void popQueuedFrame() {
+    for (int i = 1; i < frameQueueLen; i++) frameQueue[i - 1] = frameQueue[i];
+    frameQueueLen--;
+}
+
+// Parse a batch body (format in docs/api.md): each PackBits frame is decoded
+// into imgBuf, checked against its hash and stored. Display times are moved
+// from the server clock to the device clock. *complete is set once the whole
+// body has been read.
+static int readFrameBatch(WiFiClient *s, bool *complete) {
+    *complete = false;
+    uint8_t hdr[12];
+    if (!readExact(s, hdr, sizeof(hdr)) || memcmp(hdr, "IKB1", 4) != 0) {
+        Serial.println("[BATCH] bad header");
+        return 0;
+    }
+    int count = hdr[4];
+    uint32_t serverNow = le32(hdr + 8);
+    uint32_t localNow = (uint32_t)time(nullptr);
+    int queued = 0;
+    for (int i = 0; i < count; i++) {
+        uint8_t entry[28];
+        if (!readExact(s, entry, sizeof(entry))) return queued;
+        uint32_t displayAt = le32(entry);
+        uint32_t hash = le32(entry + 4);
+        int len = (int)le32(entry + 8);
+        char mode[17];
+        memcpy(mode, entry + 12, 16);
+        mode[16] = '\0';
+
+        FrameHash frame;
+        if (!readPackedFrame(s, len, 1, &frame, false)) return queued;
+        if (frame.frame != hash) {
+            Serial.printf("[BATCH] %s: hash mismatch, skipped\n", mode);
+            continue;
+        }
+        if (queued < FRAME_QUEUE_MAX && cacheSave(imgBuf, IMG_BUF_LEN, mode, hash)) {
+            frameQueue[queued].hash = hash;
+            frameQueue[queued].displayAt = localNow + (displayAt - serverNow);
+            frameQueueLen = ++queued;
+            Serial.printf("[BATCH] %s queued, shows in %u s\n", mode, (unsigned)(displayAt - serverNow));
+        }
+    }
+    *complete = true;
+    return queued;
+}
+
+int fetchFrameBatch() {
+    clearFrameQueue();
+    // One store slot stays with the frame on screen
+    int want = min(PREFETCH_FRAMES, cacheSlots() - 1);
+    if (EPD_BPP >= 2 || want <= 0) return 0;
+    if (WiFi.status() != WL_CONNECTED) return 0;
+    if (!ensureDeviceToken()) return 0;
+    float v = powerVoltage();
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (checkAbort()) return 0;
+        ReqBuilder url;
+        reqBegin(&url, reqUrl, sizeof(reqUrl));
+        // The frames are spaced like the device's own (power-stretched) wakes
+        reqAppendf(&url, "%s/api/render/batch?mac=%s&count=%d&v=%.2f&w=%d&h=%d&refresh_min=%d&power=%s",
+                   cfgServer.c_str(), deviceMac(), want, v, W, H,
+                   powerRefreshMin(cfgSleepMin), powerTierName(powerTier()));
+        if (FRAME_PATCHES) reqAppend(&url, "&patch=1");
+        if (!reqReady(&url, "[BATCH]")) return 0;
+        HTTPClient &http = httpSession();
+        beginHttpForUrl(http, reqUrl);
+        http.setTimeout(HTTP_TIMEOUT);
+        http.addHeader("Accept-Encoding", "identity");
+        if (cfgDeviceToken.length() > 0) {
+            http.addHeader("X-Device-Token", cfgDeviceToken);
+        }
+
+        profStart(PROF_TTFB);
+        int code = http.GET();
+        profStop(PROF_TTFB);
+        if (code != 200) {
+            Serial.printf("[BATCH] HTTP %d\n", code);
+            httpEnd(http, false);
+            if (!recoverDeviceTokenIfUnauthorized(code)) return 0;
+            continue;
+        }
+        bool complete = false;
+        int queued = readFrameBatch(http.getStreamPtr(), &complete);
+        httpEnd(http, complete);
+        restoreFetchedFrame();  // the batch was decoded through imgBuf
+        Serial.printf("[BATCH] %d frame(s) queued\n", queued);
+        return queued;
+    }
+    return 0;
+}
+
+int queuedFrames() {
+    return frameQueueLen;
+}
+
+uint32_t nextQueuedFrameAt() {
+    if (frameQueueLen == 0) return 0;
+    uint32_t at = frameQueue[0].displayAt;
+    return at > (uint32_t)PREFETCH_SLACK_S ? at - PREFETCH_SLACK_S : 0;
+}
+
+bool queuedFrameDue() {
+    return frameQueueLen > 0 && (uint32_t)time(nullptr) + PREFETCH_SLACK_S >= frameQueue[0].displayAt;
+}
+
+bool loadQueuedFrame() {
+    uint32_t now = (uint32_t)time(nullptr) + PREFETCH_SLACK_S;
+    while (frameQueueLen > 1 && frameQueue[1].displayAt <= now) popQueuedFrame();
+    if (frameQueueLen == 0 || frameQueue[0].displayAt > now) return false;
+    uint32_t hash = frameQueue[0].hash;
+    popQueuedFrame();
+    frameAcquire();
+    if (!cacheLoadHash(imgBuf, IMG_BUF_LEN, hash)) return false;
+    frameHashCompute(&fetchedFrameHash, imgBuf, ROW_BYTES, H);
+    if (fetchedFrameHash.frame != hash) return false;
+    monoHash = hash;
+    monoValid = true;
+    monoLoaded = true;
+    return true;
+}
+
+void clearFrameQueue() {
+    frameQueueLen = 0;
+}
+
 bool hasPendingRemoteAction(bool *shouldExitLive) {
     if (WiFi.status() != WL_CONNECTED) return false;
     if (!ensureDeviceToken()) return false;
 
-    String mac = WiFi.macAddress();
-    String url = cfgServer + "/api/device/" + mac + "/state";
+    // Piggyback a due heartbeat on the poll instead of a separate POST
+    unsigned long now = millis();
+    bool withHeartbeat = heartbeatDue(now);
+    float v = withHeartbeat ? powerVoltage() : 0.0f;
+    int rssi = WiFi.RSSI();
 
-    bool useSSL = cfgServer.startsWith("https://");
     for (int attempt = 0; attempt < 2; attempt++) {
         if (checkAbort()) return false;
-        WiFiClient plainClient;
-        WiFiClientSecure secClient;
-        HTTPClient http;
-        if (useSSL) {
-            secClient.setCACert(ROOT_CA);
-            http.begin(secClient, url);
-        } else {
-            http.begin(plainClient, url);
+        ReqBuilder url;
+        deviceUrl(&url, "/state");
+        if (withHeartbeat) {
+            reqAppendf(&url, "?v=%.2f&rssi=%d", v, rssi);
         }
+        if (!reqReady(&url, "[STATE]")) return false;
+        HTTPClient &http = httpSession();
+        beginHttpForUrl(http, reqUrl);
         http.setTimeout(HTTP_TIMEOUT);
+        const char *headerKeys[] = {"X-Heartbeat"};
+        http.collectHeaders(headerKeys, 1);
         if (cfgDeviceToken.length() > 0) {
             http.addHeader("X-Device-Token", cfgDeviceToken);
         }
 
         int code = http.GET();
         if (code != 200) {
-            http.end();
+            httpEnd(http, false);
             if (!recoverDeviceTokenIfUnauthorized(code)) {
                 return false;
             }
             continue;
         }
 
-        String body = http.getString();
-        http.end();
+        if (withHeartbeat && http.header("X-Heartbeat") == "1") {
+            lastHeartbeatAt = now;
+        }
+        char runtimeMode[12], pendingRefresh[8], pendingMode[24];
+        JsonField fields[] = {
+            {"runtime_mode", runtimeMode, sizeof(runtimeMode)},
+            {"pending_refresh", pendingRefresh, sizeof(pendingRefresh)},
+            {"pending_mode", pendingMode, sizeof(pendingMode)},
+        };
+        readJsonResponse(http, fields, 3);
 
         if (shouldExitLive) {
-            bool intervalRequested =
-                body.indexOf("\"runtime_mode\":\"interval\"") >= 0 ||
-                body.indexOf("\"runtime_mode\": \"interval\"") >= 0;
-            *shouldExitLive = intervalRequested;
+            *shouldExitLive = strcmp(runtimeMode, "interval") == 0;
         }
-
-        bool pendingRefresh =
-            body.indexOf("\"pending_refresh\":1") >= 0 ||
-            body.indexOf("\"pending_refresh\": 1") >= 0 ||
-            body.indexOf("\"pending_refresh\":true") >= 0 ||
-            body.indexOf("\"pending_refresh\": true") >= 0;
-
-        bool pendingMode =
-            (body.indexOf("\"pending_mode\":\"") >= 0 || body.indexOf("\"pending_mode\": \"") >= 0) &&
-            body.indexOf("\"pending_mode\":\"\"") < 0 &&
-            body.indexOf("\"pending_mode\": \"\"") < 0;
-
-        return pendingRefresh || pendingMode;
+        return jsonFieldTrue(fields[1]) || jsonFieldPresent(fields[2]);
     }
     return false;
 }
@@ -612,34 +1357,33 @@ void postConfigToBackend() {
     if (!ensureDeviceToken()) return;
 
     // Inject MAC address into the config JSON
-    String mac = WiFi.macAddress();
-    String body = cfgConfigJson;
-    if (body.startsWith("{")) {
-        body = "{\"mac\":\"" + mac + "\"," + body.substring(1);
+    ReqBuilder body;
+    reqBegin(&body, reqBody, sizeof(reqBody));
+    const char *json = cfgConfigJson.c_str();
+    if (json[0] == '{') {
+        reqAppendf(&body, "{\"mac\":\"%s\",", deviceMac());
+        json++;
     }
+    reqAppend(&body, json);
+    if (!reqReady(&body, "[CONFIG]")) return;
 
-    String url = cfgServer + "/api/config";
-    bool useSSL = cfgServer.startsWith("https://");
     for (int attempt = 0; attempt < 2; attempt++) {
         if (checkAbort()) return;
-        WiFiClient plainClient;
-        WiFiClientSecure secClient;
-        HTTPClient http;
-        if (useSSL) {
-            secClient.setCACert(ROOT_CA);
-            http.begin(secClient, url);
-        } else {
-            http.begin(plainClient, url);
-        }
+        ReqBuilder url;
+        reqBegin(&url, reqUrl, sizeof(reqUrl));
+        reqAppendf(&url, "%s/api/config", cfgServer.c_str());
+        if (!reqReady(&url, "[CONFIG]")) return;
+        HTTPClient &http = httpSession();
+        beginHttpForUrl(http, reqUrl);
         http.addHeader("Content-Type", "application/json");
         http.setTimeout(HTTP_TIMEOUT);
         if (cfgDeviceToken.length() > 0) {
             http.addHeader("X-Device-Token", cfgDeviceToken);
         }
 
-        int code = http.POST(body);
+        int code = http.POST((uint8_t *)reqBody, body.len);
         Serial.printf("POST /api/config -> %d\n", code);
-        http.end();
+        httpEnd(http, false);
         if (!recoverDeviceTokenIfUnauthorized(code)) {
             return;
         }
@@ -650,28 +1394,26 @@ void postConfigToBackend() {
 
 bool postRuntimeMode(const char *mode) {
     if (!ensureDeviceToken()) return false;
-    String mac = WiFi.macAddress();
-    String url = cfgServer + "/api/device/" + mac + "/runtime";
-    bool useSSL = cfgServer.startsWith("https://");
-    String body = String("{\"mode\":\"") + mode + "\"}";
+    ReqBuilder body;
+    reqBegin(&body, reqBody, sizeof(reqBody));
+    reqAppend(&body, "{\"mode\":");
+    reqAppendJsonString(&body, mode);
+    reqAppend(&body, "}");
+    if (!reqReady(&body, "[RUNTIME]")) return false;
     for (int attempt = 0; attempt < 2; attempt++) {
-        WiFiClient plainClient;
-        WiFiClientSecure secClient;
-        HTTPClient http;
-        if (useSSL) {
-            secClient.setCACert(ROOT_CA);
-            http.begin(secClient, url);
-        } else {
-            http.begin(plainClient, url);
-        }
+        ReqBuilder url;
+        deviceUrl(&url, "/runtime");
+        if (!reqReady(&url, "[RUNTIME]")) return false;
+        HTTPClient &http = httpSession();
+        beginHttpForUrl(http, reqUrl);
         http.addHeader("Content-Type", "application/json");
         http.setTimeout(HTTP_TIMEOUT);
         if (cfgDeviceToken.length() > 0) {
             http.addHeader("X-Device-Token", cfgDeviceToken);
         }
 
-        int code = http.POST(body);
-        http.end();
+        int code = http.POST((uint8_t *)reqBody, body.len);
+        httpEnd(http, false);
 
         if (code == 404) {
             return true;
@@ -688,6 +1430,9 @@ bool postRuntimeMode(const char *mode) {
 
 // ── NTP time sync ───────────────────────────────────────────
 
+// The system clock keeps running through deep sleep; this marks it as set
+static RTC_DATA_ATTR bool clockSynced = false;
+
 void syncNTP() {
     configTime(NTP_UTC_OFFSET, 0, "ntp.aliyun.com", "pool.ntp.org");
     struct tm timeinfo;
@@ -695,13 +1440,28 @@ void syncNTP() {
         curHour = timeinfo.tm_hour;
         curMin  = timeinfo.tm_min;
         curSec  = timeinfo.tm_sec;
+        clockSynced = true;
         Serial.printf("NTP synced: %02d:%02d:%02d\n", curHour, curMin, curSec);
+    } else if (restoreClock()) {
+        Serial.printf("NTP failed, keeping clock: %02d:%02d:%02d\n", curHour, curMin, curSec);
     } else {
         curHour = 0; curMin = 0; curSec = 0;
         Serial.println("NTP failed, using 00:00:00");
     }
 }
 
+bool restoreClock() {
+    if (!clockSynced) return false;
+    // configTime()'s TZ setting does not survive deep sleep; apply the offset here
+    time_t local = time(nullptr) + NTP_UTC_OFFSET;
+    struct tm timeinfo;
+    gmtime_r(&local, &timeinfo);
+    curHour = timeinfo.tm_hour;
+    curMin  = timeinfo.tm_min;
+    curSec  = timeinfo.tm_sec;
+    return true;
+}
+
 // ── Software clock tick ─────────────────────────────────────
 
 void tickTime() {
@@ -2,24 +2,80 @@
 #define INKSIGHT_NETWORK_H
 
 #include <Arduino.h>
+#include "frame_hash.h"
 
 extern bool g_userAborted;
 
+// Tile/frame hash of the frame last loaded by fetchBMP() (downloaded, or
+// restored after a 304). Rows are hashed while they arrive.
+extern FrameHash fetchedFrameHash;
+
 // ── Time state (updated by syncNTP / tickTime) ──────────────
 extern int curHour, curMin, curSec;
 
 // ── WiFi ────────────────────────────────────────────────────
 
 // Connect to WiFi using stored credentials. Returns true on success.
-bool connectWiFi();
+// Pass heartbeat=false when a batched wake render follows (it logs one).
+bool connectWiFi(bool heartbeat = true);
 
 // ── HTTP ────────────────────────────────────────────────────
 
+// All backend requests share one keep-alive connection. Close it (and free
+// the TLS buffers) before WiFi goes down.
+void httpSessionClose();
+
+// Socket of that session, for the live-mode long-poll (push_channel.h), which
+// runs on it between requests so live mode holds one TLS session. Every
+// request first drops a poll the backend is still holding. Call
+// httpSessionTouch() after reading a complete response off the socket.
+class WiFiClient;
+WiFiClient &httpSessionClient(bool secure);
+void httpSessionTouch();
+
+// Batched wake: with a WakeReply, the render request also carries the
+// runtime mode and the response returns the config flags (X-Wake headers),
+// replacing GET /config, POST /runtime and the boot heartbeat. batched stays
+// false against a backend that ignores wake=1; fall back to those calls then.
+struct WakeReply {
+    const char *runtime;   // in: runtime mode the device enters after this wake
+    bool batched;
+    bool focusListening;
+    bool alwaysActive;
+    String runtimeMode;    // mode the backend recorded (always-active -> "active")
+};
+
 // Fetch BMP image from backend and store in imgBuf. Returns true on success.
 // If nextMode is true, appends &next=1 to request the next mode in sequence.
-bool fetchBMP(bool nextMode = false, bool *isFallback = nullptr, bool *outForceRefresh = nullptr);
+// Sends If-None-Match (the local frame hash) when a frame is available
+// locally; on 304 that frame is restored into imgBuf/colorBuf and verified.
+// Mono frames are saved to the offline cache.
+bool fetchBMP(bool nextMode = false, bool *isFallback = nullptr, bool *outForceRefresh = nullptr,
+              WakeReply *wake = nullptr);
+
+// Reload the last fetched frame after an overlay (focus alert): 2bpp frames
+// are still in colorBuf, mono frames come back from the offline cache.
+// Returns false when the frame is no longer available locally.
+bool restoreFetchedFrame();
+
+// ── Prefetch queue ──────────────────────────────────────────
+// Interval mode: upcoming frames (GET /api/render/batch) are stored in the
+// offline store and queued with their display times on the device clock
+// (RTC memory, survives deep sleep). Returns the number of frames queued;
+// the queue is replaced on every call. imgBuf holds the current frame again
+// afterwards.
+int fetchFrameBatch();
+int queuedFrames();
+bool queuedFrameDue();
+// Earliest time() the next queued frame may be shown (0 when none is queued)
+uint32_t nextQueuedFrameAt();
+// Load the due queued frame into imgBuf; it becomes the fetched frame.
+// Overdue frames are skipped. False when none could be loaded.
+bool loadQueuedFrame();
+void clearFrameQueue();
 
 // Check whether backend has pending refresh/switch request for this device.
+// A due heartbeat rides along on the poll.
 // If shouldExitLive is not null, it is set to true when backend runtime_mode is interval.
 bool hasPendingRemoteAction(bool *shouldExitLive = nullptr);
 
@@ -34,18 +90,20 @@ bool postHeartbeat(bool force = false);
 
 // ── Config flag helpers ─────────────────────────────────────
 bool fetchConfigFlags(bool *outFocusEnabled, bool *outAlwaysActive);
+// HEAD /alert-bmp: true when a focus alert is waiting (does not consume it)
+bool focusAlertAvailable();
+// Download the waiting focus alert into imgBuf (consumes it)
 bool fetchFocusAlertBMP();
 
-// ── Battery ─────────────────────────────────────────────────
-
-// Read battery voltage via ADC (returns volts)
-float readBatteryVoltage();
-
 // ── NTP time ────────────────────────────────────────────────
 
 // Sync time from NTP servers
 void syncNTP();
 
+// Set the time state from the system clock, which keeps running through deep
+// sleep. False until an NTP sync has succeeded since power-up.
+bool restoreClock();
+
 // Advance software clock by one second
 void tickTime();
 
@@ -1,8 +1,100 @@
 #include "offline_cache.h"
+#include "config.h"
+#include "frame_hash.h"
+#include "profiler.h"
 #include <LittleFS.h>
 
-static const char *CACHE_FILE = "/cache.bmp";
+static const char *INDEX_FILE = "/frames.idx";
+static const char *INDEX_TMP  = "/frames.tmp";
+static const char *PANEL_FILE = "/panel.bin";
+static const char *LEGACY_CACHE_FILE = "/cache.bmp";  // single-frame cache of older firmware
+
+static const uint32_t INDEX_MAGIC = 0x49584631;  // "IXF1"
+static const uint32_t FRAME_MAGIC = 0x464D4631;  // "FMF1"
+static const size_t FS_BLOCK = 4096;
+static const size_t FS_RESERVE = 4 * FS_BLOCK;   // index, metadata and copy-on-write room
+
+struct FrameFileHeader {
+    uint32_t magic;
+    uint16_t width;
+    uint16_t height;
+    uint8_t  bpp;
+    uint8_t  reserved[3];
+    uint32_t len;
+    uint32_t hash;   // frame hash (frame_hash.h), the backend ETag
+    uint32_t crc;    // CRC32 of the pixel data
+};
+
+struct CacheSlot {
+    uint32_t hash;
+    uint32_t seq;    // last use; 0 = empty slot
+    char mode[24];
+};
+
+struct CacheIndex {
+    uint32_t magic;
+    uint16_t width;
+    uint16_t height;
+    uint8_t  bpp;
+    uint8_t  reserved[3];
+    uint32_t seq;
+    CacheSlot slot[CACHE_SLOTS_MAX];
+    uint32_t crc;    // CRC32 of everything above
+};
+
 static bool fsReady = false;
+static int slotCount = 1;
+static CacheIndex idx;
+
+static uint32_t indexCrc(const CacheIndex &index) {
+    return crc32Update(0, (const uint8_t *)&index, offsetof(CacheIndex, crc));
+}
+
+static void slotPath(int i, char *path, size_t cap) {
+    snprintf(path, cap, "/frame%d.bin", i);
+}
+
+static void resetIndex() {
+    memset(&idx, 0, sizeof(idx));
+    idx.magic = INDEX_MAGIC;
+    idx.width = W;
+    idx.height = H;
+    idx.bpp = 1;
+}
+
+static bool saveIndex() {
+    idx.crc = indexCrc(idx);
+    File f = LittleFS.open(INDEX_TMP, "w");
+    if (!f) {
+        Serial.println("Cache index write failed: cannot open file");
+        return false;
+    }
+    size_t written = f.write((const uint8_t *)&idx, sizeof(idx));
+    f.close();
+    // rename() replaces the old index atomically: a power cut leaves either one
+    if (written != sizeof(idx) || !LittleFS.rename(INDEX_TMP, INDEX_FILE)) {
+        Serial.println("Cache index write failed");
+        return false;
+    }
+    return true;
+}
+
+static void loadIndex() {
+    File f = LittleFS.open(INDEX_FILE, "r");
+    bool ok = false;
+    if (f) {
+        ok = f.readBytes((char *)&idx, sizeof(idx)) == sizeof(idx)
+             && idx.magic == INDEX_MAGIC && idx.crc == indexCrc(idx)
+             && idx.width == W && idx.height == H && idx.bpp == 1;
+        f.close();
+    }
+    if (!ok) {
+        if (f) Serial.println("Cache index invalid or for another panel, resetting");
+        resetIndex();
+    }
+    // Slots beyond the current capacity are forgotten
+    for (int i = slotCount; i < CACHE_SLOTS_MAX; i++) idx.slot[i].seq = 0;
+}
 
 bool cacheInit() {
     if (!LittleFS.begin(true)) {  // true = format on failure
@@ -10,37 +102,221 @@ bool cacheInit() {
         return false;
     }
     fsReady = true;
-    Serial.println("LittleFS ready");
+    if (LittleFS.exists(LEGACY_CACHE_FILE)) LittleFS.remove(LEGACY_CACHE_FILE);
+
+    size_t fileBlocks = (sizeof(FrameFileHeader) + IMG_BUF_LEN + FS_BLOCK - 1) / FS_BLOCK;
+    size_t total = LittleFS.totalBytes();
+    size_t reserve = FS_RESERVE + fileBlocks * FS_BLOCK;  // panel snapshot
+    int fit = total > reserve ? (int)((total - reserve) / (fileBlocks * FS_BLOCK)) : 0;
+    slotCount = constrain(fit, 1, CACHE_SLOTS_MAX);
+    loadIndex();
+    Serial.printf("LittleFS ready, frame store %d slots, %d frames\n", slotCount, cacheCount());
     return true;
 }
 
-bool cacheSave(const uint8_t *buf, int len) {
-    if (!fsReady) return false;
-    File f = LittleFS.open(CACHE_FILE, "w");
+// ── Slot files ──────────────────────────────────────────────
+
+static bool writeFrameFile(const char *path, const uint8_t *buf, int len, uint32_t hash) {
+    FrameFileHeader hdr = {};
+    hdr.magic = FRAME_MAGIC;
+    hdr.width = W;
+    hdr.height = H;
+    hdr.bpp = 1;
+    hdr.len = len;
+    hdr.hash = hash;
+    hdr.crc = crc32Update(0, buf, len);
+
+    File f = LittleFS.open(path, "w");
     if (!f) {
         Serial.println("Cache write failed: cannot open file");
         return false;
     }
-    size_t written = f.write(buf, len);
+    size_t written = f.write((const uint8_t *)&hdr, sizeof(hdr));
+    written += f.write(buf, len);
     f.close();
-    Serial.printf("Cache saved: %d bytes\n", written);
-    return (int)written == len;
+    return written == sizeof(hdr) + (size_t)len;
 }
 
-bool cacheLoad(uint8_t *buf, int len) {
-    if (!fsReady) return false;
-    File f = LittleFS.open(CACHE_FILE, "r");
-    if (!f) {
-        Serial.println("No cache file found");
-        return false;
+static bool writeSlot(int i, const uint8_t *buf, int len, uint32_t hash) {
+    char path[24];
+    slotPath(i, path, sizeof(path));
+    return writeFrameFile(path, buf, len, hash);
+}
+
+// Stream a frame file to fn in row-aligned chunks, checking header and CRC
+static bool readFrameRows(const char *path, uint32_t hash, void (*fn)(const uint8_t *row, void *ctx), void *ctx) {
+    File f = LittleFS.open(path, "r");
+    if (!f) return false;
+    FrameFileHeader hdr;
+    bool ok = f.readBytes((char *)&hdr, sizeof(hdr)) == sizeof(hdr)
+              && hdr.magic == FRAME_MAGIC && hdr.width == W && hdr.height == H && hdr.bpp == 1
+              && hdr.len == (uint32_t)IMG_BUF_LEN && hdr.hash == hash;
+    uint8_t chunk[ROW_BYTES * 8];
+    uint32_t crc = 0;
+    for (int y = 0; ok && y < H; y += 8) {
+        int rows = min(8, H - y);
+        size_t n = (size_t)rows * ROW_BYTES;
+        ok = f.readBytes((char *)chunk, n) == n;
+        if (!ok) break;
+        crc = crc32Update(crc, chunk, n);
+        for (int r = 0; r < rows; r++) fn(chunk + r * ROW_BYTES, ctx);
     }
-    size_t read = f.readBytes((char *)buf, len);
     f.close();
-    Serial.printf("Cache loaded: %d bytes\n", read);
-    return (int)read == len;
+    return ok && crc == hdr.crc;
+}
+
+static bool readSlot(int i, uint8_t *buf, int len) {
+    char path[24];
+    slotPath(i, path, sizeof(path));
+    File f = LittleFS.open(path, "r");
+    if (!f) return false;
+    FrameFileHeader hdr;
+    bool ok = f.readBytes((char *)&hdr, sizeof(hdr)) == sizeof(hdr)
+              && hdr.magic == FRAME_MAGIC && hdr.width == W && hdr.height == H && hdr.bpp == 1
+              && hdr.len == (uint32_t)len && hdr.hash == idx.slot[i].hash
+              && f.readBytes((char *)buf, len) == (size_t)len
+              && crc32Update(0, buf, len) == hdr.crc;
+    f.close();
+    return ok;
+}
+
+static bool loadSlot(int i, uint8_t *buf, int len) {
+    if (readSlot(i, buf, len)) {
+        Serial.printf("Cache loaded: slot %d (%s)\n", i, idx.slot[i].mode);
+        return true;
+    }
+    Serial.printf("Cache slot %d failed integrity check, dropped\n", i);
+    idx.slot[i].seq = 0;
+    saveIndex();
+    return false;
 }
 
-bool cacheExists() {
+// cacheSave() without the timing: reuse or replace a slot, then the index
+static bool storeFrame(const uint8_t *buf, int len, const char *mode, uint32_t hash) {
+    int target = -1;
+    for (int i = 0; i < slotCount; i++) {
+        if (idx.slot[i].seq != 0 && idx.slot[i].hash == hash) {
+            // Already stored: only its age changes
+            if (idx.slot[i].seq != idx.seq) {
+                idx.slot[i].seq = ++idx.seq;
+                saveIndex();
+            }
+            Serial.printf("Cache hit: slot %d unchanged\n", i);
+            return true;
+        }
+        if (mode[0] && idx.slot[i].seq != 0 && strcmp(idx.slot[i].mode, mode) == 0) target = i;
+    }
+    if (target < 0) {
+        target = 0;
+        for (int i = 1; i < slotCount; i++) {
+            if (idx.slot[i].seq < idx.slot[target].seq) target = i;
+        }
+    }
+
+    // Drop the slot from the index first so a torn write is never listed
+    if (idx.slot[target].seq != 0) {
+        idx.slot[target].seq = 0;
+        saveIndex();
+    }
+    if (!writeSlot(target, buf, len, hash)) {
+        Serial.println("Cache write failed");
+        return false;
+    }
+    idx.slot[target].hash = hash;
+    idx.slot[target].seq = ++idx.seq;
+    strlcpy(idx.slot[target].mode, mode, sizeof(idx.slot[target].mode));
+    if (!saveIndex()) return false;
+    Serial.printf("Cache saved: slot %d (%s), %d bytes\n", target, idx.slot[target].mode, len);
+    return true;
+}
+
+// ── Public API ──────────────────────────────────────────────
+
+bool cacheSave(const uint8_t *buf, int len, const char *mode, uint32_t hash) {
+    if (!fsReady || len != IMG_BUF_LEN) return false;
+    profStart(PROF_FLASH);
+    bool ok = storeFrame(buf, len, mode ? mode : "", hash);
+    profStop(PROF_FLASH);
+    return ok;
+}
+
+bool cacheLoadHash(uint8_t *buf, int len, uint32_t hash) {
     if (!fsReady) return false;
-    return LittleFS.exists(CACHE_FILE);
+    for (int i = 0; i < slotCount; i++) {
+        if (idx.slot[i].seq != 0 && idx.slot[i].hash == hash) return loadSlot(i, buf, len);
+    }
+    return false;
+}
+
+bool cacheLoadRecent(int n, uint8_t *buf, int len, char *mode, size_t modeCap) {
+    if (!fsReady) return false;
+    // n-th newest: the slot with exactly n used slots newer than it
+    for (int i = 0; i < slotCount; i++) {
+        if (idx.slot[i].seq == 0) continue;
+        int newer = 0;
+        for (int j = 0; j < slotCount; j++) {
+            if (idx.slot[j].seq > idx.slot[i].seq) newer++;
+        }
+        if (newer != n) continue;
+        if (mode && modeCap > 0) strlcpy(mode, idx.slot[i].mode, modeCap);
+        return loadSlot(i, buf, len);
+    }
+    return false;
+}
+
+int cacheCount() {
+    int n = 0;
+    for (int i = 0; i < slotCount; i++) {
+        if (idx.slot[i].seq != 0) n++;
+    }
+    return n;
+}
+
+int cacheSlots() {
+    return fsReady ? slotCount : 0;
+}
+
+bool cacheNewest(uint32_t *hash) {
+    int best = -1;
+    for (int i = 0; i < slotCount; i++) {
+        if (idx.slot[i].seq != 0 && (best < 0 || idx.slot[i].seq > idx.slot[best].seq)) best = i;
+    }
+    if (best < 0) return false;
+    *hash = idx.slot[best].hash;
+    return true;
+}
+
+bool cacheSavePanel(const uint8_t *buf, int len, uint32_t hash) {
+    if (!fsReady || len != IMG_BUF_LEN) return false;
+    for (int i = 0; i < slotCount; i++) {
+        if (idx.slot[i].seq != 0 && idx.slot[i].hash == hash) return true;
+    }
+    File f = LittleFS.open(PANEL_FILE, "r");
+    if (f) {
+        FrameFileHeader hdr;
+        bool same = f.readBytes((char *)&hdr, sizeof(hdr)) == sizeof(hdr)
+                    && hdr.magic == FRAME_MAGIC && hdr.hash == hash && hdr.len == (uint32_t)len;
+        f.close();
+        if (same) return true;
+    }
+    profStart(PROF_FLASH);
+    bool ok = writeFrameFile(PANEL_FILE, buf, len, hash);
+    profStop(PROF_FLASH);
+    if (!ok) {
+        Serial.println("Panel snapshot write failed");
+        LittleFS.remove(PANEL_FILE);
+    }
+    return ok;
+}
+
+bool cacheReadRows(uint32_t hash, void (*fn)(const uint8_t *row, void *ctx), void *ctx) {
+    if (!fsReady) return false;
+    for (int i = 0; i < slotCount; i++) {
+        if (idx.slot[i].seq != 0 && idx.slot[i].hash == hash) {
+            char path[24];
+            slotPath(i, path, sizeof(path));
+            return readFrameRows(path, hash, fn, ctx);
+        }
+    }
+    return readFrameRows(PANEL_FILE, hash, fn, ctx);
 }
@@ -3,16 +3,48 @@
 
 #include <Arduino.h>
 
-// Initialize LittleFS filesystem
+// ── Offline frame store ─────────────────────────────────────
+// Recent frames live in LittleFS slots (/frame<N>.bin), one per mode, listed
+// in an index file (/frames.idx) with their frame hash and age. Every slot
+// file carries a header (resolution, bpp, length, hash) and a CRC32 of the
+// pixel data, so a torn write or a frame from a different panel build is
+// rejected instead of displayed. The slot count follows from the frame size
+// and the filesystem size (at most CACHE_SLOTS_MAX).
+
+#ifndef CACHE_SLOTS_MAX
+#define CACHE_SLOTS_MAX 4
+#endif
+
+// Initialize LittleFS and load the frame store index
 bool cacheInit();
 
-// Save current imgBuf to flash cache
-bool cacheSave(const uint8_t *buf, int len);
+// Store a frame under its mode and frame hash. A frame that is already
+// stored is not rewritten; a new one replaces the slot of the same mode, or
+// else the least recently used slot.
+bool cacheSave(const uint8_t *buf, int len, const char *mode, uint32_t hash);
+
+// Load the stored frame with this frame hash
+bool cacheLoadHash(uint8_t *buf, int len, uint32_t hash);
+
+// Load the n-th most recently used frame (0 = newest). mode receives its
+// mode id when not null. A slot that fails its integrity check is dropped.
+bool cacheLoadRecent(int n, uint8_t *buf, int len, char *mode = nullptr, size_t modeCap = 0);
+
+// Number of stored frames, and of available slots
+int cacheCount();
+int cacheSlots();
+
+// Frame hash of the most recently used frame; false when the store is empty
+bool cacheNewest(uint32_t *hash);
 
-// Load cached image into imgBuf, returns true if cache exists
-bool cacheLoad(uint8_t *buf, int len);
+// Snapshot of the frame the panel shows (with overlays such as the period
+// label), kept outside the slots so the next wake can put it back into
+// controller RAM. Not written when a slot already holds that frame.
+bool cacheSavePanel(const uint8_t *buf, int len, uint32_t hash);
 
-// Check if cache file exists
-bool cacheExists();
+// Pass the stored frame with this hash (a slot or the panel snapshot) to fn
+// row by row, top-down, without a frame buffer. Returns false when it is
+// missing or fails its CRC; fn may have seen rows by then.
+bool cacheReadRows(uint32_t hash, void (*fn)(const uint8_t *row, void *ctx), void *ctx);
 
 #endif
@@ -0,0 +1,94 @@
+#include "pixel_ops.h"
+
+// ── BMP row reader ──────────────────────────────────────────
+
+void bmpRowsBegin(BmpRowReader *r, uint8_t *image, int rowBytes, int stride, int rows) {
+    r->image = image;
+    r->rowBytes = rowBytes;
+    r->stride = stride;
+    r->rows = rows;
+    r->bmpY = 0;
+    r->col = 0;
+}
+
+int bmpRowsFeed(BmpRowReader *r, const uint8_t *src, int len, int *doneRow) {
+    *doneRow = -1;
+    if (r->bmpY >= r->rows) return 0;
+    int take = min(len, r->stride - r->col);
+    int y = r->rows - 1 - r->bmpY;
+    uint8_t *dst = r->image + y * r->rowBytes;
+    if (r->col < r->rowBytes) {
+        memcpy(dst + r->col, src, min(take, r->rowBytes - r->col));
+    }
+    r->col += take;
+    if (r->col == r->stride) {
+        *doneRow = y;
+        r->col = 0;
+        r->bmpY++;
+    }
+    return take;
+}
+
+int bmpRowsRemaining(const BmpRowReader *r) {
+    return (r->rows - r->bmpY) * r->stride - r->col;
+}
+
+// ── Mono -> 2bpp expansion ──────────────────────────────────
+
+void mono2bppBuildLut(uint16_t lut[256], const uint8_t *remap) {
+    for (int v = 0; v < 256; v++) {
+        uint16_t word = 0;
+        for (int bit = 0; bit < 8; bit++) {
+            if (v & (0x80 >> bit)) word |= 0x01 << (14 - bit * 2);
+        }
+        if (remap) word = (remap[word >> 8] << 8) | remap[word & 0xFF];
+        lut[v] = word;
+    }
+}
+
+void mono2bppPackRow(const uint16_t lut[256], const uint8_t *src, uint8_t *dst, int srcBytes) {
+    for (int i = 0; i < srcBytes; i++) {
+        uint16_t word = lut[src[i]];
+        dst[i * 2] = word >> 8;
+        dst[i * 2 + 1] = word & 0xFF;
+    }
+}
+
+void remapRow(const uint8_t lut[256], const uint8_t *src, uint8_t *dst, int len) {
+    for (int i = 0; i < len; i++) dst[i] = lut[src[i]];
+}
+
+// ── 90° rotation ────────────────────────────────────────────
+
+void transpose8x8(const uint8_t *in, int inStride, uint8_t *out, int outStride) {
+    uint32_t x = ((uint32_t)in[0] << 24) | ((uint32_t)in[inStride] << 16) |
+                 ((uint32_t)in[2 * inStride] << 8) | in[3 * inStride];
+    uint32_t y = ((uint32_t)in[4 * inStride] << 24) | ((uint32_t)in[5 * inStride] << 16) |
+                 ((uint32_t)in[6 * inStride] << 8) | in[7 * inStride];
+    uint32_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AAu;  x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AAu;  y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCCu; x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCCu; y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0u) | ((y >> 4) & 0x0F0F0F0Fu);
+    y = ((x << 4) & 0xF0F0F0F0u) | (y & 0x0F0F0F0Fu);
+    x = t;
+    out[0] = x >> 24;             out[outStride] = x >> 16;
+    out[2 * outStride] = x >> 8;  out[3 * outStride] = x;
+    out[4 * outStride] = y >> 24; out[5 * outStride] = y >> 16;
+    out[6 * outStride] = y >> 8;  out[7 * outStride] = y;
+}
+
+void rotateBand(const uint8_t *source, int rowBytes, int width, int bx0, int bx1,
+                int y0, int y1, uint8_t *band) {
+    int outBytes = (y1 - y0) / 8;
+    int bandTop = width - bx1 * 8;
+    for (int bx = bx0; bx < bx1; bx++) {
+        // source column bx*8 + k becomes panel row width - 1 - bx*8 - k
+        uint8_t *out = band + (width - 1 - bx * 8 - bandTop) * outBytes;
+        for (int by = y0 / 8; by < y1 / 8; by++) {
+            transpose8x8(source + by * 8 * rowBytes + bx, rowBytes,
+                         out + (by - y0 / 8), -outBytes);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef INKSIGHT_PIXEL_OPS_H
+#define INKSIGHT_PIXEL_OPS_H
+
+#include <Arduino.h>
+
+// ── Frame pixel kernels ─────────────────────────────────────
+// The CPU-bound row loops of the download and panel paths, kept free of
+// board dependencies so the native env (test/) can check and benchmark them
+// at every panel size.
+
+// ── BMP row reader ──────────────────────────────────────────
+// Copies a bottom-up 1bpp BMP pixel array, fed in arbitrary chunks, straight
+// into a top-down image; the 4-byte stride padding of every row is dropped.
+
+struct BmpRowReader {
+    uint8_t *image;
+    int rowBytes;   // image row length
+    int stride;     // BMP row length (rowBytes rounded up to 4)
+    int rows;
+    int bmpY;       // BMP rows completed so far
+    int col;        // byte offset inside the current BMP row
+};
+
+void bmpRowsBegin(BmpRowReader *r, uint8_t *image, int rowBytes, int stride, int rows);
+
+// Consume input up to the end of the current row at most. Returns the bytes
+// used; *doneRow is set to the image row (top-down) just completed, or -1.
+int bmpRowsFeed(BmpRowReader *r, const uint8_t *src, int len, int *doneRow);
+
+// Input bytes still expected
+int bmpRowsRemaining(const BmpRowReader *r);
+
+// ── Mono -> 2bpp expansion (JD79668 / RY683 data plane) ─────
+// A mono byte (8 pixels, 1 = white) becomes a 16-bit word of 2-bit pixels
+// with white = 01, black = 00. remap, when given, is a per-byte LUT applied
+// to both halves of every word (panel color codes).
+
+void mono2bppBuildLut(uint16_t lut[256], const uint8_t *remap);
+
+// dst receives 2 * srcBytes bytes
+void mono2bppPackRow(const uint16_t lut[256], const uint8_t *src, uint8_t *dst, int srcBytes);
+
+// dst[i] = lut[src[i]]
+void remapRow(const uint8_t lut[256], const uint8_t *src, uint8_t *dst, int len);
+
+// ── 90° rotation (landscape frame -> portrait controller RAM) ──
+// Landscape (x, y) lands on panel (y, width - 1 - x). An 8x8 pixel block is
+// eight source bytes, rotated by one bit-matrix transpose.
+
+// Transpose an 8x8 bit block: out row k, bit 7-j = in row j, bit 7-k.
+// Rows are inStride / outStride bytes apart (outStride may be negative).
+void transpose8x8(const uint8_t *in, int inStride, uint8_t *out, int outStride);
+
+// Rotate source byte columns [bx0, bx1) of rows [y0, y1) (multiples of 8) of
+// a width x H frame into band: (bx1 - bx0) * 8 panel rows of (y1 - y0) / 8
+// bytes, the top one being panel row width - bx1 * 8.
+void rotateBand(const uint8_t *source, int rowBytes, int width, int bx0, int bx1,
+                int y0, int y1, uint8_t *band);
+
+#endif // INKSIGHT_PIXEL_OPS_H
@@ -2,13 +2,14 @@
 #include "config.h"
 #include "storage.h"
 #include "network.h"
+#include "power_manager.h"
 
 #include <WiFi.h>
 #include <WebServer.h>
 #include <DNSServer.h>
 #include <esp_system.h>
 
-#include "../data/portal_html.h"
+#include "../data/portal_html_gz.h"  // embed_portal.py, pre-build
 
 // ── Portal state ────────────────────────────────────────────
 bool portalActive    = false;
@@ -21,13 +22,25 @@ static unsigned long restartAtMillis = 0;
 
 static WebServer webServer(80);
 static DNSServer dnsServer;
+static const char *PORTAL_HEADER_KEYS[] = {"If-None-Match"};
+
+// ── WiFi scan cache ─────────────────────────────────────────
+// An async scan starts when the AP comes up. /scan answers from the cached
+// result at once and starts a background rescan when it is stale, so DNS and
+// HTTP keep being served while the radio scans.
+static const int PORTAL_SCAN_MAX = 32;
+static const unsigned long PORTAL_SCAN_MAX_AGE_MS = 30000UL;
+
+static String scanJson = "";  // networks array of the last scan
+static unsigned long scanDoneAt = 0;
+static bool scanRunning = false;
 
 // ── Input validation helpers ────────────────────────────────
 
 static const int PORTAL_MAX_SSID   = 32;
 static const int PORTAL_MAX_PASS   = 64;
 static const int PORTAL_MAX_URL    = 200;
-static const int PORTAL_MAX_CONFIG = 2048;
+static const int PORTAL_MAX_CONFIG = CONFIG_JSON_MAX;
 
 static String sanitizeInput(const String &input, int maxLen) {
     String result = input.substring(0, maxLen);
@@ -86,6 +99,92 @@ static void resetPortalProvisioningState() {
     WiFi.mode(WIFI_AP_STA);
 }
 
+static uint32_t ssidHash(const char *s) {
+    uint32_t h = 2166136261u;
+    while (*s) h = (h ^ (uint8_t)*s++) * 16777619u;  // FNV-1a
+    return h;
+}
+
+static void appendJsonString(String &out, const String &s) {
+    out += '"';
+    for (unsigned int i = 0; i < s.length(); i++) {
+        char c = s.charAt(i);
+        if ((uint8_t)c < 0x20) {
+            // SSIDs are raw bytes; control characters are invalid in JSON strings
+            char esc[7];
+            snprintf(esc, sizeof(esc), "\\u%04x", (uint8_t)c);
+            out += esc;
+            continue;
+        }
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    out += '"';
+}
+
+// Strongest entry per SSID, strongest first
+static void cacheScanResults(int n) {
+    struct NetInfo { int index; uint32_t hash; int rssi; bool secure; };
+    NetInfo best[PORTAL_SCAN_MAX];
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        String ssid = WiFi.SSID(i);
+        if (ssid.length() == 0) continue;
+        NetInfo net = { i, ssidHash(ssid.c_str()), (int)WiFi.RSSI(i),
+                        WiFi.encryptionType(i) != WIFI_AUTH_OPEN };
+        int found = -1;
+        for (int j = 0; j < count && found < 0; j++) {
+            if (best[j].hash == net.hash && WiFi.SSID(best[j].index) == ssid) found = j;
+        }
+        if (found >= 0) {
+            if (net.rssi > best[found].rssi) best[found] = net;
+        } else if (count < PORTAL_SCAN_MAX) {
+            best[count++] = net;
+        }
+    }
+    for (int i = 1; i < count; i++) {
+        NetInfo net = best[i];
+        int j = i;
+        for (; j > 0 && best[j - 1].rssi < net.rssi; j--) best[j] = best[j - 1];
+        best[j] = net;
+    }
+
+    String json = "[";
+    for (int i = 0; i < count; i++) {
+        if (i > 0) json += ",";
+        json += "{\"ssid\":";
+        appendJsonString(json, WiFi.SSID(best[i].index));
+        json += ",\"rssi\":" + String(best[i].rssi);
+        json += ",\"secure\":" + String(best[i].secure ? "true" : "false") + "}";
+    }
+    json += "]";
+    scanJson = json;
+    Serial.printf("WiFi scan: %d networks, %d unique\n", n, count);
+}
+
+static void startWifiScan() {
+    if (scanRunning) return;
+    if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) {
+        Serial.println("WiFi scan failed to start");
+        return;
+    }
+    scanRunning = true;
+}
+
+static void pollWifiScan() {
+    if (!scanRunning) return;
+    int n = WiFi.scanComplete();
+    if (n == WIFI_SCAN_RUNNING) return;
+    scanRunning = false;
+    scanDoneAt = millis();
+    if (n >= 0) {
+        cacheScanResults(n);
+    } else {
+        Serial.println("WiFi scan failed");
+    }
+    WiFi.scanDelete();
+}
+
 // ── Start captive portal ────────────────────────────────────
 
 void startCaptivePortal() {
@@ -101,65 +200,37 @@ void startCaptivePortal() {
                   apName.c_str(), WiFi.softAPIP().toString().c_str());
 
     dnsServer.start(53, "*", WiFi.softAPIP());
+    startWifiScan();
 
     // ── Route: Portal home page ─────────────────────────────
+    // Pre-compressed; the browser revalidates it by ETag
     webServer.on("/", HTTP_GET, []() {
-        webServer.send(200, "text/html", PORTAL_HTML);
+        webServer.sendHeader("Cache-Control", "no-cache");
+        webServer.sendHeader("ETag", PORTAL_HTML_ETAG);
+        if (webServer.header("If-None-Match") == PORTAL_HTML_ETAG) {
+            webServer.send(304);
+            return;
+        }
+        webServer.sendHeader("Content-Encoding", "gzip");
+        webServer.send_P(200, "text/html", (const char *)PORTAL_HTML_GZ, PORTAL_HTML_GZ_LEN);
     });
 
     // ── Route: WiFi network scan ────────────────────────────
     webServer.on("/scan", HTTP_GET, []() {
-        Serial.println("Scanning WiFi networks...");
-        int n = WiFi.scanNetworks();
-        Serial.printf("Found %d networks\n", n);
-
-        // Deduplicate by SSID, keeping the strongest signal
-        struct NetInfo { String ssid; int rssi; bool secure; };
-        NetInfo best[32];
-        int count = 0;
-        for (int i = 0; i < n; i++) {
-            String ssid = WiFi.SSID(i);
-            if (ssid.length() == 0) continue;
-            int rssi = WiFi.RSSI(i);
-            bool secure = (WiFi.encryptionType(i) != WIFI_AUTH_OPEN);
-            int found = -1;
-            for (int j = 0; j < count; j++) {
-                if (best[j].ssid == ssid) { found = j; break; }
-            }
-            if (found >= 0) {
-                if (rssi > best[found].rssi) {
-                    best[found].rssi = rssi;
-                    best[found].secure = secure;
-                }
-            } else if (count < 32) {
-                best[count++] = { ssid, rssi, secure };
-            }
-        }
-
-        // Sort by signal strength (strongest first)
-        for (int i = 0; i < count - 1; i++)
-            for (int j = i + 1; j < count; j++)
-                if (best[j].rssi > best[i].rssi) {
-                    NetInfo tmp = best[i]; best[i] = best[j]; best[j] = tmp;
-                }
-
-        String json = "{\"networks\":[";
-        for (int i = 0; i < count; i++) {
-            if (i > 0) json += ",";
-            json += "{\"ssid\":\"" + best[i].ssid + "\",";
-            json += "\"rssi\":" + String(best[i].rssi) + ",";
-            json += "\"secure\":" + String(best[i].secure ? "true" : "false") + "}";
+        pollWifiScan();
+        if (scanJson.length() == 0 || millis() - scanDoneAt >= PORTAL_SCAN_MAX_AGE_MS) {
+            startWifiScan();
         }
-        json += "]}";
-
+        String json = "{\"networks\":" + (scanJson.length() > 0 ? scanJson : String("[]"));
+        json += ",\"scanning\":" + String(scanRunning ? "true" : "false") + "}";
         webServer.sendHeader("Access-Control-Allow-Origin", "*");
+        webServer.sendHeader("Cache-Control", "no-store");
         webServer.send(200, "application/json", json);
-        Serial.printf("Scan response sent (%d unique networks)\n", count);
     });
 
     // ── Route: Device info ──────────────────────────────────
     webServer.on("/info", HTTP_GET, []() {
-        float v = readBatteryVoltage();
+        float v = powerVoltage();
         String json = "{\"mac\":\"" + WiFi.macAddress() + "\",";
         json += "\"battery\":\"" + String(v, 2) + "V\",";
         json += "\"server_url\":\"" + cfgServer + "\"}";
@@ -217,6 +288,13 @@ void startCaptivePortal() {
         wifiConnecting = true;
         lastWifiError  = "";
 
+        // The station cannot join while a scan is hopping channels
+        unsigned long scanWaitAt = millis();
+        while (scanRunning && millis() - scanWaitAt < 5000UL) {
+            delay(50);
+            pollWifiScan();
+        }
+
         WiFi.mode(WIFI_AP_STA);
         WiFi.begin(ssid.c_str(), pass.c_str());
 
@@ -236,6 +314,7 @@ void startCaptivePortal() {
             Serial.printf("WiFi OK  IP=%s\n", WiFi.localIP().toString().c_str());
             String pairCode = generatePairCode();
             savePendingPairCode(pairCode);
+            configFlush();  // survive a power cut before the restart
             Serial.printf("[PAIR] local pair code: %s\n", pairCode.c_str());
             String response = String("{\"ok\":true,\"pair_code\":\"") + pairCode + "\"}";
             Serial.printf("Sending response: %s\n", response.c_str());
@@ -279,6 +358,7 @@ void startCaptivePortal() {
             return;
         }
         saveUserConfig(config);
+        configFlush();
         Serial.println("Config saved to NVS");
         webServer.send(200, "application/json", "{\"ok\":true}");
 
@@ -299,6 +379,7 @@ void startCaptivePortal() {
         Serial.println("\n--- /restart Request Received ---");
         webServer.send(200, "application/json", "{\"ok\":true}");
         Serial.println("Manual restart requested, restarting in 1 second...");
+        configFlush();
         delay(1000);
         ESP.restart();
     });
@@ -333,6 +414,7 @@ void startCaptivePortal() {
         webServer.send(302, "text/plain", "");
     });
 
+    webServer.collectHeaders(PORTAL_HEADER_KEYS, 1);
     webServer.begin();
     portalActive = true;
     Serial.println("Captive portal started");
@@ -343,10 +425,12 @@ void startCaptivePortal() {
 void handlePortalClients() {
     dnsServer.processNextRequest();
     webServer.handleClient();
+    pollWifiScan();
 
     // Deferred restart after config save
     if (pendingRestart && millis() >= restartAtMillis) {
         Serial.println("Deferred restart triggered");
+        configFlush();
         delay(200);
         ESP.restart();
     }
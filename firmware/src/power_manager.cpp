@@ -0,0 +1,175 @@
+#include "power_manager.h"
+#include "config.h"
+#include "storage.h"
+
+#include <time.h>
+
+static const uint32_t POWER_LOG_MAGIC = 0x50574C31;  // "PWL1"
+static const int POWER_LOG_LEN = 12;                 // 48 h at one point per 4 h
+static const time_t TIME_VALID = 1600000000;         // time() was set by NTP (kept through deep sleep)
+static const int CHARGE_STEP_MV = 100;               // a point this far above the last: charged, restart
+static const uint32_t ESTIMATE_MIN_SPAN_S = 12UL * 3600UL;
+
+struct PowerLog {
+    uint32_t magic;
+    uint32_t at[POWER_LOG_LEN];  // time() of each point, oldest first
+    uint16_t mv[POWER_LOG_LEN];
+    uint8_t count;
+    uint8_t tier;                // PowerTier, kept for the hysteresis
+};
+
+static RTC_DATA_ATTR PowerLog powerLog;
+static int lastMv = -1;  // -1: not sampled during this boot
+static unsigned long sampledAt = 0;
+static int runtimeHours = -1;
+
+// Mean of 16 ADC reads without the two highest and two lowest
+static int sampleMillivolts() {
+    if (PIN_BAT_ADC < 0) return 0;
+    const int SAMPLES = 16;
+    int lo0 = 4096, lo1 = 4096, hi0 = -1, hi1 = -1;
+    long sum = 0;
+    for (int i = 0; i < SAMPLES; i++) {
+        int r = analogRead(PIN_BAT_ADC);
+        sum += r;
+        if (r < lo0) {
+            lo1 = lo0;
+            lo0 = r;
+        } else if (r < lo1) {
+            lo1 = r;
+        }
+        if (r > hi0) {
+            hi1 = hi0;
+            hi0 = r;
+        } else if (r > hi1) {
+            hi1 = r;
+        }
+        delayMicroseconds(100);
+    }
+    float avgRaw = (float)(sum - lo0 - lo1 - hi0 - hi1) / (SAMPLES - 4);
+    return (int)(avgRaw * (3300.0f / 4095.0f) * 2.0f + 0.5f);  // 1:2 divider
+}
+
+static void resetLog() {
+    memset(&powerLog, 0, sizeof(powerLog));
+    powerLog.magic = POWER_LOG_MAGIC;
+}
+
+// The RTC copy survives deep sleep; after a power loss the NVS mirror is used
+static void ensureLog() {
+    if (powerLog.magic == POWER_LOG_MAGIC && powerLog.count <= POWER_LOG_LEN) return;
+    if (loadPowerLog(&powerLog, sizeof(powerLog)) == sizeof(powerLog) &&
+        powerLog.magic == POWER_LOG_MAGIC && powerLog.count <= POWER_LOG_LEN) {
+        return;
+    }
+    resetLog();
+}
+
+static void logPoint(int mv) {
+    time_t now = time(nullptr);
+    if (now < TIME_VALID) return;
+    if (powerLog.count > 0) {
+        int last = powerLog.count - 1;
+        if ((uint32_t)now < powerLog.at[last] || mv > powerLog.mv[last] + CHARGE_STEP_MV) {
+            uint8_t tier = powerLog.tier;
+            resetLog();
+            powerLog.tier = tier;
+        } else if ((uint32_t)now - powerLog.at[last] < POWER_LOG_PERIOD_S) {
+            return;
+        }
+    }
+    if (powerLog.count == POWER_LOG_LEN) {
+        memmove(powerLog.at, powerLog.at + 1, sizeof(powerLog.at[0]) * (POWER_LOG_LEN - 1));
+        memmove(powerLog.mv, powerLog.mv + 1, sizeof(powerLog.mv[0]) * (POWER_LOG_LEN - 1));
+        powerLog.count--;
+    }
+    powerLog.at[powerLog.count] = (uint32_t)now;
+    powerLog.mv[powerLog.count] = (uint16_t)mv;
+    powerLog.count++;
+    savePowerLog(&powerLog, sizeof(powerLog));
+}
+
+// Least-squares drain rate over the history, extrapolated to POWER_EMPTY_MV
+static int estimateHours(int mv) {
+    int n = powerLog.count;
+    if (n < 3 || powerLog.at[n - 1] - powerLog.at[0] < ESTIMATE_MIN_SPAN_S) return -1;
+    float mx = 0, my = 0;
+    for (int i = 0; i < n; i++) {
+        mx += (powerLog.at[i] - powerLog.at[0]) / 3600.0f;
+        my += powerLog.mv[i];
+    }
+    mx /= n;
+    my /= n;
+    float sxy = 0, sxx = 0;
+    for (int i = 0; i < n; i++) {
+        float dx = (powerLog.at[i] - powerLog.at[0]) / 3600.0f - mx;
+        sxy += dx * (powerLog.mv[i] - my);
+        sxx += dx * dx;
+    }
+    float slope = sxy / sxx;  // mV per hour
+    if (slope > -0.1f) return -1;  // flat or charging
+    if (mv <= POWER_EMPTY_MV) return 0;
+    return (int)min((mv - POWER_EMPTY_MV) / -slope, 9999.0f);
+}
+
+// Leaving a tier upwards needs POWER_HYSTERESIS_MV of recovery
+static PowerTier tierFor(int mv, int hours, PowerTier current) {
+    if (mv < POWER_NO_BATTERY_MV) return POWER_NORMAL;
+    int lowMv = POWER_LOW_MV + (current >= POWER_LOW ? POWER_HYSTERESIS_MV : 0);
+    int criticalMv = POWER_CRITICAL_MV + (current >= POWER_CRITICAL ? POWER_HYSTERESIS_MV : 0);
+    bool known = hours >= 0;
+    if (mv < criticalMv || (known && hours < POWER_CRITICAL_HOURS)) return POWER_CRITICAL;
+    if (mv < lowMv || (known && hours < POWER_LOW_HOURS)) return POWER_LOW;
+    return POWER_NORMAL;
+}
+
+bool powerUpdate(bool force) {
+    unsigned long now = millis();
+    if (!force && lastMv >= 0 && now - sampledAt < POWER_SAMPLE_MS) return false;
+    ensureLog();
+    lastMv = sampleMillivolts();
+    sampledAt = now;
+    if (lastMv >= POWER_NO_BATTERY_MV) logPoint(lastMv);
+    runtimeHours = lastMv >= POWER_NO_BATTERY_MV ? estimateHours(lastMv) : -1;
+
+    PowerTier old = (PowerTier)powerLog.tier;
+    PowerTier tier = tierFor(lastMv, runtimeHours, old);
+    powerLog.tier = tier;
+    if (tier != old || force) {
+        Serial.printf("[POWER] %d mV, ~%d h left, tier %s\n", lastMv, runtimeHours, powerTierName(tier));
+    }
+    return tier != old;
+}
+
+float powerVoltage() {
+    if (lastMv < 0) powerUpdate(true);
+    return lastMv / 1000.0f;
+}
+
+PowerTier powerTier() {
+    if (lastMv < 0) powerUpdate(true);
+    return (PowerTier)powerLog.tier;
+}
+
+const char *powerTierName(PowerTier tier) {
+    switch (tier) {
+    case POWER_LOW: return "low";
+    case POWER_CRITICAL: return "critical";
+    default: return "normal";
+    }
+}
+
+int powerRuntimeHours() {
+    if (lastMv < 0) powerUpdate(true);
+    return runtimeHours;
+}
+
+int powerRefreshMin(int minutes) {
+    PowerTier tier = powerTier();
+    int stretch = tier == POWER_CRITICAL ? POWER_CRITICAL_STRETCH : tier == POWER_LOW ? POWER_LOW_STRETCH : 1;
+    return min(minutes * stretch, 1440);
+}
+
+int powerGhostBudgetPct() {
+    return powerTier() == POWER_NORMAL ? 100 : POWER_GHOST_BUDGET_PCT;
+}
@@ -0,0 +1,40 @@
+#ifndef INKSIGHT_POWER_MANAGER_H
+#define INKSIGHT_POWER_MANAGER_H
+
+#include <Arduino.h>
+
+// ── Power manager ───────────────────────────────────────────
+// The battery is sampled once per wake before WiFi starts and then at most
+// every POWER_SAMPLE_MS. One point per POWER_LOG_PERIOD_S goes into a short
+// voltage history in RTC memory (mirrored to NVS for power loss); its slope
+// gives the remaining runtime. Voltage and runtime select the power tier,
+// which callers check before optional work (thresholds in config.h) and
+// which is reported to the backend with render requests and heartbeats.
+
+enum PowerTier : uint8_t {
+    POWER_NORMAL,
+    POWER_LOW,
+    POWER_CRITICAL,
+};
+
+// Sample the battery when due (force: now) and update the tier. Returns true
+// when the tier changed.
+bool powerUpdate(bool force = false);
+
+// Last battery sample in volts, 0 without battery sense
+float powerVoltage();
+
+PowerTier powerTier();
+const char *powerTierName(PowerTier tier);
+
+// Estimated hours until POWER_EMPTY_MV; -1 while unknown (history too short,
+// charging, no battery)
+int powerRuntimeHours();
+
+// Refresh interval in minutes for the current tier (stretched, at most 1440)
+int powerRefreshMin(int minutes);
+
+// Ghosting budget for the current tier, in percent of GHOST_BUDGET
+int powerGhostBudgetPct();
+
+#endif // INKSIGHT_POWER_MANAGER_H
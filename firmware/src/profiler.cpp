@@ -0,0 +1,116 @@
+#include "profiler.h"
+
+#if INKSIGHT_PROFILE
+
+static const char *const SPAN_NAMES[PROF_SPAN_COUNT] = {
+    "wifi", "dhcp", "conn", "ttfb", "body", "dec", "spi", "busy", "flash",
+};
+
+struct ProfRecord {
+    uint32_t seq;
+    char reason[8];
+    uint32_t totalMs;
+    uint16_t spanMs[PROF_SPAN_COUNT];  // saturates at 65535
+    uint32_t minFreeHeap;              // since boot
+    uint32_t minLargestBlock;          // lowest sample this cycle
+};
+
+// Ring of the last cycles; RTC memory keeps it across deep sleep
+static RTC_DATA_ATTR ProfRecord ring[PROF_CYCLES];
+static RTC_DATA_ATTR uint32_t lastSeq = 0;
+static RTC_DATA_ATTR uint32_t uploadedSeq = 0;
+static uint32_t summarySeq = 0;
+
+static bool cycleOpen = false;
+static char cycleReason[8];
+static unsigned long cycleStartUs = 0;
+static uint32_t spanUs[PROF_SPAN_COUNT];
+static unsigned long spanStartUs[PROF_SPAN_COUNT];
+static bool spanActive[PROF_SPAN_COUNT];
+static uint32_t largestBlock = 0;
+
+void profCycleBegin(const char *reason) {
+    cycleOpen = true;
+    strlcpy(cycleReason, reason, sizeof(cycleReason));
+    cycleStartUs = micros();
+    memset(spanUs, 0, sizeof(spanUs));
+    memset(spanActive, 0, sizeof(spanActive));
+    largestBlock = UINT32_MAX;
+}
+
+void profStart(ProfSpan span) {
+    if (spanActive[span]) return;  // a retry keeps the first start
+    spanStartUs[span] = micros();
+    spanActive[span] = true;
+}
+
+void profStop(ProfSpan span) {
+    if (!spanActive[span]) return;
+    spanActive[span] = false;
+    spanUs[span] += micros() - spanStartUs[span];
+}
+
+void profAddUs(ProfSpan span, uint32_t us) {
+    spanUs[span] += us;
+}
+
+void profSampleHeap() {
+    uint32_t block = ESP.getMaxAllocHeap();
+    if (block < largestBlock) largestBlock = block;
+}
+
+void profCycleEnd() {
+    if (!cycleOpen) return;
+    cycleOpen = false;
+    profSampleHeap();
+
+    ProfRecord &r = ring[lastSeq % PROF_CYCLES];
+    r.seq = ++lastSeq;
+    strlcpy(r.reason, cycleReason, sizeof(r.reason));
+    r.totalMs = (micros() - cycleStartUs) / 1000;
+    for (int i = 0; i < PROF_SPAN_COUNT; i++) {
+        uint32_t ms = (spanUs[i] + 500) / 1000;
+        r.spanMs[i] = ms > 0xFFFF ? 0xFFFF : (uint16_t)ms;
+    }
+    r.minFreeHeap = ESP.getMinFreeHeap();
+    r.minLargestBlock = largestBlock;
+
+    Serial.printf("[PROF] #%u %s %ums:", (unsigned)r.seq, r.reason, (unsigned)r.totalMs);
+    for (int i = 0; i < PROF_SPAN_COUNT; i++) {
+        if (r.spanMs[i]) Serial.printf(" %s=%u", SPAN_NAMES[i], r.spanMs[i]);
+    }
+    Serial.printf(" heap=%u/%u\n", (unsigned)r.minFreeHeap, (unsigned)r.minLargestBlock);
+}
+
+// ── Heartbeat summary ───────────────────────────────────────
+
+int profPendingSummary(char *buf, size_t cap) {
+    size_t len = 0;
+    buf[0] = '\0';
+    summarySeq = uploadedSeq;
+    uint32_t first = lastSeq > PROF_CYCLES ? lastSeq - PROF_CYCLES + 1 : 1;
+    if (first <= uploadedSeq) first = uploadedSeq + 1;
+    for (uint32_t seq = first; seq <= lastSeq; seq++) {
+        const ProfRecord &r = ring[(seq - 1) % PROF_CYCLES];
+        if (r.seq != seq) continue;
+        char entry[128];
+        int n = snprintf(entry, sizeof(entry), "%s%u:%s:%u:", len ? ";" : "",
+                         (unsigned)r.seq, r.reason, (unsigned)r.totalMs);
+        for (int i = 0; i < PROF_SPAN_COUNT; i++) {
+            n += snprintf(entry + n, sizeof(entry) - n, i ? "/%u" : "%u", r.spanMs[i]);
+        }
+        n += snprintf(entry + n, sizeof(entry) - n, ":%u/%u",
+                      (unsigned)r.minFreeHeap, (unsigned)r.minLargestBlock);
+        if (len + n + 1 > cap) break;  // the rest goes with the next heartbeat
+        memcpy(buf + len, entry, n + 1);
+        len += n;
+        summarySeq = seq;
+    }
+    return (int)len;
+}
+
+void profMarkUploaded() {
+    uploadedSeq = summarySeq;
+}
+
+#endif // INKSIGHT_PROFILE
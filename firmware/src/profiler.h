@@ -0,0 +1,65 @@
+#ifndef INKSIGHT_PROFILER_H
+#define INKSIGHT_PROFILER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ── Wake-cycle profiler (INKSIGHT_PROFILE) ──────────────────
+// Named spans accumulate time over one refresh cycle (a wake, or a refresh
+// while awake). Spans may nest: connect is part of ttfb, decode is part of
+// body. At the end of a cycle a record with the span totals, the cycle
+// length and the heap low-water marks goes into a ring in RTC memory (it
+// survives deep sleep); records not yet uploaded ride along on the next
+// heartbeat. With INKSIGHT_PROFILE=0 every call compiles to nothing.
+
+enum ProfSpan : uint8_t {
+    PROF_WIFI,      // WiFi association
+    PROF_DHCP,      // association -> IP address
+    PROF_CONNECT,   // TCP connect + TLS handshake
+    PROF_TTFB,      // request sent -> response headers parsed
+    PROF_BODY,      // response body transfer
+    PROF_DECODE,    // PackBits / BMP row decode
+    PROF_SPI,       // panel RAM writes
+    PROF_BUSY,      // panel refresh (BUSY asserted)
+    PROF_FLASH,     // NVS and LittleFS writes
+    PROF_SPAN_COUNT,
+};
+
+#if INKSIGHT_PROFILE
+
+#ifndef PROF_CYCLES
+#define PROF_CYCLES 8
+#endif
+
+// Start a cycle; reason is a short tag of what started it ("boot", "timer"...)
+void profCycleBegin(const char *reason);
+// Close the cycle and store its record (no-op when none is open)
+void profCycleEnd();
+
+void profStart(ProfSpan span);
+void profStop(ProfSpan span);
+void profAddUs(ProfSpan span, uint32_t us);
+
+// Record the current free heap and largest free block if lower than before
+void profSampleHeap();
+
+// Compact text of the records not uploaded yet (format in docs/api.md).
+// Returns the length written, 0 when there is nothing new.
+int profPendingSummary(char *buf, size_t cap);
+// The records of the last summary reached the backend
+void profMarkUploaded();
+
+#else
+
+static inline void profCycleBegin(const char *) {}
+static inline void profCycleEnd() {}
+static inline void profStart(ProfSpan) {}
+static inline void profStop(ProfSpan) {}
+static inline void profAddUs(ProfSpan, uint32_t) {}
+static inline void profSampleHeap() {}
+static inline int profPendingSummary(char *, size_t) { return 0; }
+static inline void profMarkUploaded() {}
+
+#endif
+
+#endif // INKSIGHT_PROFILER_H
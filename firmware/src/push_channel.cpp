@@ -0,0 +1,222 @@
+#include "push_channel.h"
+#include "config.h"
+#include "storage.h"
+#include "json_scan.h"
+#include "network.h"
+
+#include <WiFi.h>
+#include <esp_wifi.h>
+
+// The poll runs on the HTTP session socket (network.h), so live mode holds a
+// single connection (and, over HTTPS, a single set of TLS buffers).
+static WiFiClient *pushClient = nullptr;
+static bool pushWaiting = false;  // request written, response outstanding
+static bool pushReused = false;   // request went out on a kept-alive socket
+static unsigned long pushSentAt = 0;
+static bool pushSleepSet = false;
+static wifi_ps_type_t pushSleepPrev = WIFI_PS_NONE;
+
+// Modem power save only while the backend holds a poll; the previous mode
+// comes back as soon as it answers, so HTTP transfers keep their throughput.
+static void modemSleepBegin() {
+    if (pushSleepSet) return;
+    if (esp_wifi_get_ps(&pushSleepPrev) != ESP_OK) return;
+    WiFi.setSleep(true);
+    pushSleepSet = true;
+}
+
+static void modemSleepEnd() {
+    if (!pushSleepSet) return;
+    esp_wifi_set_ps(pushSleepPrev);
+    pushSleepSet = false;
+}
+
+// The socket is left in an unknown protocol state: close it
+static void dropSocket() {
+    if (pushClient) pushClient->stop();
+    pushWaiting = false;
+    modemSleepEnd();
+}
+
+// ── Server URL ──────────────────────────────────────────────
+
+struct ServerAddr {
+    bool tls;
+    String host;
+    uint16_t port;
+    String basePath;  // path prefix of cfgServer, without trailing '/'
+};
+
+static bool parseServer(const String &url, ServerAddr *out) {
+    out->tls = url.startsWith("https://");
+    int start = url.indexOf("://");
+    start = start < 0 ? 0 : start + 3;
+    int slash = url.indexOf('/', start);
+    String hostPort = slash < 0 ? url.substring(start) : url.substring(start, slash);
+    out->basePath = slash < 0 ? String("") : url.substring(slash);
+    while (out->basePath.endsWith("/")) {
+        out->basePath = out->basePath.substring(0, out->basePath.length() - 1);
+    }
+    int colon = hostPort.indexOf(':');
+    out->host = colon < 0 ? hostPort : hostPort.substring(0, colon);
+    out->port = colon < 0 ? (out->tls ? 443 : 80) : (uint16_t)hostPort.substring(colon + 1).toInt();
+    return out->host.length() > 0 && out->port > 0;
+}
+
+// ── Request / response ──────────────────────────────────────
+
+static bool sendRequest() {
+    ServerAddr srv;
+    if (!parseServer(cfgServer, &srv)) return false;
+
+    pushClient = &httpSessionClient(srv.tls);
+    pushReused = pushClient->connected();
+    if (!pushReused && !pushClient->connect(srv.host.c_str(), srv.port)) {
+        Serial.printf("[PUSH] connect %s:%u failed\n", srv.host.c_str(), srv.port);
+        return false;
+    }
+
+    String req = String("GET ") + srv.basePath + "/api/device/" + WiFi.macAddress()
+               + "/events?hold=" + String(PUSH_HOLD_S) + " HTTP/1.1\r\n"
+               + "Host: " + srv.host + "\r\n"
+               + "X-Device-Token: " + cfgDeviceToken + "\r\n"
+               + "Accept-Encoding: identity\r\n"
+               + "Connection: keep-alive\r\n\r\n";
+    if (pushClient->write((const uint8_t *)req.c_str(), req.length()) != req.length()) {
+        Serial.println("[PUSH] request write failed");
+        return false;
+    }
+    pushWaiting = true;
+    pushSentAt = millis();
+    modemSleepBegin();
+    return true;
+}
+
+// Read one CRLF-terminated line; the response arrives in one burst once the
+// backend answers, so a short deadline is enough.
+static bool readLine(char *buf, size_t cap, unsigned long deadline) {
+    size_t n = 0;
+    while ((long)(deadline - millis()) > 0) {
+        if (!pushClient->available()) {
+            if (!pushClient->connected()) return false;
+            delay(1);
+            continue;
+        }
+        int c = pushClient->read();
+        if (c == '\n') {
+            if (n > 0 && buf[n - 1] == '\r') n--;
+            buf[n] = '\0';
+            return true;
+        }
+        if (n + 1 < cap) buf[n++] = (char)c;
+    }
+    return false;
+}
+
+// Feed len body bytes to the JSON scanner; returns the number read.
+static long readBody(JsonScanner *scanner, long len, unsigned long deadline) {
+    long n = 0;
+    while (n < len && (long)(deadline - millis()) > 0) {
+        if (!pushClient->available()) {
+            if (!pushClient->connected()) break;
+            delay(1);
+            continue;
+        }
+        char c = (char)pushClient->read();
+        jsonScanFeed(scanner, &c, 1);
+        n++;
+    }
+    return n;
+}
+
+static PushEvent readResponse() {
+    unsigned long deadline = millis() + PUSH_READ_TIMEOUT_MS;
+    char line[160];
+    if (!readLine(line, sizeof(line), deadline)) return PUSH_FAILED;
+    int code = 0;
+    if (sscanf(line, "HTTP/%*d.%*d %d", &code) != 1) return PUSH_FAILED;
+
+    int contentLen = -1;
+    bool chunked = false;
+    bool keepAlive = true;
+    while (true) {
+        if (!readLine(line, sizeof(line), deadline)) return PUSH_FAILED;
+        if (line[0] == '\0') break;
+        if (strncasecmp(line, "Content-Length:", 15) == 0) contentLen = atoi(line + 15);
+        if (strncasecmp(line, "Transfer-Encoding:", 18) == 0 && strstr(line + 18, "chunked")) chunked = true;
+        if (strncasecmp(line, "Connection:", 11) == 0 && strstr(line + 11, "close")) keepAlive = false;
+    }
+
+    char event[12];
+    JsonField fields[] = {{"event", event, sizeof(event)}};
+    JsonScanner scanner;
+    jsonScanBegin(&scanner, fields, 1);
+    bool complete;
+    if (chunked) {
+        // Proxies may re-frame the reply: read chunks up to the terminating
+        // zero-size chunk and its (empty) trailer section.
+        complete = false;
+        while (true) {
+            if (!readLine(line, sizeof(line), deadline)) break;
+            char *end;
+            long size = strtol(line, &end, 16);
+            if (end == line || size < 0) break;
+            if (size == 0) {
+                while ((complete = readLine(line, sizeof(line), deadline)) && line[0] != '\0') {}
+                break;
+            }
+            if (readBody(&scanner, size, deadline) < size) break;
+            if (!readLine(line, sizeof(line), deadline) || line[0] != '\0') break;
+        }
+    } else {
+        complete = contentLen >= 0 && readBody(&scanner, contentLen, deadline) == contentLen;
+    }
+    // Without a complete, delimited body the next response cannot be framed
+    if (!complete || !keepAlive) pushClient->stop();
+    else httpSessionTouch();
+
+    if (code != 200) {
+        Serial.printf("[PUSH] events HTTP %d\n", code);
+        return PUSH_FAILED;
+    }
+    if (strcmp(event, "refresh") == 0) return PUSH_REFRESH;
+    if (strcmp(event, "interval") == 0) return PUSH_INTERVAL;
+    if (strcmp(event, "alert") == 0) return PUSH_ALERT;
+    return PUSH_NONE;
+}
+
+// ── Public API ──────────────────────────────────────────────
+
+PushEvent pushChannelPoll() {
+    if (!pushWaiting) {
+        if (WiFi.status() != WL_CONNECTED || cfgDeviceToken.length() == 0) return PUSH_FAILED;
+        if (!sendRequest()) {
+            dropSocket();
+            return PUSH_FAILED;
+        }
+        return PUSH_NONE;
+    }
+    if (!pushClient->available()) {
+        bool expired = millis() - pushSentAt > (unsigned long)(PUSH_HOLD_S * 1000 + PUSH_READ_TIMEOUT_MS);
+        if (!pushClient->connected() || expired) {
+            // A kept-alive socket the server closed while idle: reconnect quietly
+            bool stale = pushReused && !expired;
+            if (!stale) Serial.println(expired ? "[PUSH] hold expired without reply" : "[PUSH] connection lost");
+            dropSocket();
+            return stale ? PUSH_NONE : PUSH_FAILED;
+        }
+        return PUSH_NONE;
+    }
+    pushWaiting = false;
+    modemSleepEnd();
+    PushEvent ev = readResponse();
+    if (ev == PUSH_FAILED) dropSocket();
+    return ev;
+}
+
+void pushChannelClose() {
+    // An answered poll leaves the socket to the session; one still held by
+    // the backend would deliver its reply into the next request.
+    if (pushWaiting) dropSocket();
+    modemSleepEnd();
+}
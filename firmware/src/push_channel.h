@@ -0,0 +1,32 @@
+#ifndef INKSIGHT_PUSH_CHANNEL_H
+#define INKSIGHT_PUSH_CHANNEL_H
+
+#include <Arduino.h>
+
+// ── Live-mode push channel ──────────────────────────────────
+// HTTP long-poll on GET /api/device/{mac}/events?hold=N over the keep-alive
+// socket of the HTTP session (network.h), so live mode costs no second TLS
+// session (~40 KB of heap). The request is written once and the loop only
+// peeks at the socket, so the button and clock stay responsive while the
+// backend holds the connection; the modem sits in power save only for that
+// hold. Any HTTP request abandons the outstanding poll (its socket is
+// closed); the next pushChannelPoll() sends a new one. Replies are read with
+// Content-Length or chunked framing.
+
+enum PushEvent {
+    PUSH_NONE,      // still waiting, or the hold expired without an event
+    PUSH_REFRESH,   // refresh / mode switch queued
+    PUSH_INTERVAL,  // backend asked for interval mode
+    PUSH_ALERT,     // focus alert waiting
+    PUSH_FAILED,    // channel unavailable (connect error, old backend, ...)
+};
+
+// Send the long-poll request when none is outstanding, then check for the
+// response without blocking.
+PushEvent pushChannelPoll();
+
+// Abandon an outstanding poll and restore the modem power-save mode (leaving
+// live mode / before WiFi goes down / before any HTTP request)
+void pushChannelClose();
+
+#endif // INKSIGHT_PUSH_CHANNEL_H
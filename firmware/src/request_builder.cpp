@@ -0,0 +1,59 @@
+#include "request_builder.h"
+#include <stdarg.h>
+
+void reqBegin(ReqBuilder *b, char *buf, size_t cap) {
+    b->buf = buf;
+    b->cap = cap;
+    b->len = 0;
+    b->overflow = cap == 0;
+    if (cap > 0) buf[0] = '\0';
+}
+
+static bool putChars(ReqBuilder *b, const char *s, size_t n) {
+    if (b->overflow) return false;
+    if (n >= b->cap - b->len) {
+        n = b->cap - b->len - 1;
+        b->overflow = true;
+    }
+    memcpy(b->buf + b->len, s, n);
+    b->len += n;
+    b->buf[b->len] = '\0';
+    return !b->overflow;
+}
+
+bool reqAppend(ReqBuilder *b, const char *s) {
+    return putChars(b, s, strlen(s));
+}
+
+bool reqAppendf(ReqBuilder *b, const char *fmt, ...) {
+    if (b->overflow) return false;
+    size_t room = b->cap - b->len;
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(b->buf + b->len, room, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= room) {
+        // vsnprintf left the truncated text NUL-terminated
+        b->len = b->cap - 1;
+        b->overflow = true;
+        return false;
+    }
+    b->len += n;
+    return true;
+}
+
+bool reqAppendJsonString(ReqBuilder *b, const char *s) {
+    if (!putChars(b, "\"", 1)) return false;
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            char esc[2] = {'\\', (char)c};
+            if (!putChars(b, esc, 2)) return false;
+        } else if (c < 0x20) {
+            if (!reqAppendf(b, "\\u%04x", c)) return false;
+        } else if (!putChars(b, (const char *)&c, 1)) {
+            return false;
+        }
+    }
+    return putChars(b, "\"", 1);
+}
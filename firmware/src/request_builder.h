@@ -0,0 +1,31 @@
+#ifndef INKSIGHT_REQUEST_BUILDER_H
+#define INKSIGHT_REQUEST_BUILDER_H
+
+#include <Arduino.h>
+
+// ── Request builder ─────────────────────────────────────────
+// Formats request URLs and small JSON bodies into a caller-owned fixed
+// buffer with snprintf-style appends; nothing is allocated. An append that
+// does not fit marks the builder overflowed (the buffer keeps the text that
+// fit, NUL-terminated) and later appends are ignored, so callers check
+// reqOk() once after building.
+
+struct ReqBuilder {
+    char *buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+};
+
+void reqBegin(ReqBuilder *b, char *buf, size_t cap);
+bool reqAppend(ReqBuilder *b, const char *s);
+bool reqAppendf(ReqBuilder *b, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+// Append s as a JSON string literal (quoted, with escapes)
+bool reqAppendJsonString(ReqBuilder *b, const char *s);
+
+inline bool reqOk(const ReqBuilder *b) {
+    return !b->overflow;
+}
+
+#endif // INKSIGHT_REQUEST_BUILDER_H
@@ -1,8 +1,21 @@
 #include "storage.h"
 #include "config.h"
+#include "profiler.h"
 #include <Preferences.h>
+#include <freertos/FreeRTOS.h>
 
 static Preferences prefs;
+
+// Writes are timed as flash work for the profiler
+static void prefsEdit() {
+    profStart(PROF_FLASH);
+    prefs.begin("inksight", false);
+}
+
+static void prefsCommit() {
+    prefs.end();
+    profStop(PROF_FLASH);
+}
 static const char *LIVE_BOOT_MARKER = __DATE__ " " __TIME__;
 static const char *KEY_LIVE_BOOT_MARKER_NEW = "live_boot_mk";     // <= 15 chars
 static const char *KEY_LIVE_BOOT_MARKER_OLD = "live_boot_marker"; // old invalid key, read-compat only
@@ -19,11 +32,72 @@ String cfgConfigJson;
 String cfgDeviceToken;
 String cfgPendingPairCode;
 
+// ── Write-back state ────────────────────────────────────────
+// loadConfig() reads the namespace once; afterwards every getter works on the
+// RAM copy below (and the cfg* variables) and every setter only marks its
+// field dirty. configFlush() writes the dirty fields in one NVS transaction.
+
+enum ConfigField : uint16_t {
+    CF_SSID        = 1 << 0,
+    CF_PASS        = 1 << 1,
+    CF_SERVER      = 1 << 2,
+    CF_SLEEP_MIN   = 1 << 3,
+    CF_CONFIG_JSON = 1 << 4,
+    CF_DEVICE_TOKEN = 1 << 5,
+    CF_PAIR_CODE   = 1 << 6,
+    CF_GHOST       = 1 << 7,
+    CF_WIFI_FAST   = 1 << 8,
+    CF_LIVE_BOOT   = 1 << 9,
+    CF_POWER_LOG   = 1 << 10,
+};
+// Fields under cfg_version: writing one also stamps the schema version
+static const uint16_t CF_VERSIONED = CF_SSID | CF_PASS | CF_SERVER | CF_SLEEP_MIN |
+                                     CF_CONFIG_JSON | CF_DEVICE_TOKEN | CF_PAIR_CODE;
+
+static const size_t WIFI_FAST_MAX = 64;
+static const size_t POWER_LOG_MAX = 96;
+
+static struct {
+    int ghostDebt;
+    int ghostCycles;
+    uint8_t wifiFast[WIFI_FAST_MAX];
+    size_t wifiFastLen;
+    uint8_t powerLog[POWER_LOG_MAX];
+    size_t powerLogLen;
+    bool liveBootDone;
+} stored;
+
+// The ghost budget is charged on the display task, so dirty bits are set
+// under a lock; flushes happen while the display task is idle.
+static uint16_t dirty = 0;
+static portMUX_TYPE dirtyMux = portMUX_INITIALIZER_UNLOCKED;
+static bool loaded = false;
+
+static void markDirty(uint16_t fields) {
+    portENTER_CRITICAL(&dirtyMux);
+    dirty |= fields;
+    portEXIT_CRITICAL(&dirtyMux);
+}
+
 // ── Load config from NVS ────────────────────────────────────
 
 void loadConfig() {
     prefs.begin("inksight", true);  // read-only
 
+    stored.ghostDebt = prefs.getInt("ghost_debt", 0);
+    stored.ghostCycles = prefs.getInt("ghost_cycles", 0);
+    size_t fastLen = prefs.getBytesLength("wifi_fast");
+    stored.wifiFastLen = fastLen <= WIFI_FAST_MAX ? prefs.getBytes("wifi_fast", stored.wifiFast, fastLen) : 0;
+    size_t powerLen = prefs.getBytesLength("power_log");
+    stored.powerLogLen = powerLen <= POWER_LOG_MAX ? prefs.getBytes("power_log", stored.powerLog, powerLen) : 0;
+    String marker = prefs.getString(KEY_LIVE_BOOT_MARKER_NEW, "");
+    if (marker.length() == 0) {
+        marker = prefs.getString(KEY_LIVE_BOOT_MARKER_OLD, "");
+    }
+    stored.liveBootDone = (marker == String(LIVE_BOOT_MARKER));
+    dirty = 0;
+    loaded = true;
+
     int version = prefs.getInt("cfg_version", 0);
     if (version != CONFIG_VERSION) {
         Serial.printf("Config version mismatch (%d != %d), using defaults\n",
@@ -57,69 +131,149 @@ void loadConfig() {
     }
 }
 
+static void ensureLoaded() {
+    if (!loaded) loadConfig();
+}
+
+// ── Flush ───────────────────────────────────────────────────
+
+static void putOrRemove(const char *key, const String &value) {
+    if (value.length() > 0) {
+        prefs.putString(key, value);
+    } else {
+        prefs.remove(key);
+    }
+}
+
+void configFlush() {
+    portENTER_CRITICAL(&dirtyMux);
+    uint16_t fields = dirty;
+    dirty = 0;
+    portEXIT_CRITICAL(&dirtyMux);
+    if (fields == 0) return;
+
+    prefsEdit();
+    if (fields & CF_VERSIONED) prefs.putInt("cfg_version", CONFIG_VERSION);
+    if (fields & CF_SSID) prefs.putString("ssid", cfgSSID);
+    if (fields & CF_PASS) prefs.putString("pass", cfgPass);
+    if (fields & CF_SERVER) prefs.putString("server", cfgServer);
+    if (fields & CF_SLEEP_MIN) prefs.putInt("sleep_min", cfgSleepMin);
+    if (fields & CF_CONFIG_JSON) prefs.putString("config_json", cfgConfigJson);
+    if (fields & CF_DEVICE_TOKEN) putOrRemove("device_token", cfgDeviceToken);
+    if (fields & CF_PAIR_CODE) putOrRemove("pair_code", cfgPendingPairCode);
+    if (fields & CF_GHOST) {
+        prefs.putInt("ghost_debt", stored.ghostDebt);
+        prefs.putInt("ghost_cycles", stored.ghostCycles);
+    }
+    if (fields & CF_WIFI_FAST) prefs.putBytes("wifi_fast", stored.wifiFast, stored.wifiFastLen);
+    if (fields & CF_POWER_LOG) prefs.putBytes("power_log", stored.powerLog, stored.powerLogLen);
+    if (fields & CF_LIVE_BOOT) prefs.putString(KEY_LIVE_BOOT_MARKER_NEW, LIVE_BOOT_MARKER);
+    prefsCommit();
+    Serial.printf("[NVS] flushed fields 0x%03x\n", fields);
+}
+
 // ── Retry counter ───────────────────────────────────────────
+// Retries wait in deep sleep, so the counter lives in RTC memory rather than
+// costing an NVS write per failed boot.
+
+static RTC_DATA_ATTR int retryCount = 0;
 
 int getRetryCount() {
-    prefs.begin("inksight", true);
-    int count = prefs.getInt("retry_count", 0);
-    prefs.end();
-    return count;
+    return retryCount;
 }
 
 void setRetryCount(int count) {
-    prefs.begin("inksight", false);
-    prefs.putInt("retry_count", count);
-    prefs.end();
+    retryCount = count;
 }
 
 void resetRetryCount() {
     setRetryCount(0);
 }
 
+// ── Ghosting budget ─────────────────────────────────────────
+
+void loadGhostState(int *debt, int *cycles) {
+    ensureLoaded();
+    *debt = stored.ghostDebt;
+    *cycles = stored.ghostCycles;
+}
+
+void saveGhostState(int debt, int cycles) {
+    ensureLoaded();
+    if (stored.ghostDebt == debt && stored.ghostCycles == cycles) return;
+    stored.ghostDebt = debt;
+    stored.ghostCycles = cycles;
+    markDirty(CF_GHOST);
+}
+
+// ── WiFi fast join ──────────────────────────────────────────
+
+size_t loadWiFiFastJoin(void *buf, size_t len) {
+    ensureLoaded();
+    if (stored.wifiFastLen != len) return 0;
+    memcpy(buf, stored.wifiFast, len);
+    return len;
+}
+
+void saveWiFiFastJoin(const void *buf, size_t len) {
+    ensureLoaded();
+    if (len > WIFI_FAST_MAX) return;
+    if (stored.wifiFastLen == len && memcmp(stored.wifiFast, buf, len) == 0) return;
+    memcpy(stored.wifiFast, buf, len);
+    stored.wifiFastLen = len;
+    markDirty(CF_WIFI_FAST);
+}
+
+// ── Battery history ─────────────────────────────────────────
+
+size_t loadPowerLog(void *buf, size_t len) {
+    ensureLoaded();
+    if (stored.powerLogLen != len) return 0;
+    memcpy(buf, stored.powerLog, len);
+    return len;
+}
+
+void savePowerLog(const void *buf, size_t len) {
+    ensureLoaded();
+    if (len > POWER_LOG_MAX) return;
+    if (stored.powerLogLen == len && memcmp(stored.powerLog, buf, len) == 0) return;
+    memcpy(stored.powerLog, buf, len);
+    stored.powerLogLen = len;
+    markDirty(CF_POWER_LOG);
+}
+
 bool isFirstInstallLiveModePending() {
-    prefs.begin("inksight", true);
-    String marker = prefs.getString(KEY_LIVE_BOOT_MARKER_NEW, "");
-    if (marker.length() == 0) {
-        marker = prefs.getString(KEY_LIVE_BOOT_MARKER_OLD, "");
-    }
-    prefs.end();
-    return marker != String(LIVE_BOOT_MARKER);
+    ensureLoaded();
+    return !stored.liveBootDone;
 }
 
 void markFirstInstallLiveModeDone() {
-    prefs.begin("inksight", false);
-    prefs.putString(KEY_LIVE_BOOT_MARKER_NEW, LIVE_BOOT_MARKER);
-    prefs.end();
+    ensureLoaded();
+    if (stored.liveBootDone) return;
+    stored.liveBootDone = true;
+    markDirty(CF_LIVE_BOOT);
 }
 
 // ── Save WiFi credentials ───────────────────────────────────
 
 void saveWiFiConfig(const String &ssid, const String &pass) {
-    prefs.begin("inksight", false);  // read-write
-    prefs.putInt("cfg_version", CONFIG_VERSION);
-    prefs.putString("ssid", ssid);
-    prefs.putString("pass", pass);
-    prefs.end();
     cfgSSID = ssid;
     cfgPass = pass;
+    markDirty(CF_SSID | CF_PASS);
 }
 
 // ── Save server URL ─────────────────────────────────────────
 
 void saveServerUrl(const String &url) {
-    prefs.begin("inksight", false);
-    prefs.putInt("cfg_version", CONFIG_VERSION);
-    prefs.putString("server", url);
-    prefs.end();
     cfgServer = url;
+    markDirty(CF_SERVER);
 }
 
 // ── Save user config JSON ───────────────────────────────────
 
 void saveUserConfig(const String &configJson) {
-    prefs.begin("inksight", false);
-    prefs.putInt("cfg_version", CONFIG_VERSION);
-    prefs.putString("config_json", configJson);
+    cfgConfigJson = configJson;
+    markDirty(CF_CONFIG_JSON);
 
     // Extract refreshInterval from JSON and persist as sleep_min
     int idx = configJson.indexOf("\"refreshInterval\"");
@@ -129,57 +283,39 @@ void saveUserConfig(const String &configJson) {
             int val = configJson.substring(colon + 1).toInt();
             if (val < 10)   val = 10;    // minimum 10 minutes
             if (val > 1440)  val = 1440;  // maximum 24 hours
-            prefs.putInt("sleep_min", val);
             cfgSleepMin = val;
+            markDirty(CF_SLEEP_MIN);
             Serial.printf("refreshInterval -> sleep_min = %d min\n", val);
         }
     }
-
-    prefs.end();
-    cfgConfigJson = configJson;
 }
 
 void saveSleepMin(int minutes) {
     if (minutes < 10) minutes = 10;
     if (minutes > 1440) minutes = 1440;
     if (cfgSleepMin == minutes) return;
-    prefs.begin("inksight", false);
-    prefs.putInt("cfg_version", CONFIG_VERSION);
-    prefs.putInt("sleep_min", minutes);
-    prefs.end();
     cfgSleepMin = minutes;
+    markDirty(CF_SLEEP_MIN);
 }
 
 // ── Device token ────────────────────────────────────────────
 
 void saveDeviceToken(const String &token) {
-    prefs.begin("inksight", false);
-    prefs.putInt("cfg_version", CONFIG_VERSION);
-    prefs.putString("device_token", token);
-    prefs.end();
+    if (cfgDeviceToken == token) return;
     cfgDeviceToken = token;
+    markDirty(CF_DEVICE_TOKEN);
 }
 
 void clearDeviceToken() {
-    prefs.begin("inksight", false);
-    prefs.putInt("cfg_version", CONFIG_VERSION);
-    prefs.remove("device_token");
-    prefs.end();
-    cfgDeviceToken = "";
+    saveDeviceToken("");
 }
 
 void savePendingPairCode(const String &code) {
-    prefs.begin("inksight", false);
-    prefs.putInt("cfg_version", CONFIG_VERSION);
-    prefs.putString("pair_code", code);
-    prefs.end();
+    if (cfgPendingPairCode == code) return;
     cfgPendingPairCode = code;
+    markDirty(CF_PAIR_CODE);
 }
 
 void clearPendingPairCode() {
-    prefs.begin("inksight", false);
-    prefs.putInt("cfg_version", CONFIG_VERSION);
-    prefs.remove("pair_code");
-    prefs.end();
-    cfgPendingPairCode = "";
+    savePendingPairCode("");
 }
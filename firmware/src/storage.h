@@ -13,10 +13,17 @@ extern String cfgDeviceToken;
 extern String cfgPendingPairCode;
 
 // ── NVS operations ──────────────────────────────────────────
+// Write-back: loadConfig() reads NVS once, getters never touch flash and
+// setters only update the RAM copy. configFlush() writes whatever changed in
+// one transaction; it runs after each refresh cycle, before deep sleep and
+// before a restart.
 
 // Load all config from NVS into runtime variables
 void loadConfig();
 
+// Write the changed fields to NVS (no-op when nothing changed)
+void configFlush();
+
 // Save WiFi credentials to NVS
 void saveWiFiConfig(const String &ssid, const String &pass);
 
@@ -27,11 +34,23 @@ void saveServerUrl(const String &url);
 void saveUserConfig(const String &configJson);
 void saveSleepMin(int minutes);
 
-// Retry counter management
+// Retry counter management (RTC memory: survives deep sleep, not power loss)
 int  getRetryCount();
 void setRetryCount(int count);
 void resetRetryCount();
 
+// Ghosting budget of the panel (see ghost_budget.h)
+void loadGhostState(int *debt, int *cycles);
+void saveGhostState(int debt, int cycles);
+
+// WiFi fast-join record (BSSID/channel/IP lease, see network.cpp)
+size_t loadWiFiFastJoin(void *buf, size_t len);
+void saveWiFiFastJoin(const void *buf, size_t len);
+
+// Battery voltage history (see power_manager.cpp)
+size_t loadPowerLog(void *buf, size_t len);
+void savePowerLog(const void *buf, size_t len);
+
 // One-time boot flag for first-install live mode
 bool isFirstInstallLiveModePending();
 void markFirstInstallLiveModeDone();
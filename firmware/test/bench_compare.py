@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+"""Compare two benchmark result files (JSON lines from test_bench).
+
+usage: bench_compare.py BASE.jsonl NEW.jsonl
+
+Prints ns_per_op of every (bench, panel size) present in both files and the
+change; negative is faster. The last result of a key in a file wins.
+"""
+import json
+import sys
+
+
+def load(path):
+    results = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("{"):
+                continue
+            r = json.loads(line)
+            results[(r["bench"], r["width"], r["height"])] = r["ns_per_op"]
+    return results
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    base, new = load(sys.argv[1]), load(sys.argv[2])
+    print(f"{'bench':<18} {'panel':>8} {'base ns':>12} {'new ns':>12} {'change':>8}")
+    for key in sorted(base.keys() & new.keys()):
+        bench, w, h = key
+        b, n = base[key], new[key]
+        change = (n - b) / b * 100 if b else 0.0
+        print(f"{bench:<18} {f'{w}x{h}':>8} {b:>12.0f} {n:>12.0f} {change:>+7.1f}%")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
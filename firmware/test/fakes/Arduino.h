@@ -0,0 +1,120 @@
+#ifndef INKSIGHT_FAKE_ARDUINO_H
+#define INKSIGHT_FAKE_ARDUINO_H
+
+// ── Host fake of the Arduino core (env:native_*) ────────────
+// Just what the board-independent modules use: fixed-width types, min/max,
+// String, Serial, the clock and GPIO. Header-only, so the native envs need
+// no extra sources.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define PROGMEM
+
+#if defined(__GLIBC__) && (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+inline size_t strlcpy(char *dst, const char *src, size_t cap) {
+    size_t len = strlen(src);
+    if (cap) {
+        size_t n = len < cap - 1 ? len : cap - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+// ── Clock ───────────────────────────────────────────────────
+
+inline uint64_t fakeNowUs() {
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+inline unsigned long millis() { return (unsigned long)(fakeNowUs() / 1000); }
+inline unsigned long micros() { return (unsigned long)fakeNowUs(); }
+inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void delayMicroseconds(unsigned int us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+inline void yield() {}
+
+// ── GPIO ────────────────────────────────────────────────────
+// Pin levels are only recorded; a test may preset an input in fakePinLevel.
+
+#define LOW           0
+#define HIGH          1
+#define INPUT         0x01
+#define OUTPUT        0x03
+#define INPUT_PULLUP  0x05
+
+static const int FAKE_PIN_COUNT = 64;
+inline int fakePinLevel[FAKE_PIN_COUNT];
+inline int fakePinWrites = 0;
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int pin, int level) {
+    fakePinWrites++;
+    if (pin >= 0 && pin < FAKE_PIN_COUNT) fakePinLevel[pin] = level;
+}
+inline int digitalRead(int pin) {
+    return pin >= 0 && pin < FAKE_PIN_COUNT ? fakePinLevel[pin] : LOW;
+}
+
+// ── String ──────────────────────────────────────────────────
+
+class String {
+public:
+    String() {}
+    String(const char *s) : str_(s ? s : "") {}
+    const char *c_str() const { return str_.c_str(); }
+    unsigned int length() const { return (unsigned int)str_.size(); }
+    bool operator==(const String &o) const { return str_ == o.str_; }
+    bool operator==(const char *o) const { return str_ == o; }
+    bool operator!=(const String &o) const { return str_ != o.str_; }
+    String &operator+=(const String &o) { str_ += o.str_; return *this; }
+private:
+    std::string str_;
+};
+
+// ── Serial ──────────────────────────────────────────────────
+// Silent unless verbose is set, so module logging does not drown the
+// benchmark output on stdout. Goes to stderr.
+
+class FakeSerial {
+public:
+    bool verbose = false;
+    void begin(unsigned long) {}
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        if (!verbose) return 0;
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vfprintf(stderr, fmt, ap);
+        va_end(ap);
+        return n > 0 ? (size_t)n : 0;
+    }
+    size_t print(const char *s) {
+        if (!verbose) return 0;
+        fputs(s, stderr);
+        return strlen(s);
+    }
+    size_t println(const char *s = "") { return print(s) + print("\n"); }
+    size_t print(const String &s) { return print(s.c_str()); }
+    size_t println(const String &s) { return println(s.c_str()); }
+};
+inline FakeSerial Serial;
+
+#endif // INKSIGHT_FAKE_ARDUINO_H
@@ -0,0 +1,87 @@
+#ifndef INKSIGHT_FAKE_LITTLEFS_H
+#define INKSIGHT_FAKE_LITTLEFS_H
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+// ── Host fake of LittleFS ───────────────────────────────────
+// Files live in RAM. A write handle replaces the file when opened, rename()
+// replaces the target, and totalBytes() matches the min_spiffs.csv data
+// partition, so the frame store sizes its slots as on the device.
+
+using FakeFileData = std::vector<uint8_t>;
+
+class File {
+public:
+    File() {}
+    File(std::shared_ptr<FakeFileData> data, bool write) : data_(data), write_(write) {}
+
+    explicit operator bool() const { return data_ != nullptr; }
+
+    size_t write(const uint8_t *buf, size_t len) {
+        if (!data_ || !write_) return 0;
+        data_->insert(data_->end(), buf, buf + len);
+        return len;
+    }
+
+    size_t readBytes(char *buf, size_t len) {
+        if (!data_ || write_) return 0;
+        size_t n = min(len, data_->size() - pos_);
+        memcpy(buf, data_->data() + pos_, n);
+        pos_ += n;
+        return n;
+    }
+
+    size_t size() const { return data_ ? data_->size() : 0; }
+    void close() { data_.reset(); }
+
+private:
+    std::shared_ptr<FakeFileData> data_;
+    bool write_ = false;
+    size_t pos_ = 0;
+};
+
+class LittleFSFS {
+public:
+    size_t total = 0x30000;
+
+    bool begin(bool = false) { return true; }
+    void format() { files_.clear(); }
+
+    File open(const char *path, const char *mode = "r") {
+        if (mode[0] == 'w') {
+            auto data = std::make_shared<FakeFileData>();
+            files_[path] = data;
+            return File(data, true);
+        }
+        auto it = files_.find(path);
+        return it == files_.end() ? File() : File(it->second, false);
+    }
+
+    bool exists(const char *path) { return files_.count(path) != 0; }
+    bool remove(const char *path) { return files_.erase(path) != 0; }
+
+    bool rename(const char *from, const char *to) {
+        auto it = files_.find(from);
+        if (it == files_.end()) return false;
+        files_[to] = it->second;
+        files_.erase(it);
+        return true;
+    }
+
+    size_t totalBytes() const { return total; }
+
+    // Test hook: the file contents, or null
+    FakeFileData *data(const char *path) {
+        auto it = files_.find(path);
+        return it == files_.end() ? nullptr : it->second.get();
+    }
+
+private:
+    std::map<std::string, std::shared_ptr<FakeFileData>> files_;
+};
+inline LittleFSFS LittleFS;
+
+#endif // INKSIGHT_FAKE_LITTLEFS_H
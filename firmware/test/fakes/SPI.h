@@ -0,0 +1,42 @@
+#ifndef INKSIGHT_FAKE_SPI_H
+#define INKSIGHT_FAKE_SPI_H
+
+#include <Arduino.h>
+#include "frame_hash.h"
+
+// ── Host fake of the SPI bus ────────────────────────────────
+// Written bytes are counted and folded into a CRC32, so a test can compare
+// what a panel would have received and a benchmark cannot be optimized away.
+
+#define SPI_MODE0 0
+#define MSBFIRST  1
+
+class SPISettings {
+public:
+    SPISettings() {}
+    SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass {
+public:
+    size_t bytes = 0;
+    uint32_t crc = 0;
+
+    void begin(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1) {}
+    void end() {}
+    void beginTransaction(SPISettings) {}
+    void endTransaction() {}
+    void reset() { bytes = 0; crc = 0; }
+
+    uint8_t transfer(uint8_t data) {
+        writeBytes(&data, 1);
+        return 0xFF;
+    }
+    void writeBytes(const uint8_t *data, uint32_t len) {
+        bytes += len;
+        crc = crc32Update(crc, data, len);
+    }
+};
+inline SPIClass SPI;
+
+#endif // INKSIGHT_FAKE_SPI_H
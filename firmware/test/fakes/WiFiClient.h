@@ -0,0 +1,50 @@
+#ifndef INKSIGHT_FAKE_WIFICLIENT_H
+#define INKSIGHT_FAKE_WIFICLIENT_H
+
+#include <Arduino.h>
+
+// ── Host fake of WiFiClient ─────────────────────────────────
+// Serves a response body from memory. available() reports at most chunk
+// bytes at a time, like TCP segments arriving, so a reader loop sees the
+// same short reads it gets on the device.
+
+class WiFiClient {
+public:
+    WiFiClient() {}
+    WiFiClient(const uint8_t *data, size_t len, int chunk = 1436) { serve(data, len, chunk); }
+
+    void serve(const uint8_t *data, size_t len, int chunk = 1436) {
+        data_ = data;
+        len_ = len;
+        pos_ = 0;
+        chunk_ = chunk;
+    }
+
+    int available() {
+        size_t left = len_ - pos_;
+        return (int)(left < (size_t)chunk_ ? left : (size_t)chunk_);
+    }
+
+    int read(uint8_t *buf, size_t size) {
+        int n = min((int)size, available());
+        memcpy(buf, data_ + pos_, n);
+        pos_ += n;
+        return n;
+    }
+
+    int read() {
+        return pos_ < len_ ? data_[pos_++] : -1;
+    }
+
+    uint8_t connected() { return pos_ < len_; }
+    void stop() { pos_ = len_; }
+    size_t position() const { return pos_; }
+
+private:
+    const uint8_t *data_ = nullptr;
+    size_t len_ = 0;
+    size_t pos_ = 0;
+    int chunk_ = 1436;
+};
+
+#endif // INKSIGHT_FAKE_WIFICLIENT_H
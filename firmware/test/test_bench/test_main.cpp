@@ -0,0 +1,240 @@
+// Host benchmarks of the firmware's CPU-bound paths at the env's panel size.
+// Every result is one JSON object per line on stdout, e.g.
+//   {"bench":"bmp_rows","width":400,"height":300,"iters":2048,"ns_per_op":10312,"mb_per_s":1467.2}
+// and is also appended to $INKSIGHT_BENCH_OUT when set. test/bench_compare.py
+// diffs two such files. Run: pio test -e native_42 -f test_bench -v
+
+#include <unity.h>
+#include <chrono>
+#include <vector>
+
+#include <SPI.h>
+#include <WiFiClient.h>
+
+#include "config.h"
+#include "font.h"
+#include "frame_hash.h"
+#include "json_scan.h"
+#include "pixel_ops.h"
+
+static uint8_t frameBuf[IMG_BUF_LEN];
+uint8_t *imgBuf = frameBuf;
+
+static const int NET_CHUNK = 2048;       // network.cpp read chunk
+static const int TCP_SEGMENT = 1436;     // bytes available per WiFiClient poll
+static const double MIN_RUN_S = 0.05;    // calibrate repetitions to at least this long
+static const int RUNS = 5;               // report the fastest run
+
+static volatile uint32_t sink;
+
+static void fillPattern(uint8_t *buf, size_t len, uint32_t seed) {
+    uint32_t x = seed ? seed : 1;
+    for (size_t i = 0; i < len; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        buf[i] = x & 0xFF;
+    }
+}
+
+static double secondsOf(void (*op)(), long iters) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (long i = 0; i < iters; i++) op();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+// Time op(), which processes bytesPerOp bytes, and report it
+static void bench(const char *name, size_t bytesPerOp, void (*op)()) {
+    long iters = 1;
+    while (secondsOf(op, iters) < MIN_RUN_S) iters *= 2;
+    double best = 1e30;
+    for (int r = 0; r < RUNS; r++) best = min(best, secondsOf(op, iters));
+
+    double nsPerOp = best * 1e9 / iters;
+    double mbPerS = bytesPerOp / (best / iters) / 1e6;
+    char line[200];
+    snprintf(line, sizeof(line),
+             "{\"bench\":\"%s\",\"width\":%d,\"height\":%d,\"iters\":%ld,"
+             "\"ns_per_op\":%.0f,\"mb_per_s\":%.1f}",
+             name, W, H, iters, nsPerOp, mbPerS);
+    puts(line);
+    if (const char *path = getenv("INKSIGHT_BENCH_OUT")) {
+        if (FILE *f = fopen(path, "a")) {
+            fprintf(f, "%s\n", line);
+            fclose(f);
+        }
+    }
+    TEST_ASSERT_TRUE(nsPerOp > 0);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// ── Fixtures ────────────────────────────────────────────────
+
+static std::vector<uint8_t> frame(IMG_BUF_LEN);
+static std::vector<uint8_t> bmp(ROW_STRIDE * H);
+static std::vector<uint8_t> color(COLOR_BUF_LEN);
+static uint16_t monoLut[256];
+static uint8_t remapLut[256];
+static const char *configJson =
+    "{\"mac\":\"AA:BB:CC:DD:EE:FF\",\"modes\":[\"DAILY\",\"WEATHER\",\"POETRY\",\"STOIC\"],"
+    "\"refresh_strategy\":\"cycle\",\"refresh_minutes\":60,\"city\":\"\\u676d\\u5dde\","
+    "\"llm_provider\":\"deepseek\",\"llm_model\":\"deepseek-chat\",\"language\":\"zh\","
+    "\"content_tone\":\"neutral\",\"character_tones\":[\"calm\",{\"name\":\"x\",\"w\":[1,2]}],"
+    "\"mode_overrides\":{\"WEATHER\":{\"city\":\"Hangzhou\",\"units\":\"metric\"}},"
+    "\"focus_listening\":true,\"always_active\":false,\"is_focus_listening\":1,"
+    "\"pending_refresh\":false,\"runtime_mode\":\"interval\"}";
+
+static void setupFixtures() {
+    fillPattern(frame.data(), frame.size(), 1);
+    fillPattern(color.data(), color.size(), 2);
+    fillPattern(bmp.data(), bmp.size(), 3);
+    mono2bppBuildLut(monoLut, nullptr);
+    for (int v = 0; v < 256; v++) remapLut[v] = v ^ 0x55;
+}
+
+// ── Benchmarks ──────────────────────────────────────────────
+
+// fetchBMP: BMP body through the chunked socket reader into imgBuf, rows
+// hashed as they complete (readBmpRows)
+static void opBmpRows() {
+    static uint8_t chunk[NET_CHUNK];
+    WiFiClient client(bmp.data(), bmp.size(), TCP_SEGMENT);
+    FrameHash hash;
+    frameHashBegin(&hash, ROW_BYTES, H);
+    BmpRowReader rows;
+    bmpRowsBegin(&rows, imgBuf, ROW_BYTES, ROW_STRIDE, H);
+    while (bmpRowsRemaining(&rows) > 0) {
+        int n = client.read(chunk, min(NET_CHUNK, bmpRowsRemaining(&rows)));
+        for (int off = 0; off < n;) {
+            int y;
+            off += bmpRowsFeed(&rows, chunk + off, n - off, &y);
+            if (y >= 0) frameHashRow(&hash, y, imgBuf + y * ROW_BYTES);
+        }
+    }
+    frameHashFinish(&hash);
+    sink = hash.frame;
+}
+
+// epdWrite2bppPlane from a mono frame: expand every row and send it
+static void opMono2bppPlane() {
+    uint8_t row[COLOR_ROW_BYTES];
+    SPI.reset();
+    for (int y = 0; y < H; y++) {
+        mono2bppPackRow(monoLut, frame.data() + y * ROW_BYTES, row, ROW_BYTES);
+        SPI.writeBytes(row, COLOR_ROW_BYTES);
+    }
+    sink = SPI.crc;
+}
+
+// epdWrite2bppPlane from a 2bpp frame with the GDEM042F52 colour remap
+static void opRemap2bppPlane() {
+    uint8_t row[COLOR_ROW_BYTES];
+    SPI.reset();
+    for (int y = 0; y < H; y++) {
+        remapRow(remapLut, color.data() + y * COLOR_ROW_BYTES, row, COLOR_ROW_BYTES);
+        SPI.writeBytes(row, COLOR_ROW_BYTES);
+    }
+    sink = SPI.crc;
+}
+
+// Full-frame 90° rotation in 8-byte-column bands (write_rotated_rect)
+static void opRotateFrame() {
+    static const int rows = H & ~7;
+    static uint8_t band[8 * 8 * (H / 8)];
+    uint32_t acc = 0;
+    for (int bx0 = 0; bx0 < ROW_BYTES; bx0 += 8) {
+        int bx1 = min(bx0 + 8, ROW_BYTES);
+        rotateBand(frame.data(), ROW_BYTES, W, bx0, bx1, 0, rows, band);
+        acc += band[0];
+    }
+    sink = acc;
+}
+
+// One screen of 5x7 text at the scales the status screens use
+static void opDrawText() {
+    static const char *line = "InkSight 12:34 - OFFLINE!";
+    for (int scale = 1; scale <= 3; scale++) {
+        for (int y = 0; y + 7 * scale <= H; y += 8 * scale) {
+            drawTextInto(imgBuf, W, H, line, 0, y, scale);
+        }
+    }
+    sink = imgBuf[0];
+}
+
+// The period label glyphs, tiled over the screen
+static void opDrawGlyph16() {
+    static uint16_t glyph[16];
+    if (!glyph[0]) fillPattern((uint8_t *)glyph, sizeof(glyph), 4);
+    for (int y = 0; y + 16 <= H; y += 16) {
+        for (int x = 0; x + 16 <= W; x += 18) drawGlyph16(imgBuf, W, H, x, y, glyph);
+    }
+    sink = imgBuf[0];
+}
+
+// The showSetupScreen() bars plus an unaligned box
+static void opFillRect() {
+    fillRectInto(imgBuf, W, H, 0, 0, W, H * 12 / 100);
+    fillRectInto(imgBuf, W, H, W * 8 / 100, H * 28 / 100, W * 84 / 100, H * 2 / 100);
+    fillRectInto(imgBuf, W, H, W * 8 / 100, H * 72 / 100, W * 84 / 100, H * 2 / 100);
+    fillRectInto(imgBuf, W, H, 3, H / 3, W / 2 + 5, H / 4);
+    sink = imgBuf[0];
+}
+
+// Offline store integrity check: CRC32 of one frame
+static void opCrc32Frame() {
+    sink = crc32Update(0, frame.data(), IMG_BUF_LEN);
+}
+
+// ETag / dirty-tile hash of one frame
+static void opFrameHash() {
+    FrameHash h;
+    frameHashCompute(&h, frame.data(), ROW_BYTES, H);
+    sink = h.frame;
+}
+
+// Config flags out of a /config reply, fed in socket-sized chunks
+static void opJsonFlags() {
+    char focus[8], always[8], pending[8];
+    JsonField fields[] = {
+        {"focus_listening", focus, sizeof(focus)},
+        {"always_active", always, sizeof(always)},
+        {"pending_refresh", pending, sizeof(pending)},
+    };
+    JsonScanner s;
+    jsonScanBegin(&s, fields, 3);
+    size_t len = strlen(configJson);
+    for (size_t off = 0; off < len; off += 64) {
+        jsonScanFeed(&s, configJson + off, min((size_t)64, len - off));
+    }
+    sink = jsonFieldTrue(fields[0]) + jsonFieldTrue(fields[1]) * 2;
+}
+
+static void bench_bmp_rows() { bench("bmp_rows", bmp.size(), opBmpRows); }
+static void bench_mono_2bpp_plane() { bench("mono_2bpp_plane", IMG_BUF_LEN, opMono2bppPlane); }
+static void bench_remap_2bpp_plane() { bench("remap_2bpp_plane", COLOR_BUF_LEN, opRemap2bppPlane); }
+static void bench_rotate_frame() { bench("rotate_frame", ROW_BYTES * (H & ~7), opRotateFrame); }
+static void bench_draw_text() { bench("draw_text", IMG_BUF_LEN, opDrawText); }
+static void bench_draw_glyph16() { bench("draw_glyph16", IMG_BUF_LEN, opDrawGlyph16); }
+static void bench_fill_rect() { bench("fill_rect", IMG_BUF_LEN, opFillRect); }
+static void bench_crc32_frame() { bench("crc32_frame", IMG_BUF_LEN, opCrc32Frame); }
+static void bench_frame_hash() { bench("frame_hash", IMG_BUF_LEN, opFrameHash); }
+static void bench_json_flags() { bench("json_flags", strlen(configJson), opJsonFlags); }
+
+int main(int, char **) {
+    setupFixtures();
+    UNITY_BEGIN();
+    RUN_TEST(bench_bmp_rows);
+    RUN_TEST(bench_mono_2bpp_plane);
+    RUN_TEST(bench_remap_2bpp_plane);
+    RUN_TEST(bench_rotate_frame);
+    RUN_TEST(bench_draw_text);
+    RUN_TEST(bench_draw_glyph16);
+    RUN_TEST(bench_fill_rect);
+    RUN_TEST(bench_crc32_frame);
+    RUN_TEST(bench_frame_hash);
+    RUN_TEST(bench_json_flags);
+    return UNITY_END();
+}
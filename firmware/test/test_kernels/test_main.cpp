@@ -0,0 +1,479 @@
+// Host checks of the board-independent firmware modules at the env's panel
+// size (EPD_WIDTH x EPD_HEIGHT). Run: pio test -e native_42 -f test_kernels
+
+#include <unity.h>
+#include <vector>
+
+#include <LittleFS.h>
+#include <SPI.h>
+#include <WiFiClient.h>
+
+#include "config.h"
+#include "font.h"
+#include "frame_codec.h"
+#include "frame_hash.h"
+#include "json_scan.h"
+#include "offline_cache.h"
+#include "dirty_rect.h"
+#include "pixel_ops.h"
+
+static uint8_t frameBuf[IMG_BUF_LEN];
+uint8_t *imgBuf = frameBuf;
+
+// Deterministic pseudo-random fill (xorshift32)
+static void fillPattern(uint8_t *buf, size_t len, uint32_t seed) {
+    uint32_t x = seed ? seed : 1;
+    for (size_t i = 0; i < len; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        buf[i] = x & 0xFF;
+    }
+}
+
+static bool pixelBlack(const uint8_t *buf, int rowBytes, int x, int y) {
+    return (buf[y * rowBytes + x / 8] & (0x80 >> (x % 8))) == 0;
+}
+
+// BMP pixel array of a top-down frame: bottom-up rows, padding bytes 0xAA
+static std::vector<uint8_t> bmpBody(const uint8_t *frame) {
+    std::vector<uint8_t> body(ROW_STRIDE * H, 0xAA);
+    for (int y = 0; y < H; y++) {
+        memcpy(body.data() + (H - 1 - y) * ROW_STRIDE, frame + y * ROW_BYTES, ROW_BYTES);
+    }
+    return body;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// ── Checksums ───────────────────────────────────────────────
+
+static void test_crc32_matches_zlib() {
+    const char *check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32Update(0, (const uint8_t *)check, 9));
+    // Chained updates equal one pass
+    uint32_t crc = crc32Update(0, (const uint8_t *)check, 4);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32Update(crc, (const uint8_t *)check + 4, 5));
+}
+
+static void test_frame_hash_independent_of_row_order() {
+    std::vector<uint8_t> frame(IMG_BUF_LEN);
+    fillPattern(frame.data(), frame.size(), 7);
+    FrameHash topDown, bottomUp;
+    frameHashCompute(&topDown, frame.data(), ROW_BYTES, H);
+    frameHashBegin(&bottomUp, ROW_BYTES, H);
+    for (int y = H - 1; y >= 0; y--) frameHashRow(&bottomUp, y, frame.data() + y * ROW_BYTES);
+    frameHashFinish(&bottomUp);
+    TEST_ASSERT_EQUAL_HEX32(topDown.frame, bottomUp.frame);
+
+    frame[IMG_BUF_LEN / 2] ^= 0x01;
+    FrameHash changed;
+    frameHashCompute(&changed, frame.data(), ROW_BYTES, H);
+    TEST_ASSERT_TRUE(changed.frame != topDown.frame);
+}
+
+// ── BMP rows ────────────────────────────────────────────────
+
+static void readBmp(WiFiClient &client, uint8_t *image, int *rowsDone) {
+    uint8_t chunk[2048];
+    BmpRowReader rows;
+    bmpRowsBegin(&rows, image, ROW_BYTES, ROW_STRIDE, H);
+    int expectY = H - 1;
+    while (bmpRowsRemaining(&rows) > 0) {
+        int n = client.read(chunk, min((int)sizeof(chunk), bmpRowsRemaining(&rows)));
+        TEST_ASSERT_TRUE(n > 0);
+        for (int off = 0; off < n;) {
+            int y;
+            off += bmpRowsFeed(&rows, chunk + off, n - off, &y);
+            if (y < 0) continue;
+            TEST_ASSERT_EQUAL_INT(expectY, y);  // bottom row first
+            expectY--;
+            (*rowsDone)++;
+        }
+    }
+}
+
+static void test_bmp_rows_flip_and_drop_padding() {
+    std::vector<uint8_t> frame(IMG_BUF_LEN);
+    fillPattern(frame.data(), frame.size(), 11);
+    std::vector<uint8_t> body = bmpBody(frame.data());
+
+    const int chunks[] = {1, 7, 1436, 4096};
+    for (int chunk : chunks) {
+        WiFiClient client(body.data(), body.size(), chunk);
+        int rowsDone = 0;
+        memset(imgBuf, 0, IMG_BUF_LEN);
+        readBmp(client, imgBuf, &rowsDone);
+        TEST_ASSERT_EQUAL_INT(H, rowsDone);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(frame.data(), imgBuf, IMG_BUF_LEN);
+        TEST_ASSERT_FALSE(client.connected());
+    }
+}
+
+// ── 2bpp packing ────────────────────────────────────────────
+
+static void test_mono_2bpp_pack() {
+    uint16_t lut[256];
+    mono2bppBuildLut(lut, nullptr);
+    TEST_ASSERT_EQUAL_HEX16(0x5555, lut[0xFF]);  // all white
+    TEST_ASSERT_EQUAL_HEX16(0x0000, lut[0x00]);
+    TEST_ASSERT_EQUAL_HEX16(0x4000, lut[0x80]);  // leftmost pixel in the top bits
+
+    std::vector<uint8_t> mono(ROW_BYTES);
+    std::vector<uint8_t> packed(COLOR_ROW_BYTES);
+    fillPattern(mono.data(), mono.size(), 3);
+    mono2bppPackRow(lut, mono.data(), packed.data(), ROW_BYTES);
+    for (int x = 0; x < W; x++) {
+        int white = (mono[x / 8] >> (7 - x % 8)) & 1;
+        int code = (packed[x / 4] >> (6 - (x % 4) * 2)) & 0x03;
+        TEST_ASSERT_EQUAL_INT(white, code);
+    }
+
+    // A remap is applied to both halves of every word
+    uint8_t invert[256];
+    for (int v = 0; v < 256; v++) invert[v] = ~v;
+    uint16_t remapped[256];
+    mono2bppBuildLut(remapped, invert);
+    for (int v = 0; v < 256; v++) TEST_ASSERT_EQUAL_HEX16((uint16_t)~lut[v], remapped[v]);
+
+    std::vector<uint8_t> out(COLOR_ROW_BYTES);
+    remapRow(invert, packed.data(), out.data(), COLOR_ROW_BYTES);
+    for (int i = 0; i < COLOR_ROW_BYTES; i++) TEST_ASSERT_EQUAL_HEX8((uint8_t)~packed[i], out[i]);
+
+    SPI.reset();
+    SPI.writeBytes(packed.data(), COLOR_ROW_BYTES);
+    TEST_ASSERT_EQUAL_INT(COLOR_ROW_BYTES, (int)SPI.bytes);
+    TEST_ASSERT_EQUAL_HEX32(crc32Update(0, packed.data(), COLOR_ROW_BYTES), SPI.crc);
+}
+
+// ── 90° rotation ────────────────────────────────────────────
+
+static void test_rotate_band_matches_per_pixel() {
+    const int rows = H & ~7;  // rotation works on whole 8-row blocks
+    const int outBytes = rows / 8;
+    std::vector<uint8_t> frame(IMG_BUF_LEN);
+    fillPattern(frame.data(), frame.size(), 5);
+    std::vector<uint8_t> band(8 * 8 * outBytes);
+
+    for (int bx0 = 0; bx0 < ROW_BYTES; bx0 += 8) {
+        int bx1 = min(bx0 + 8, ROW_BYTES);
+        int bandTop = W - bx1 * 8;
+        rotateBand(frame.data(), ROW_BYTES, W, bx0, bx1, 0, rows, band.data());
+        // Landscape (x, y) lands on panel (y, W - 1 - x)
+        for (int x = bx0 * 8; x < bx1 * 8; x++) {
+            int py = W - 1 - x - bandTop;
+            for (int y = 0; y < rows; y++) {
+                TEST_ASSERT_EQUAL(pixelBlack(frame.data(), ROW_BYTES, x, y),
+                                  pixelBlack(band.data(), outBytes, y, py));
+            }
+        }
+    }
+}
+
+// ── Fonts ───────────────────────────────────────────────────
+
+static void test_draw_text_matches_glyphs() {
+    memset(imgBuf, 0xFF, IMG_BUF_LEN);
+    drawTextInto(imgBuf, W, H, "A1", 3, 2, 2);
+    const char *text = "A1";
+    for (int ci = 0; ci < 2; ci++) {
+        const uint8_t *glyph = getGlyph(text[ci]);
+        for (int col = 0; col < 6; col++) {
+            for (int row = 0; row < 7; row++) {
+                bool on = col < 5 && (glyph[col] & (1 << row));
+                int px = 3 + ci * 12 + col * 2;
+                int py = 2 + row * 2;
+                TEST_ASSERT_EQUAL(on, pixelBlack(imgBuf, ROW_BYTES, px, py));
+                TEST_ASSERT_EQUAL(on, pixelBlack(imgBuf, ROW_BYTES, px + 1, py + 1));
+            }
+        }
+    }
+
+    // Clipped at every edge without touching memory outside the buffer
+    std::vector<uint8_t> guarded(IMG_BUF_LEN + 2 * ROW_BYTES, 0xFF);
+    uint8_t *buf = guarded.data() + ROW_BYTES;
+    drawTextInto(buf, W, H, "WWWW", -10, -5, 3);
+    drawTextInto(buf, W, H, "WWWW", W - 20, H - 8, 3);
+    for (int i = 0; i < ROW_BYTES; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0xFF, guarded[i]);
+        TEST_ASSERT_EQUAL_HEX8(0xFF, guarded[ROW_BYTES + IMG_BUF_LEN + i]);
+    }
+    TEST_ASSERT_TRUE(pixelBlack(buf, ROW_BYTES, W - 20, H - 8));  // 'W' column 0, row 0
+}
+
+static void test_draw_glyph16() {
+    uint16_t glyph[16];
+    for (int i = 0; i < 16; i++) glyph[i] = (uint16_t)(0x8001u | (1u << (15 - i)));
+    memset(imgBuf, 0xFF, IMG_BUF_LEN);
+    drawGlyph16(imgBuf, W, H, 9, 4, glyph);
+    for (int row = 0; row < 16; row++) {
+        for (int col = 0; col < 16; col++) {
+            bool on = col == 0 || col == 15 || col == row;
+            TEST_ASSERT_EQUAL(on, pixelBlack(imgBuf, ROW_BYTES, 9 + col, 4 + row));
+        }
+    }
+}
+
+static void test_font_covers_printable_ascii() {
+    const uint8_t *space = getGlyph(' ');
+    for (int c = 0x21; c < 0x7F; c++) {
+        const uint8_t *g = getGlyph((char)c);
+        TEST_ASSERT_TRUE(g[0] | g[1] | g[2] | g[3] | g[4]);
+        TEST_ASSERT_TRUE(g != space);
+    }
+    TEST_ASSERT_TRUE(getGlyph('\x01') == space);
+    TEST_ASSERT_TRUE(getGlyph((char)0xE9) == space);
+}
+
+// Per-pixel references of the blitter primitives
+static void refSet(uint8_t *buf, int x, int y) {
+    if (x >= 0 && x < W && y >= 0 && y < H) buf[y * ROW_BYTES + x / 8] &= ~(0x80 >> (x % 8));
+}
+
+static void refText(uint8_t *buf, const char *msg, int x, int y, int scale) {
+    for (int ci = 0; msg[ci]; ci++) {
+        const uint8_t *glyph = getGlyph(msg[ci]);
+        for (int col = 0; col < 5; col++) {
+            for (int row = 0; row < 7; row++) {
+                if (!(glyph[col] & (1 << row))) continue;
+                for (int d = 0; d < scale * scale; d++) {
+                    refSet(buf, x + ci * 6 * scale + col * scale + d % scale, y + row * scale + d / scale);
+                }
+            }
+        }
+    }
+}
+
+static void test_blitter_matches_per_pixel() {
+    std::vector<uint8_t> ref(IMG_BUF_LEN);
+    uint32_t rnd = 12345;
+    auto next = [&rnd](int range) {
+        rnd ^= rnd << 13;
+        rnd ^= rnd >> 17;
+        rnd ^= rnd << 5;
+        return (int)(rnd % (uint32_t)range);
+    };
+    const char *texts[] = {"OFFLINE", "Jq xyz!", "{~} 12:34", "WiFi: -67dBm"};
+
+    for (int i = 0; i < 200; i++) {
+        memset(imgBuf, 0xFF, IMG_BUF_LEN);
+        memset(ref.data(), 0xFF, IMG_BUF_LEN);
+        int scale = 1 + next(14);  // 12+ takes the per-pixel block path
+        int x = next(W + 80) - 60;
+        int y = next(H + 60) - 40;
+        const char *text = texts[i % 4];
+        drawTextInto(imgBuf, W, H, text, x, y, scale);
+        refText(ref.data(), text, x, y, scale);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(ref.data(), imgBuf, IMG_BUF_LEN);
+
+        int rx = next(W + 40) - 20, ry = next(H + 40) - 20;
+        int rw = next(W / 2), rh = next(H / 2);
+        fillRectInto(imgBuf, W, H, rx, ry, rw, rh);
+        for (int py = ry; py < ry + rh; py++) {
+            for (int px = rx; px < rx + rw; px++) refSet(ref.data(), px, py);
+        }
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(ref.data(), imgBuf, IMG_BUF_LEN);
+
+        uint16_t glyph[16];
+        fillPattern((uint8_t *)glyph, sizeof(glyph), i + 1);
+        int gx = next(W + 30) - 20, gy = next(H + 30) - 20;
+        drawGlyph16(imgBuf, W, H, gx, gy, glyph);
+        for (int row = 0; row < 16; row++) {
+            for (int col = 0; col < 16; col++) {
+                if (glyph[row] & (0x8000 >> col)) refSet(ref.data(), gx + col, gy + row);
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(ref.data(), imgBuf, IMG_BUF_LEN);
+    }
+}
+
+// ── Frame patches ───────────────────────────────────────────
+
+// PackBits as core.renderer.packbits_encode: runs of 2+ repeat, else literals
+static std::vector<uint8_t> packBits(const uint8_t *data, int n) {
+    std::vector<uint8_t> out;
+    int i = 0;
+    while (i < n) {
+        int run = 1;
+        while (i + run < n && run < 128 && data[i + run] == data[i]) run++;
+        if (run >= 2) {
+            out.push_back(257 - run);
+            out.push_back(data[i]);
+            i += run;
+            continue;
+        }
+        int start = i++;
+        while (i < n && i - start < 128 && !(i + 2 < n && data[i] == data[i + 1] && data[i] == data[i + 2])) i++;
+        out.push_back(i - start - 1);
+        out.insert(out.end(), data + start, data + i);
+    }
+    return out;
+}
+
+static void test_packbits_rect_decodes_in_place() {
+    const int bx = 2, by = 3, bw = 5, bh = 40;
+    std::vector<uint8_t> rect(bw * bh);
+    fillPattern(rect.data(), rect.size(), 11);
+    memset(rect.data() + bw * 10, 0xFF, bw * 12);  // runs across row ends
+    std::vector<uint8_t> packed = packBits(rect.data(), rect.size());
+
+    std::vector<uint8_t> ref(IMG_BUF_LEN);
+    fillPattern(ref.data(), ref.size(), 12);
+    for (int y = 0; y < bh; y++) {
+        memcpy(ref.data() + (by + y) * ROW_BYTES + bx, rect.data() + y * bw, bw);
+    }
+    for (size_t step = 1; step <= packed.size(); step = step * 3 + 1) {
+        fillPattern(imgBuf, IMG_BUF_LEN, 12);
+        PackBitsDecoder dec;
+        packBitsBeginRect(&dec, imgBuf + by * ROW_BYTES + bx, ROW_BYTES, bw, bh);
+        for (size_t off = 0; off < packed.size(); off += step) {
+            TEST_ASSERT_TRUE(packBitsFeed(&dec, packed.data() + off, min(step, packed.size() - off)));
+        }
+        TEST_ASSERT_TRUE(packBitsDone(&dec));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(ref.data(), imgBuf, IMG_BUF_LEN);
+    }
+
+    // One row short: the last packet overflows the window
+    PackBitsDecoder dec;
+    packBitsBeginRect(&dec, imgBuf + by * ROW_BYTES + bx, ROW_BYTES, bw, bh - 1);
+    TEST_ASSERT_FALSE(packBitsFeed(&dec, packed.data(), packed.size()));
+}
+
+// ── JSON flags ──────────────────────────────────────────────
+
+static void test_json_flags_in_any_chunking() {
+    const char *body =
+        "{\"modes\":[\"DAILY\",{\"x\":\"}\"}],\"focus_listening\" : true,"
+        "\"note\":\"a \\\"quoted\\\" \\u00e9 value\",\"always_active\":0,"
+        "\"refresh_minutes\":60}";
+    const size_t len = strlen(body);
+    for (size_t step = 1; step <= len; step = step * 2 + 1) {
+        char focus[8], always[8], minutes[8], note[32];
+        JsonField fields[] = {
+            {"focus_listening", focus, sizeof(focus)},
+            {"always_active", always, sizeof(always)},
+            {"refresh_minutes", minutes, sizeof(minutes)},
+            {"note", note, sizeof(note)},
+        };
+        JsonScanner s;
+        jsonScanBegin(&s, fields, 4);
+        for (size_t off = 0; off < len; off += step) {
+            TEST_ASSERT_TRUE(jsonScanFeed(&s, body + off, min(step, len - off)));
+        }
+        TEST_ASSERT_TRUE(jsonScanDone(&s));
+        TEST_ASSERT_TRUE(jsonFieldTrue(fields[0]));
+        TEST_ASSERT_FALSE(jsonFieldTrue(fields[1]));
+        TEST_ASSERT_TRUE(jsonFieldPresent(fields[1]));
+        TEST_ASSERT_EQUAL_STRING("60", minutes);
+        TEST_ASSERT_EQUAL_STRING("a \"quoted\" ? value", note);  // \uXXXX -> ?
+    }
+}
+
+// ── Dirty rectangles ────────────────────────────────────────
+
+static void test_dirty_rects_add_merges_down_to_max() {
+    DirtyRect rects[DIRTY_MAX_RECTS + 1];
+    int n = 0;
+    // Overlapping pair folds into its bounding box
+    n = dirtyRectsAdd(rects, n, DIRTY_MAX_RECTS, DirtyRect{0, 0, 16, 10});
+    n = dirtyRectsAdd(rects, n, DIRTY_MAX_RECTS, DirtyRect{8, 5, 24, 20});
+    TEST_ASSERT_EQUAL_INT(1, n);
+    TEST_ASSERT_EQUAL_INT(24, rects[0].x1);
+    TEST_ASSERT_EQUAL_INT(20, rects[0].y1);
+    TEST_ASSERT_EQUAL_INT(24 * 20, dirtyRectsArea(rects, n));
+
+    // Far apart: kept separate up to the limit, then the closest pair merges
+    for (int i = 1; i <= DIRTY_MAX_RECTS; i++) {
+        n = dirtyRectsAdd(rects, n, DIRTY_MAX_RECTS, DirtyRect{i * 64, 100, i * 64 + 8, 108});
+    }
+    TEST_ASSERT_EQUAL_INT(DIRTY_MAX_RECTS, n);
+    long area = dirtyRectsArea(rects, n);
+    TEST_ASSERT_TRUE(area < 24L * 20 + DIRTY_MAX_RECTS * 8 * 8 + 64 * 8);
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            bool overlap = rects[i].x0 < rects[j].x1 && rects[j].x0 < rects[i].x1
+                        && rects[i].y0 < rects[j].y1 && rects[j].y0 < rects[i].y1;
+            TEST_ASSERT_FALSE(overlap);
+        }
+    }
+}
+
+// ── Offline frame store ─────────────────────────────────────
+
+static void test_frame_store_rejects_corrupt_slot() {
+    LittleFS.format();
+    TEST_ASSERT_TRUE(cacheInit());
+    TEST_ASSERT_TRUE(cacheSlots() >= 1);
+
+    std::vector<uint8_t> frame(IMG_BUF_LEN);
+    fillPattern(frame.data(), frame.size(), 9);
+    FrameHash h;
+    frameHashCompute(&h, frame.data(), ROW_BYTES, H);
+    TEST_ASSERT_TRUE(cacheSave(frame.data(), IMG_BUF_LEN, "DAILY", h.frame));
+
+    memset(imgBuf, 0, IMG_BUF_LEN);
+    TEST_ASSERT_TRUE(cacheLoadHash(imgBuf, IMG_BUF_LEN, h.frame));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame.data(), imgBuf, IMG_BUF_LEN);
+
+    FakeFileData *slot = LittleFS.data("/frame0.bin");
+    TEST_ASSERT_NOT_NULL(slot);
+    (*slot)[slot->size() - 1] ^= 0x10;
+    TEST_ASSERT_FALSE(cacheLoadHash(imgBuf, IMG_BUF_LEN, h.frame));
+    TEST_ASSERT_EQUAL_INT(0, cacheCount());  // dropped from the index
+}
+
+static void collectRow(const uint8_t *row, void *ctx) {
+    auto *out = static_cast<std::vector<uint8_t> *>(ctx);
+    out->insert(out->end(), row, row + ROW_BYTES);
+}
+
+static void test_panel_snapshot_streams_rows() {
+    LittleFS.format();
+    TEST_ASSERT_TRUE(cacheInit());
+
+    std::vector<uint8_t> frame(IMG_BUF_LEN);
+    fillPattern(frame.data(), frame.size(), 4);
+    FrameHash h;
+    frameHashCompute(&h, frame.data(), ROW_BYTES, H);
+    TEST_ASSERT_TRUE(cacheSave(frame.data(), IMG_BUF_LEN, "DAILY", h.frame));
+    TEST_ASSERT_TRUE(cacheSavePanel(frame.data(), IMG_BUF_LEN, h.frame));
+    TEST_ASSERT_NULL(LittleFS.data("/panel.bin"));  // already in a slot
+
+    std::vector<uint8_t> shown(frame);
+    shown[ROW_BYTES * 3] ^= 0xFF;  // an overlay the slot does not have
+    FrameHash hs;
+    frameHashCompute(&hs, shown.data(), ROW_BYTES, H);
+    TEST_ASSERT_TRUE(cacheSavePanel(shown.data(), IMG_BUF_LEN, hs.frame));
+
+    std::vector<uint8_t> rows;
+    TEST_ASSERT_TRUE(cacheReadRows(hs.frame, collectRow, &rows));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(shown.data(), rows.data(), IMG_BUF_LEN);
+    rows.clear();
+    TEST_ASSERT_TRUE(cacheReadRows(h.frame, collectRow, &rows));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame.data(), rows.data(), IMG_BUF_LEN);
+
+    FakeFileData *snap = LittleFS.data("/panel.bin");
+    (*snap)[snap->size() - 1] ^= 0x01;
+    rows.clear();
+    TEST_ASSERT_FALSE(cacheReadRows(hs.frame, collectRow, &rows));
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_matches_zlib);
+    RUN_TEST(test_frame_hash_independent_of_row_order);
+    RUN_TEST(test_bmp_rows_flip_and_drop_padding);
+    RUN_TEST(test_mono_2bpp_pack);
+    RUN_TEST(test_rotate_band_matches_per_pixel);
+    RUN_TEST(test_draw_text_matches_glyphs);
+    RUN_TEST(test_draw_glyph16);
+    RUN_TEST(test_font_covers_printable_ascii);
+    RUN_TEST(test_blitter_matches_per_pixel);
+    RUN_TEST(test_packbits_rect_decodes_in_place);
+    RUN_TEST(test_json_flags_in_any_chunking);
+    RUN_TEST(test_dirty_rects_add_merges_down_to_max);
+    RUN_TEST(test_frame_store_rejects_corrupt_slot);
+    RUN_TEST(test_panel_snapshot_streams_rows);
+    return UNITY_END();
+}